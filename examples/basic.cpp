@@ -110,7 +110,7 @@ int main() {
     echoFilter.setUsage("Usage: echo [string]\n");
     echoFilter.setMaxArrayArgs(10000);
     shell.addCommand("echo", echoFilter, [&stream](etm::Shell&,etm::ETerminal&,etm::Args &args)->void{
-        for (std::string &s : args.getArrayArgs()) {
+        for (std::string_view s : args.getArrayArgs()) {
             stream << s << " ";
         }
         stream << "\n";
@@ -194,9 +194,18 @@ void keyPress(GLFWwindow *window, int key, int scancode, int action, int mods) {
             case GLFW_KEY_RIGHT:
                 terminal.inputActionKey(etm::actionKey::RIGHT);
                 break;
+            case GLFW_KEY_TAB:
+                terminal.inputActionKey(etm::actionKey::TAB);
+                break;
             case GLFW_KEY_C:
                 if ((mods & GLFW_MOD_CONTROL) == GLFW_MOD_CONTROL) {
-                    glfwSetClipboardString(window, terminal.getTextSelection().c_str());
+                    // Copy if there's a selection, otherwise interrupt
+                    const std::string selection = terminal.getTextSelection();
+                    if (selection.empty()) {
+                        terminal.inputActionKey(etm::actionKey::INTERRUPT);
+                    } else {
+                        glfwSetClipboardString(window, selection.c_str());
+                    }
                 }
                 break;
             case GLFW_KEY_V:
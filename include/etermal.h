@@ -5,7 +5,10 @@
 #include "basicshell.h"
 #include "shell.h"
 #include "terminal.h"
+#include "headless.h"
 #include "font.h"
 #include "bmpfont.h"
+#include "packfont.h"
+#include "fontchain.h"
 
 #endif
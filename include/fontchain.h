@@ -0,0 +1,6 @@
+#ifndef INCLUDED_ETERMAL_HEADER_FONTCHAIN_H
+#define INCLUDED_ETERMAL_HEADER_FONTCHAIN_H
+
+#include "include/terminal/render/FontChain.h"
+
+#endif
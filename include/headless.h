@@ -0,0 +1,6 @@
+#ifndef INCLUDED_ETERMAL_HEADER_HEADLESS_H
+#define INCLUDED_ETERMAL_HEADER_HEADLESS_H
+
+#include "include/terminal/HeadlessTerminal.h"
+
+#endif
@@ -0,0 +1,7 @@
+#ifndef INCLUDED_ETERMAL_HEADER_PACKFONT_H
+#define INCLUDED_ETERMAL_HEADER_PACKFONT_H
+
+#include "include/terminal/render/PackFont.h"
+#include "include/terminal/render/GlyphPack.h"
+
+#endif
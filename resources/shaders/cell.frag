@@ -0,0 +1,23 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec2 texturePos;
+
+flat in vec3 backgroundColor;
+flat in vec3 foregroundColor;
+
+uniform sampler2D Tex;
+// Whether Tex is a signed distance field rather than coverage
+uniform bool distanceField;
+
+void main()
+{
+	float alpha = texture(Tex, texturePos).r;
+	if (distanceField) {
+		// The outline is at 0.5; blend across a single
+		// pixel around it, however much the glyph is scaled
+		float width = 0.5 * length(vec2(dFdx(alpha), dFdy(alpha)));
+		alpha = clamp((alpha - 0.5) / max(2.0 * width, 1e-5) + 0.5, 0.0, 1.0);
+	}
+	FragColor = vec4(backgroundColor * vec3(1 - alpha) + foregroundColor * vec3(alpha), alpha);
+}
@@ -0,0 +1,175 @@
+#ifndef ETERMAL_CELL_SHADER_DATA_H_INCLUDED
+#define ETERMAL_CELL_SHADER_DATA_H_INCLUDED
+static const char cell_vert[] = {
+    0x23, 0x76, 0x65, 0x72, 0x73, 0x69, 0x6f, 0x6e, 0x20, 0x33, 0x33, 0x30,
+    0x20, 0x63, 0x6f, 0x72, 0x65, 0x0a, 0x6c, 0x61, 0x79, 0x6f, 0x75, 0x74,
+    0x20, 0x28, 0x6c, 0x6f, 0x63, 0x61, 0x74, 0x69, 0x6f, 0x6e, 0x20, 0x3d,
+    0x20, 0x30, 0x29, 0x20, 0x69, 0x6e, 0x20, 0x76, 0x65, 0x63, 0x32, 0x20,
+    0x61, 0x50, 0x6f, 0x73, 0x3b, 0x0a, 0x6c, 0x61, 0x79, 0x6f, 0x75, 0x74,
+    0x20, 0x28, 0x6c, 0x6f, 0x63, 0x61, 0x74, 0x69, 0x6f, 0x6e, 0x20, 0x3d,
+    0x20, 0x31, 0x29, 0x20, 0x69, 0x6e, 0x20, 0x76, 0x65, 0x63, 0x32, 0x20,
+    0x74, 0x65, 0x78, 0x50, 0x6f, 0x73, 0x3b, 0x0a, 0x2f, 0x2f, 0x20, 0x50,
+    0x65, 0x72, 0x2d, 0x69, 0x6e, 0x73, 0x74, 0x61, 0x6e, 0x63, 0x65, 0x20,
+    0x76, 0x61, 0x6c, 0x75, 0x65, 0x73, 0x2c, 0x20, 0x6f, 0x6e, 0x65, 0x20,
+    0x73, 0x65, 0x74, 0x20, 0x66, 0x6f, 0x72, 0x20, 0x65, 0x61, 0x63, 0x68,
+    0x20, 0x63, 0x65, 0x6c, 0x6c, 0x0a, 0x2f, 0x2f, 0x20, 0x43, 0x6f, 0x6c,
+    0x75, 0x6d, 0x6e, 0x2c, 0x20, 0x72, 0x6f, 0x77, 0x20, 0x61, 0x6e, 0x64,
+    0x20, 0x73, 0x70, 0x61, 0x6e, 0x20, 0x6f, 0x66, 0x20, 0x74, 0x68, 0x65,
+    0x20, 0x63, 0x65, 0x6c, 0x6c, 0x20, 0x2d, 0x20, 0x77, 0x69, 0x64, 0x65,
+    0x20, 0x63, 0x68, 0x61, 0x72, 0x73, 0x20, 0x73, 0x70, 0x61, 0x6e, 0x20,
+    0x74, 0x77, 0x6f, 0x20, 0x63, 0x6f, 0x6c, 0x75, 0x6d, 0x6e, 0x73, 0x0a,
+    0x6c, 0x61, 0x79, 0x6f, 0x75, 0x74, 0x20, 0x28, 0x6c, 0x6f, 0x63, 0x61,
+    0x74, 0x69, 0x6f, 0x6e, 0x20, 0x3d, 0x20, 0x32, 0x29, 0x20, 0x69, 0x6e,
+    0x20, 0x69, 0x76, 0x65, 0x63, 0x33, 0x20, 0x63, 0x65, 0x6c, 0x6c, 0x3b,
+    0x0a, 0x2f, 0x2f, 0x20, 0x42, 0x61, 0x63, 0x6b, 0x67, 0x72, 0x6f, 0x75,
+    0x6e, 0x64, 0x20, 0x61, 0x6e, 0x64, 0x20, 0x66, 0x6f, 0x72, 0x65, 0x67,
+    0x72, 0x6f, 0x75, 0x6e, 0x64, 0x20, 0x63, 0x6f, 0x6c, 0x6f, 0x72, 0x73,
+    0x20, 0x6f, 0x66, 0x20, 0x74, 0x68, 0x65, 0x20, 0x63, 0x65, 0x6c, 0x6c,
+    0x0a, 0x6c, 0x61, 0x79, 0x6f, 0x75, 0x74, 0x20, 0x28, 0x6c, 0x6f, 0x63,
+    0x61, 0x74, 0x69, 0x6f, 0x6e, 0x20, 0x3d, 0x20, 0x33, 0x29, 0x20, 0x69,
+    0x6e, 0x20, 0x76, 0x65, 0x63, 0x33, 0x20, 0x62, 0x61, 0x63, 0x6b, 0x3b,
+    0x0a, 0x6c, 0x61, 0x79, 0x6f, 0x75, 0x74, 0x20, 0x28, 0x6c, 0x6f, 0x63,
+    0x61, 0x74, 0x69, 0x6f, 0x6e, 0x20, 0x3d, 0x20, 0x34, 0x29, 0x20, 0x69,
+    0x6e, 0x20, 0x76, 0x65, 0x63, 0x33, 0x20, 0x66, 0x6f, 0x72, 0x65, 0x3b,
+    0x0a, 0x2f, 0x2f, 0x20, 0x4c, 0x65, 0x66, 0x74, 0x2c, 0x20, 0x62, 0x6f,
+    0x74, 0x74, 0x6f, 0x6d, 0x2c, 0x20, 0x72, 0x69, 0x67, 0x68, 0x74, 0x20,
+    0x61, 0x6e, 0x64, 0x20, 0x74, 0x6f, 0x70, 0x20, 0x6f, 0x66, 0x20, 0x74,
+    0x68, 0x65, 0x20, 0x67, 0x6c, 0x79, 0x70, 0x68, 0x20, 0x69, 0x6e, 0x20,
+    0x74, 0x68, 0x65, 0x20, 0x62, 0x6f, 0x75, 0x6e, 0x64, 0x20, 0x74, 0x65,
+    0x78, 0x74, 0x75, 0x72, 0x65, 0x2c, 0x0a, 0x2f, 0x2f, 0x20, 0x66, 0x6f,
+    0x72, 0x20, 0x66, 0x6f, 0x6e, 0x74, 0x73, 0x20, 0x74, 0x68, 0x61, 0x74,
+    0x20, 0x6b, 0x65, 0x65, 0x70, 0x20, 0x65, 0x76, 0x65, 0x72, 0x79, 0x20,
+    0x67, 0x6c, 0x79, 0x70, 0x68, 0x20, 0x69, 0x6e, 0x20, 0x6f, 0x6e, 0x65,
+    0x20, 0x61, 0x74, 0x6c, 0x61, 0x73, 0x0a, 0x6c, 0x61, 0x79, 0x6f, 0x75,
+    0x74, 0x20, 0x28, 0x6c, 0x6f, 0x63, 0x61, 0x74, 0x69, 0x6f, 0x6e, 0x20,
+    0x3d, 0x20, 0x35, 0x29, 0x20, 0x69, 0x6e, 0x20, 0x76, 0x65, 0x63, 0x34,
+    0x20, 0x67, 0x6c, 0x79, 0x70, 0x68, 0x3b, 0x0a, 0x0a, 0x2f, 0x2f, 0x20,
+    0x56, 0x61, 0x6c, 0x75, 0x65, 0x73, 0x20, 0x74, 0x68, 0x61, 0x74, 0x20,
+    0x6f, 0x6e, 0x6c, 0x79, 0x20, 0x63, 0x68, 0x61, 0x6e, 0x67, 0x65, 0x20,
+    0x6f, 0x6e, 0x63, 0x65, 0x20, 0x70, 0x65, 0x72, 0x20, 0x66, 0x72, 0x61,
+    0x6d, 0x65, 0x20, 0x28, 0x6f, 0x72, 0x20, 0x6c, 0x65, 0x73, 0x73, 0x29,
+    0x0a, 0x6c, 0x61, 0x79, 0x6f, 0x75, 0x74, 0x20, 0x28, 0x73, 0x74, 0x64,
+    0x31, 0x34, 0x30, 0x29, 0x20, 0x75, 0x6e, 0x69, 0x66, 0x6f, 0x72, 0x6d,
+    0x20, 0x46, 0x72, 0x61, 0x6d, 0x65, 0x20, 0x7b, 0x0a, 0x20, 0x20, 0x20,
+    0x20, 0x2f, 0x2f, 0x20, 0x50, 0x69, 0x78, 0x65, 0x6c, 0x20, 0x73, 0x69,
+    0x7a, 0x65, 0x20, 0x6f, 0x66, 0x20, 0x65, 0x61, 0x63, 0x68, 0x20, 0x63,
+    0x65, 0x6c, 0x6c, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x76, 0x65, 0x63, 0x32,
+    0x20, 0x63, 0x65, 0x6c, 0x6c, 0x53, 0x69, 0x7a, 0x65, 0x3b, 0x0a, 0x20,
+    0x20, 0x20, 0x20, 0x2f, 0x2f, 0x20, 0x50, 0x69, 0x78, 0x65, 0x6c, 0x20,
+    0x73, 0x69, 0x7a, 0x65, 0x20, 0x6f, 0x66, 0x20, 0x74, 0x68, 0x65, 0x20,
+    0x76, 0x69, 0x65, 0x77, 0x70, 0x6f, 0x72, 0x74, 0x0a, 0x20, 0x20, 0x20,
+    0x20, 0x76, 0x65, 0x63, 0x32, 0x20, 0x76, 0x69, 0x65, 0x77, 0x70, 0x6f,
+    0x72, 0x74, 0x3b, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x2f, 0x2f, 0x20, 0x50,
+    0x69, 0x78, 0x65, 0x6c, 0x20, 0x70, 0x6f, 0x73, 0x69, 0x74, 0x69, 0x6f,
+    0x6e, 0x20, 0x6f, 0x66, 0x20, 0x74, 0x68, 0x65, 0x20, 0x74, 0x6f, 0x70,
+    0x20, 0x6c, 0x65, 0x66, 0x74, 0x20, 0x63, 0x6f, 0x72, 0x6e, 0x65, 0x72,
+    0x20, 0x6f, 0x66, 0x20, 0x63, 0x65, 0x6c, 0x6c, 0x20, 0x30, 0x2c, 0x30,
+    0x2c, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x2f, 0x2f, 0x20, 0x61, 0x6b, 0x61,
+    0x20, 0x74, 0x68, 0x65, 0x20, 0x73, 0x63, 0x72, 0x6f, 0x6c, 0x6c, 0x20,
+    0x6f, 0x66, 0x66, 0x73, 0x65, 0x74, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x76,
+    0x65, 0x63, 0x32, 0x20, 0x6f, 0x72, 0x69, 0x67, 0x69, 0x6e, 0x3b, 0x0a,
+    0x7d, 0x3b, 0x0a, 0x0a, 0x6f, 0x75, 0x74, 0x20, 0x76, 0x65, 0x63, 0x32,
+    0x20, 0x74, 0x65, 0x78, 0x74, 0x75, 0x72, 0x65, 0x50, 0x6f, 0x73, 0x3b,
+    0x0a, 0x66, 0x6c, 0x61, 0x74, 0x20, 0x6f, 0x75, 0x74, 0x20, 0x76, 0x65,
+    0x63, 0x33, 0x20, 0x62, 0x61, 0x63, 0x6b, 0x67, 0x72, 0x6f, 0x75, 0x6e,
+    0x64, 0x43, 0x6f, 0x6c, 0x6f, 0x72, 0x3b, 0x0a, 0x66, 0x6c, 0x61, 0x74,
+    0x20, 0x6f, 0x75, 0x74, 0x20, 0x76, 0x65, 0x63, 0x33, 0x20, 0x66, 0x6f,
+    0x72, 0x65, 0x67, 0x72, 0x6f, 0x75, 0x6e, 0x64, 0x43, 0x6f, 0x6c, 0x6f,
+    0x72, 0x3b, 0x0a, 0x0a, 0x76, 0x6f, 0x69, 0x64, 0x20, 0x6d, 0x61, 0x69,
+    0x6e, 0x28, 0x29, 0x0a, 0x7b, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x74, 0x65,
+    0x78, 0x74, 0x75, 0x72, 0x65, 0x50, 0x6f, 0x73, 0x20, 0x3d, 0x20, 0x6d,
+    0x69, 0x78, 0x28, 0x67, 0x6c, 0x79, 0x70, 0x68, 0x2e, 0x78, 0x79, 0x2c,
+    0x20, 0x67, 0x6c, 0x79, 0x70, 0x68, 0x2e, 0x7a, 0x77, 0x2c, 0x20, 0x74,
+    0x65, 0x78, 0x50, 0x6f, 0x73, 0x29, 0x3b, 0x0a, 0x20, 0x20, 0x20, 0x20,
+    0x62, 0x61, 0x63, 0x6b, 0x67, 0x72, 0x6f, 0x75, 0x6e, 0x64, 0x43, 0x6f,
+    0x6c, 0x6f, 0x72, 0x20, 0x3d, 0x20, 0x62, 0x61, 0x63, 0x6b, 0x3b, 0x0a,
+    0x20, 0x20, 0x20, 0x20, 0x66, 0x6f, 0x72, 0x65, 0x67, 0x72, 0x6f, 0x75,
+    0x6e, 0x64, 0x43, 0x6f, 0x6c, 0x6f, 0x72, 0x20, 0x3d, 0x20, 0x66, 0x6f,
+    0x72, 0x65, 0x3b, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x2f, 0x2f, 0x20, 0x61,
+    0x50, 0x6f, 0x73, 0x20, 0x69, 0x73, 0x20, 0x61, 0x20, 0x71, 0x75, 0x61,
+    0x64, 0x20, 0x66, 0x72, 0x6f, 0x6d, 0x20, 0x2d, 0x31, 0x2c, 0x2d, 0x31,
+    0x20, 0x74, 0x6f, 0x20, 0x31, 0x2c, 0x31, 0x2c, 0x20, 0x77, 0x69, 0x74,
+    0x68, 0x20, 0x2b, 0x79, 0x20, 0x67, 0x6f, 0x69, 0x6e, 0x67, 0x20, 0x75,
+    0x70, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x76, 0x65, 0x63, 0x32, 0x20, 0x63,
+    0x6f, 0x72, 0x6e, 0x65, 0x72, 0x20, 0x3d, 0x20, 0x76, 0x65, 0x63, 0x32,
+    0x28, 0x61, 0x50, 0x6f, 0x73, 0x2e, 0x78, 0x20, 0x2b, 0x20, 0x31, 0x2e,
+    0x30, 0x2c, 0x20, 0x31, 0x2e, 0x30, 0x20, 0x2d, 0x20, 0x61, 0x50, 0x6f,
+    0x73, 0x2e, 0x79, 0x29, 0x20, 0x2a, 0x20, 0x30, 0x2e, 0x35, 0x3b, 0x0a,
+    0x20, 0x20, 0x20, 0x20, 0x63, 0x6f, 0x72, 0x6e, 0x65, 0x72, 0x2e, 0x78,
+    0x20, 0x2a, 0x3d, 0x20, 0x66, 0x6c, 0x6f, 0x61, 0x74, 0x28, 0x63, 0x65,
+    0x6c, 0x6c, 0x2e, 0x7a, 0x29, 0x3b, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x76,
+    0x65, 0x63, 0x32, 0x20, 0x70, 0x69, 0x78, 0x65, 0x6c, 0x20, 0x3d, 0x20,
+    0x6f, 0x72, 0x69, 0x67, 0x69, 0x6e, 0x20, 0x2b, 0x20, 0x28, 0x76, 0x65,
+    0x63, 0x32, 0x28, 0x63, 0x65, 0x6c, 0x6c, 0x2e, 0x78, 0x79, 0x29, 0x20,
+    0x2b, 0x20, 0x63, 0x6f, 0x72, 0x6e, 0x65, 0x72, 0x29, 0x20, 0x2a, 0x20,
+    0x63, 0x65, 0x6c, 0x6c, 0x53, 0x69, 0x7a, 0x65, 0x3b, 0x0a, 0x20, 0x20,
+    0x20, 0x20, 0x67, 0x6c, 0x5f, 0x50, 0x6f, 0x73, 0x69, 0x74, 0x69, 0x6f,
+    0x6e, 0x20, 0x3d, 0x20, 0x76, 0x65, 0x63, 0x34, 0x28, 0x70, 0x69, 0x78,
+    0x65, 0x6c, 0x2e, 0x78, 0x20, 0x2f, 0x20, 0x76, 0x69, 0x65, 0x77, 0x70,
+    0x6f, 0x72, 0x74, 0x2e, 0x78, 0x20, 0x2a, 0x20, 0x32, 0x2e, 0x30, 0x20,
+    0x2d, 0x20, 0x31, 0x2e, 0x30, 0x2c, 0x20, 0x31, 0x2e, 0x30, 0x20, 0x2d,
+    0x20, 0x70, 0x69, 0x78, 0x65, 0x6c, 0x2e, 0x79, 0x20, 0x2f, 0x20, 0x76,
+    0x69, 0x65, 0x77, 0x70, 0x6f, 0x72, 0x74, 0x2e, 0x79, 0x20, 0x2a, 0x20,
+    0x32, 0x2e, 0x30, 0x2c, 0x20, 0x30, 0x2e, 0x30, 0x2c, 0x20, 0x31, 0x2e,
+    0x30, 0x29, 0x3b, 0x0a, 0x7d, 0x0a
+};
+static const int cell_vert_len = 1326;
+static const char cell_frag[] = {
+    0x23, 0x76, 0x65, 0x72, 0x73, 0x69, 0x6f, 0x6e, 0x20, 0x33, 0x33, 0x30,
+    0x20, 0x63, 0x6f, 0x72, 0x65, 0x0a, 0x6f, 0x75, 0x74, 0x20, 0x76, 0x65,
+    0x63, 0x34, 0x20, 0x46, 0x72, 0x61, 0x67, 0x43, 0x6f, 0x6c, 0x6f, 0x72,
+    0x3b, 0x0a, 0x0a, 0x69, 0x6e, 0x20, 0x76, 0x65, 0x63, 0x32, 0x20, 0x74,
+    0x65, 0x78, 0x74, 0x75, 0x72, 0x65, 0x50, 0x6f, 0x73, 0x3b, 0x0a, 0x0a,
+    0x66, 0x6c, 0x61, 0x74, 0x20, 0x69, 0x6e, 0x20, 0x76, 0x65, 0x63, 0x33,
+    0x20, 0x62, 0x61, 0x63, 0x6b, 0x67, 0x72, 0x6f, 0x75, 0x6e, 0x64, 0x43,
+    0x6f, 0x6c, 0x6f, 0x72, 0x3b, 0x0a, 0x66, 0x6c, 0x61, 0x74, 0x20, 0x69,
+    0x6e, 0x20, 0x76, 0x65, 0x63, 0x33, 0x20, 0x66, 0x6f, 0x72, 0x65, 0x67,
+    0x72, 0x6f, 0x75, 0x6e, 0x64, 0x43, 0x6f, 0x6c, 0x6f, 0x72, 0x3b, 0x0a,
+    0x0a, 0x75, 0x6e, 0x69, 0x66, 0x6f, 0x72, 0x6d, 0x20, 0x73, 0x61, 0x6d,
+    0x70, 0x6c, 0x65, 0x72, 0x32, 0x44, 0x20, 0x54, 0x65, 0x78, 0x3b, 0x0a,
+    0x2f, 0x2f, 0x20, 0x57, 0x68, 0x65, 0x74, 0x68, 0x65, 0x72, 0x20, 0x54,
+    0x65, 0x78, 0x20, 0x69, 0x73, 0x20, 0x61, 0x20, 0x73, 0x69, 0x67, 0x6e,
+    0x65, 0x64, 0x20, 0x64, 0x69, 0x73, 0x74, 0x61, 0x6e, 0x63, 0x65, 0x20,
+    0x66, 0x69, 0x65, 0x6c, 0x64, 0x20, 0x72, 0x61, 0x74, 0x68, 0x65, 0x72,
+    0x20, 0x74, 0x68, 0x61, 0x6e, 0x20, 0x63, 0x6f, 0x76, 0x65, 0x72, 0x61,
+    0x67, 0x65, 0x0a, 0x75, 0x6e, 0x69, 0x66, 0x6f, 0x72, 0x6d, 0x20, 0x62,
+    0x6f, 0x6f, 0x6c, 0x20, 0x64, 0x69, 0x73, 0x74, 0x61, 0x6e, 0x63, 0x65,
+    0x46, 0x69, 0x65, 0x6c, 0x64, 0x3b, 0x0a, 0x0a, 0x76, 0x6f, 0x69, 0x64,
+    0x20, 0x6d, 0x61, 0x69, 0x6e, 0x28, 0x29, 0x0a, 0x7b, 0x0a, 0x09, 0x66,
+    0x6c, 0x6f, 0x61, 0x74, 0x20, 0x61, 0x6c, 0x70, 0x68, 0x61, 0x20, 0x3d,
+    0x20, 0x74, 0x65, 0x78, 0x74, 0x75, 0x72, 0x65, 0x28, 0x54, 0x65, 0x78,
+    0x2c, 0x20, 0x74, 0x65, 0x78, 0x74, 0x75, 0x72, 0x65, 0x50, 0x6f, 0x73,
+    0x29, 0x2e, 0x72, 0x3b, 0x0a, 0x09, 0x69, 0x66, 0x20, 0x28, 0x64, 0x69,
+    0x73, 0x74, 0x61, 0x6e, 0x63, 0x65, 0x46, 0x69, 0x65, 0x6c, 0x64, 0x29,
+    0x20, 0x7b, 0x0a, 0x09, 0x09, 0x2f, 0x2f, 0x20, 0x54, 0x68, 0x65, 0x20,
+    0x6f, 0x75, 0x74, 0x6c, 0x69, 0x6e, 0x65, 0x20, 0x69, 0x73, 0x20, 0x61,
+    0x74, 0x20, 0x30, 0x2e, 0x35, 0x3b, 0x20, 0x62, 0x6c, 0x65, 0x6e, 0x64,
+    0x20, 0x61, 0x63, 0x72, 0x6f, 0x73, 0x73, 0x20, 0x61, 0x20, 0x73, 0x69,
+    0x6e, 0x67, 0x6c, 0x65, 0x0a, 0x09, 0x09, 0x2f, 0x2f, 0x20, 0x70, 0x69,
+    0x78, 0x65, 0x6c, 0x20, 0x61, 0x72, 0x6f, 0x75, 0x6e, 0x64, 0x20, 0x69,
+    0x74, 0x2c, 0x20, 0x68, 0x6f, 0x77, 0x65, 0x76, 0x65, 0x72, 0x20, 0x6d,
+    0x75, 0x63, 0x68, 0x20, 0x74, 0x68, 0x65, 0x20, 0x67, 0x6c, 0x79, 0x70,
+    0x68, 0x20, 0x69, 0x73, 0x20, 0x73, 0x63, 0x61, 0x6c, 0x65, 0x64, 0x0a,
+    0x09, 0x09, 0x66, 0x6c, 0x6f, 0x61, 0x74, 0x20, 0x77, 0x69, 0x64, 0x74,
+    0x68, 0x20, 0x3d, 0x20, 0x30, 0x2e, 0x35, 0x20, 0x2a, 0x20, 0x6c, 0x65,
+    0x6e, 0x67, 0x74, 0x68, 0x28, 0x76, 0x65, 0x63, 0x32, 0x28, 0x64, 0x46,
+    0x64, 0x78, 0x28, 0x61, 0x6c, 0x70, 0x68, 0x61, 0x29, 0x2c, 0x20, 0x64,
+    0x46, 0x64, 0x79, 0x28, 0x61, 0x6c, 0x70, 0x68, 0x61, 0x29, 0x29, 0x29,
+    0x3b, 0x0a, 0x09, 0x09, 0x61, 0x6c, 0x70, 0x68, 0x61, 0x20, 0x3d, 0x20,
+    0x63, 0x6c, 0x61, 0x6d, 0x70, 0x28, 0x28, 0x61, 0x6c, 0x70, 0x68, 0x61,
+    0x20, 0x2d, 0x20, 0x30, 0x2e, 0x35, 0x29, 0x20, 0x2f, 0x20, 0x6d, 0x61,
+    0x78, 0x28, 0x32, 0x2e, 0x30, 0x20, 0x2a, 0x20, 0x77, 0x69, 0x64, 0x74,
+    0x68, 0x2c, 0x20, 0x31, 0x65, 0x2d, 0x35, 0x29, 0x20, 0x2b, 0x20, 0x30,
+    0x2e, 0x35, 0x2c, 0x20, 0x30, 0x2e, 0x30, 0x2c, 0x20, 0x31, 0x2e, 0x30,
+    0x29, 0x3b, 0x0a, 0x09, 0x7d, 0x0a, 0x09, 0x46, 0x72, 0x61, 0x67, 0x43,
+    0x6f, 0x6c, 0x6f, 0x72, 0x20, 0x3d, 0x20, 0x76, 0x65, 0x63, 0x34, 0x28,
+    0x62, 0x61, 0x63, 0x6b, 0x67, 0x72, 0x6f, 0x75, 0x6e, 0x64, 0x43, 0x6f,
+    0x6c, 0x6f, 0x72, 0x20, 0x2a, 0x20, 0x76, 0x65, 0x63, 0x33, 0x28, 0x31,
+    0x20, 0x2d, 0x20, 0x61, 0x6c, 0x70, 0x68, 0x61, 0x29, 0x20, 0x2b, 0x20,
+    0x66, 0x6f, 0x72, 0x65, 0x67, 0x72, 0x6f, 0x75, 0x6e, 0x64, 0x43, 0x6f,
+    0x6c, 0x6f, 0x72, 0x20, 0x2a, 0x20, 0x76, 0x65, 0x63, 0x33, 0x28, 0x61,
+    0x6c, 0x70, 0x68, 0x61, 0x29, 0x2c, 0x20, 0x61, 0x6c, 0x70, 0x68, 0x61,
+    0x29, 0x3b, 0x0a, 0x7d, 0x0a
+};
+static const int cell_frag_len = 653;
+#endif
@@ -0,0 +1,39 @@
+#version 330 core
+layout (location = 0) in vec2 aPos;
+layout (location = 1) in vec2 texPos;
+// Per-instance values, one set for each cell
+// Column, row and span of the cell - wide chars span two columns
+layout (location = 2) in ivec3 cell;
+// Background and foreground colors of the cell
+layout (location = 3) in vec3 back;
+layout (location = 4) in vec3 fore;
+// Left, bottom, right and top of the glyph in the bound texture,
+// for fonts that keep every glyph in one atlas
+layout (location = 5) in vec4 glyph;
+
+// Values that only change once per frame (or less)
+layout (std140) uniform Frame {
+    // Pixel size of each cell
+    vec2 cellSize;
+    // Pixel size of the viewport
+    vec2 viewport;
+    // Pixel position of the top left corner of cell 0,0,
+    // aka the scroll offset
+    vec2 origin;
+};
+
+out vec2 texturePos;
+flat out vec3 backgroundColor;
+flat out vec3 foregroundColor;
+
+void main()
+{
+    texturePos = mix(glyph.xy, glyph.zw, texPos);
+    backgroundColor = back;
+    foregroundColor = fore;
+    // aPos is a quad from -1,-1 to 1,1, with +y going up
+    vec2 corner = vec2(aPos.x + 1.0, 1.0 - aPos.y) * 0.5;
+    corner.x *= float(cell.z);
+    vec2 pixel = origin + (vec2(cell.xy) + corner) * cellSize;
+    gl_Position = vec4(pixel.x / viewport.x * 2.0 - 1.0, 1.0 - pixel.y / viewport.y * 2.0, 0.0, 1.0);
+}
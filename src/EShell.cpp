@@ -2,3 +2,12 @@
 
 etm::EShell::~EShell() {
 }
+
+void etm::EShell::update() {
+}
+void etm::EShell::interrupt() {
+}
+void etm::EShell::complete() {
+}
+void etm::EShell::lint(const InputBuffer &input, std::vector<bool> &flagged) {
+}
@@ -2,6 +2,12 @@
 #define ETERMAL_ESHELL_H_INCLUDED
 
 #include <string>
+#include <vector>
+
+namespace etm {
+    // terminal/InputBuffer
+    class InputBuffer;
+}
 
 namespace etm {
 
@@ -34,6 +40,40 @@ namespace etm {
         * history...
         */
         virtual void cursorDown() = 0;
+
+        /**
+        * Called by the terminal once a frame, on the thread
+        * that renders it, ex. to show output from commands
+        * running in the background.
+        * Does nothing by default.
+        */
+        virtual void update();
+        /**
+        * Called when the user wants to stop what's
+        * running (ex. Ctrl+C).
+        * Does nothing by default.
+        * @see actionKey::INTERRUPT
+        */
+        virtual void interrupt();
+        /**
+        * Called when the user wants the input
+        * completed (ex. Tab).
+        * Does nothing by default.
+        * @see actionKey::TAB
+        */
+        virtual void complete();
+        /**
+        * Called when the input being typed changes, so that
+        * mistakes in it (ex. a command that doesn't exist) can be
+        * pointed out as they're made. The terminal highlights
+        * the tokens that are flagged.
+        * Flags nothing by default.
+        * @param [in] input The input, and its tokens
+        * @param [out] flagged If each token is flagged - as many
+        * as there are tokens, all `false` to start with
+        * @see InputBuffer::getTokens()
+        */
+        virtual void lint(const InputBuffer &input, std::vector<bool> &flagged);
     };
 }
 
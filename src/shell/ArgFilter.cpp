@@ -66,7 +66,7 @@ etm::ArgFilter::Filter::Filter(const std::string &name, datatype type):
 
 etm::ArgFilter::ArgFilter(): ArgFilter(getDefaultErrorHandle()) {
 }
-etm::ArgFilter::ArgFilter(ErrorHandle &errorHandle): maxArrayArgs(10) {
+etm::ArgFilter::ArgFilter(ErrorHandle &errorHandle): frozen(false), maxArrayArgs(10) {
     setErrorHandle(errorHandle);
 }
 
@@ -88,61 +88,110 @@ std::string etm::ArgFilter::getUsage() {
     return usage;
 }
 
-void etm::ArgFilter::addFilter(const std::string &name, datatype type) {
+void etm::ArgFilter::addFilter(const std::string &name, datatype type, bool alias) {
+    if (filters.size() >= Args::MAX_ARGS) {
+        throw std::out_of_range("Too many filters, the max is " + std::to_string(Args::MAX_ARGS));
+    }
     filters.emplace_back(name, type);
-    addAlias("-" + name);
+    if (alias) {
+        addAlias("-" + name);
+    }
 }
 void etm::ArgFilter::addAlias(const std::string &name) {
     if (!filters.size()) {
         throw std::out_of_range("No filters exist to alias");
     }
     aliases["-" + name] = filters.size() - 1;
+    aliasTree.insert("-" + name);
+    if (frozen) {
+        freeze();
+    }
+}
+
+void etm::ArgFilter::freeze() {
+    PerfectHash::entries_t entries(aliases.begin(), aliases.end());
+    frozenAliases.build(entries);
+    frozen = true;
+}
+void etm::ArgFilter::thaw() {
+    frozenAliases.clear();
+    frozen = false;
+}
+bool etm::ArgFilter::isFrozen() {
+    return frozen;
+}
+
+std::size_t etm::ArgFilter::findAlias(std::string_view alias) {
+    if (frozen) {
+        return frozenAliases.find(alias);
+    }
+    aliases_t::iterator loc = aliases.find(alias);
+    return loc != aliases.end() ? loc->second : PerfectHash::NONE;
+}
+const etm::ArgFilter::filters_t &etm::ArgFilter::getFilters() const {
+    return filters;
+}
+std::size_t etm::ArgFilter::indexOf(const std::string &name) const {
+    for (filters_t::size_type i = 0; i < filters.size(); i++) {
+        if (filters[i].name == name) {
+            return i;
+        }
+    }
+    return PerfectHash::NONE;
+}
+
+const etm::ArgFilter::Filter *etm::ArgFilter::findFilter(std::string_view alias) {
+    const std::size_t index = findAlias(alias);
+    return index != PerfectHash::NONE ? &filters[index] : nullptr;
 }
-bool etm::ArgFilter::filter(const std::vector<std::string> &arguments, Args &out, std::string &errMsg) {
-    typedef filters_t::size_type size;
+
+void etm::ArgFilter::complete(std::string_view prefix, std::vector<std::string> &out) const {
+    aliasTree.complete(prefix, out);
+}
+
+bool etm::ArgFilter::filter(const std::vector<std::string_view> &arguments, Args &out, std::string &errMsg) {
+    typedef std::vector<std::string_view>::size_type size;
 
     // Was an error set?
     bool failed = false;
 
-    // First argument is the invokation alias
-    out.setCall(arguments[0]);
-
-    // Used to keep track of which bool flags were set
-    std::vector<bool> done(filters.size(), false);
+    // First argument is the invokation alias.
+    // This also sets bool flags to `false`, they're
+    // set to `true` as they come.
+    out.reset(*this, arguments[0]);
 
     // Flagless parameters
-    std::vector<std::string> arrayArgs;
+    size arrayArgs = 0;
 
     for (size i = 1; i < arguments.size(); i++) {
         bool loopError = false;
-        if (arguments[i][0] == '-') {
+        if (!arguments[i].empty() && arguments[i][0] == '-') {
             // Is flag
-            aliases_t::iterator loc = aliases.find(arguments[i]);
-            if (loc != aliases.end()) {
-                Filter &f = filters[loc->second];
+            const std::size_t index = findAlias(arguments[i]);
+            if (index != PerfectHash::NONE) {
+                Filter &f = filters[index];
+                Args::value val;
                 if (f.type != datatype::BOOL) {
                     if (i + 1 < arguments.size()) {
-                        std::shared_ptr<ArgData> data;
+                        val.text = arguments[i + 1];
                         switch (f.type) {
                             case STRING: {
-                                data = std::make_shared<data::String>(arguments[i + 1]);
+                                val.type = Args::value::STRING;
                                 break;
                             }
                             case INT: {
-                                try {
-                                    data = std::make_shared<data::Integer>(std::stoi(arguments[i + 1]));
-                                } catch (std::exception &e) {
+                                val.type = Args::value::INT;
+                                if (!data::parseInt(val.text, val.integer)) {
                                     loopError = true;
-                                    errMsg += errorHandle->badDatatype(i + 1, arguments[i + 1], f.type);
+                                    errMsg += errorHandle->badDatatype(i + 1, std::string(val.text), f.type);
                                 }
                                 break;
                             }
                             case FLOAT: {
-                                try {
-                                    std::make_shared<data::Float>(std::stof(arguments[i + 1]));
-                                } catch (std::exception &e) {
+                                val.type = Args::value::FLOAT;
+                                if (!data::parseFloat(val.text, val.real)) {
                                     loopError = true;
-                                    errMsg += errorHandle->badDatatype(i + 1, arguments[i + 1], f.type);
+                                    errMsg += errorHandle->badDatatype(i + 1, std::string(val.text), f.type);
                                 }
                                 break;
                             }
@@ -154,28 +203,30 @@ bool etm::ArgFilter::filter(const std::vector<std::string> &arguments, Args &out
                         i++;
 
                         if (!loopError) {
-                            out.pushArg(filters[i].name, data);
+                            out.set(index, val);
                         }
 
                     } else {
                         loopError = true;
-                        errMsg += errorHandle->noParam(i + 1, arguments[i], f.type);
+                        errMsg += errorHandle->noParam(i + 1, std::string(arguments[i]), f.type);
                     }
                 } else {
                     // If it's of a bool type, the presence of the flag sets it to `true`
-                    done[loc->second] = true;
-                    out.pushArg(filters[i].name, std::make_shared<data::Boolean>(true));
+                    val.type = Args::value::BOOL;
+                    val.boolean = true;
+                    out.set(index, val);
                 }
             } else {
                 // The flag doesn't exist
                 loopError = true;
-                errMsg += errorHandle->badFlag(i, arguments[i]);
+                errMsg += errorHandle->badFlag(i, std::string(arguments[i]));
             }
         } else {
             // Is array param
 
-            if (arrayArgs.size() < maxArrayArgs) {
-                arrayArgs.push_back(arguments[i]);
+            if (arrayArgs < maxArrayArgs) {
+                out.pushArrayArg(arguments[i]);
+                arrayArgs++;
             } else {
                 // Too many args
                 loopError = true;
@@ -192,15 +243,10 @@ bool etm::ArgFilter::filter(const std::vector<std::string> &arguments, Args &out
         }
     }
 
-    out.setArrayArgs(std::move(arrayArgs));
-
-    // Add false flags, boolean flags that that weren't set.
-    // Place for potentual optimization.
-    for (size i = 0; i < filters.size(); i++) {
-        if (filters[i].type == datatype::BOOL && !done[i]) {
-            out.pushArg(filters[i].name, std::make_shared<data::Boolean>(false));
-        }
-    }
-
     return failed;
 }
+
+bool etm::ArgFilter::filter(const std::vector<std::string> &arguments, Args &out, std::string &errMsg) {
+    const std::vector<std::string_view> views(arguments.begin(), arguments.end());
+    return filter(views, out, errMsg);
+}
@@ -1,10 +1,14 @@
 #ifndef ETERMAL_ARGFILTER_H_INCLUDED
 #define ETERMAL_ARGFILTER_H_INCLUDED
 
+#include <map>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "Args.h"
+#include "PerfectHash.h"
+#include "RadixTree.h"
 
 namespace etm {
 
@@ -65,7 +69,7 @@ namespace etm {
         /// Type of filter container
         typedef std::vector<Filter> filters_t;
         /// Type used to represent a sequence of command aliases
-        typedef std::map<std::string, std::vector<Filter>::size_type> aliases_t;
+        typedef std::map<std::string, std::vector<Filter>::size_type, std::less<>> aliases_t;
 
         /**
         * Used to determine what happens when
@@ -206,6 +210,14 @@ namespace etm {
         filters_t filters;
         /// Aliases to @ref filter "filters"
         aliases_t aliases;
+        /// @ref aliases compiled into a perfect hash,
+        /// only used if @ref frozen
+        /// @see freeze()
+        PerfectHash frozenAliases;
+        /// Whether to use @ref frozenAliases
+        bool frozen;
+        /// @ref aliases again, for completion
+        RadixTree aliasTree;
         /// The max allowed flagless array parameters
         unsigned int maxArrayArgs;
         /// The command usage, printed by the shell
@@ -213,6 +225,13 @@ namespace etm {
         std::string usage;
         /// The in-use error handle.
         ErrorHandle *errorHandle;
+
+        /**
+        * Finds the filter of an alias.
+        * @param [in] alias The alias, including the dash(es)
+        * @return Index into @ref filters, or @ref PerfectHash::NONE
+        */
+        std::size_t findAlias(std::string_view alias);
     public:
         /**
         * Construct a new ArgFilter with the default
@@ -271,8 +290,11 @@ namespace etm {
         * @param [in] name The name of the parameter.
         * This is what's used to lookup the parameter.
         * @param [in] type The expected type of the parameter
+        * @param [in] alias Whether to alias it as `--name`
+        * @throw std::out_of_range If there are already
+        * @ref Args::MAX_ARGS filters
         */
-        void addFilter(const std::string &name, datatype type);
+        void addFilter(const std::string &name, datatype type, bool alias = true);
         // Adds alias for last filter entree.
         // Silently overwrites any other names.
         // Throws std::out_of_range if there are no filters
@@ -285,12 +307,78 @@ namespace etm {
         */
         void addAlias(const std::string &name);
         /**
+        * Compile the aliases into a perfect hash, so that
+        * looking up a flag is one hash and one compare
+        * rather than a walk down a tree.
+        * Adding aliases after this rebuilds the table, which
+        * is slow-ish, so it's best done once they're all in.
+        * @see Shell::freeze()
+        * @see thaw()
+        */
+        void freeze();
+        /**
+        * Go back to looking up aliases in the map.
+        * @see freeze()
+        */
+        void thaw();
+        /**
+        * Check if the aliases are compiled.
+        * @return `true` if they are
+        * @see freeze()
+        */
+        bool isFrozen();
+        /**
+        * Gets the filters, in the order they were added.
+        * @return The filters
+        */
+        const filters_t &getFilters() const;
+        /**
+        * Gets the index of a filter, which is where its
+        * value is in an @ref Args.
+        * Meant to be looked up once, when the command is set up.
+        * @param [in] name The filter's name
+        * @return The index, or @ref PerfectHash::NONE if there's
+        * no filter with that name
+        * @see Args::at(std::size_t index) const
+        */
+        std::size_t indexOf(const std::string &name) const;
+        /**
+        * Finds the filter that an alias (flag) is for.
+        * @param [in] alias The alias, including the dash(es)
+        * @return The filter, or `nullptr` if there's no such alias
+        */
+        const Filter *findFilter(std::string_view alias);
+        /**
+        * Finds the aliases (flags) that start with a prefix.
+        * @param [in] prefix The prefix, including the dash(es)
+        * @param [out] out The aliases, best first (replaced)
+        * @see RadixTree::complete()
+        */
+        void complete(std::string_view prefix, std::vector<std::string> &out) const;
+
+        /**
+        * Filter/process/parse given arguments.
+        * Nothing is allocated unless there's an error,
+        * or `out` needs more room for array args.
+        * @note Assumes that `arguments.size() > 0`
+        * @note `out` views the arguments, so they must
+        * outlive it
+        * @param [in] arguments The arguments split up into parts
+        * @param [out] out The Args object to store data in
+        * @param [out] errMsg String to dump error messages
+        * @return `true` if encountered an error
+        */
+        bool filter(const std::vector<std::string_view> &arguments, Args &out, std::string &errMsg);
+        /**
         * Filter/process/parse given arguments.
         * @note Assumes that `arguments.size() > 0`
+        * @note `out` views the arguments, so they must
+        * outlive it
         * @param [in] arguments The arguments split up into parts
         * @param [out] out The Args object to store data in
         * @param [out] errMsg String to dump error messages
         * @return `true` if encountered an error
+        * @see filter(const std::vector<std::string_view> &arguments, Args &out, std::string &errMsg)
         */
         bool filter(const std::vector<std::string> &arguments, Args &out, std::string &errMsg);
     };
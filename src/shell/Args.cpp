@@ -1,26 +1,105 @@
 #include "Args.h"
 
-etm::Args::Args() {
+#include "ArgFilter.h"
+#include "data/data.h"
+
+bool etm::Args::value::isSet() const {
+    return type != NONE;
+}
+std::string_view etm::Args::value::getView() const {
+    return text;
+}
+std::string etm::Args::value::getString() const {
+    switch (type) {
+        case BOOL: return boolean ? "true" : "false";
+        case NONE: return std::string();
+        default: return std::string(text);
+    }
 }
-void etm::Args::pushArg(const std::string &name, const data_t &data) {
-    args[name] = data;
+bool etm::Args::value::getBool() const {
+    switch (type) {
+        case STRING: return data::parseBool(text);
+        case INT: return static_cast<bool>(integer);
+        case FLOAT: return static_cast<bool>(real);
+        case BOOL: return boolean;
+        default: return false;
+    }
 }
-void etm::Args::setCall(const std::string &str) {
-    call = str;
+int etm::Args::value::getInt() const {
+    switch (type) {
+        case STRING: {
+            int result = 0;
+            return data::parseInt(text, result) ? result : 0;
+        }
+        case INT: return integer;
+        case FLOAT: return static_cast<int>(real);
+        case BOOL: return static_cast<int>(boolean);
+        default: return 0;
+    }
 }
-void etm::Args::setArrayArgs(std::vector<std::string> &&args) {
-    arrayArgs = std::move(args);
+float etm::Args::value::getFloat() const {
+    switch (type) {
+        case STRING: {
+            float result = 0.0f;
+            return data::parseFloat(text, result) ? result : 0.0f;
+        }
+        case INT: return static_cast<float>(integer);
+        case FLOAT: return real;
+        case BOOL: return static_cast<float>(boolean);
+        default: return 0.0f;
+    }
 }
 
+etm::Args::Args(): filter(nullptr) {
+}
+void etm::Args::reset(const ArgFilter &filter, std::string_view call) {
+    this->filter = &filter;
+    this->call = call;
+    arrayArgs.clear();
+    const ArgFilter::filters_t &filters = filter.getFilters();
+    for (std::size_t i = 0; i < filters.size(); i++) {
+        values[i].text = std::string_view();
+        // The absence of a bool flag means `false`
+        if (filters[i].type == ArgFilter::BOOL) {
+            values[i].type = value::BOOL;
+            values[i].boolean = false;
+        } else {
+            values[i].type = value::NONE;
+        }
+    }
+}
+void etm::Args::set(std::size_t index, const value &val) {
+    values[index] = val;
+}
+void etm::Args::pushArrayArg(std::string_view arg) {
+    arrayArgs.push_back(arg);
+}
+
+const etm::Args::value &etm::Args::at(std::size_t index) const {
+    return values[index];
+}
 bool etm::Args::has(const std::string &name) {
-    return args.find(name) != args.end();
+    if (filter == nullptr) {
+        return false;
+    }
+    const std::size_t index = filter->indexOf(name);
+    return index != PerfectHash::NONE && values[index].isSet();
 }
 etm::Args::data_t etm::Args::get(const std::string &name) {
-    return args[name];
+    if (!has(name)) {
+        return data_t();
+    }
+    const value &val = values[filter->indexOf(name)];
+    switch (val.type) {
+        case value::INT: return std::make_shared<data::Integer>(val.integer);
+        case value::FLOAT: return std::make_shared<data::Float>(val.real);
+        case value::BOOL: return std::make_shared<data::Boolean>(val.boolean);
+        default: return std::make_shared<data::String>(std::string(val.text));
+    }
 }
-std::string &etm::Args::getCall() {
+std::string_view etm::Args::getCall() {
     return call;
 }
-std::vector<std::string> &etm::Args::getArrayArgs() {
+std::vector<std::string_view> &etm::Args::getArrayArgs() {
     return arrayArgs;
 }
@@ -2,61 +2,151 @@
 #define ETERMAL_ARGS_H_INCLUDED
 
 #include <memory>
-#include <map>
 #include <string>
+#include <string_view>
 #include <vector>
+#include <cstddef>
 
 #include "data/ArgData.h"
 
+namespace etm {
+    // ArgFilter
+    class ArgFilter;
+}
+
 namespace etm {
 
     /**
     * Data class containing information about arguments
     * passed to a command.
+    * Values are kept inline, in the order of the
+    * @ref ArgFilter "filter's" filters, and text is viewed
+    * rather than copied - so nothing is allocated to build
+    * one, save for growing the array args.
+    * @note Views are into the command string, and so
+    * only valid during the command callback.
     * @see ArgFilter
     * @see Shell
     */
     class Args {
+    public:
+        /// Max number of filters an @ref ArgFilter can have
+        static constexpr std::size_t MAX_ARGS = 32;
+
+        /**
+        * The value of an argument, a small tagged union.
+        * Conversions are the same as the @ref data classes.
+        */
+        struct value {
+            /// What's held
+            enum kind {
+                /// Not given
+                NONE,
+                /// Text, in @ref text
+                STRING,
+                /// An int, in @ref integer
+                INT,
+                /// A float, in @ref real
+                FLOAT,
+                /// A bool, in @ref boolean
+                BOOL
+            };
+            /// What's held
+            kind type;
+            union {
+                /// The int, if @ref INT
+                int integer;
+                /// The float, if @ref FLOAT
+                float real;
+                /// The bool, if @ref BOOL
+                bool boolean;
+            };
+            /// The text given for the argument, empty
+            /// if it's a @ref BOOL (those are just flags)
+            std::string_view text;
+
+            /**
+            * Check if the argument was given.
+            * @return `true` if it's not @ref NONE
+            */
+            bool isSet() const;
+            /**
+            * The argument as text, without copying.
+            * @return The text given, or empty if it's a @ref BOOL
+            */
+            std::string_view getView() const;
+            /**
+            * The best representation of the argument as a string.
+            * @return The string
+            */
+            std::string getString() const;
+            /**
+            * The best representation of the argument as a boolean.
+            * @return The bool
+            */
+            bool getBool() const;
+            /**
+            * The best representation of the argument as an integer.
+            * @return The int
+            */
+            int getInt() const;
+            /**
+            * The best representation of the argument as a float.
+            * @return The float
+            */
+            float getFloat() const;
+        };
+    private:
         /// Arg values
         /// @see data
         typedef std::shared_ptr<ArgData> data_t;
-    private:
-        /// Containter type for arguments
-        typedef std::map<std::string, data_t> container_t;
-        /// Arguments container
-        container_t args;
+
+        /// The filter that filled this in
+        const ArgFilter *filter;
+        /// Argument values, indexed like the filter's filters
+        value values[MAX_ARGS];
         // Flagless parameters
-        std::vector<std::string> arrayArgs;
+        std::vector<std::string_view> arrayArgs;
         /// The alias that was used to invoke the command
-        std::string call;
+        std::string_view call;
     public:
         /**
         * Construct an Args object.
         */
         Args();
         /** @internal
-        * Adds a new argument.
+        * Readies for a new command, forgetting the last.
+        * Bool arguments start as `false`, everything else
+        * as not given.
         * @note For building only by @ref ArgFilter
-        * @param [in] name The argument name
-        * @param [in] data The argument data
-        * @see has(const std::string &name)
-        * @see get(const std::string &name)
-        * @see args
+        * @param [in] filter The filter doing the filling in
+        * @param [in] call The alias that was used to invoke the command
+        * @see getCall()
         */
-        void pushArg(const std::string &name, const data_t &data);
+        void reset(const ArgFilter &filter, std::string_view call);
         /** @internal
-        * Sets the alias that was used to invoke the command.
-        * @param [in] str The alias
-        * @see getCall()
-        * @see call
+        * Sets an argument.
+        * @note For building only by @ref ArgFilter
+        * @param [in] index Index of the argument's filter
+        * @param [in] val The value
         */
-        void setCall(const std::string &str);
+        void set(std::size_t index, const value &val);
         /** @internal
-        * Set the array args.
-        * @param [in,out] The args (moved)
+        * Adds an array arg.
+        * @note For building only by @ref ArgFilter
+        * @param [in] arg The arg
         */
-        void setArrayArgs(std::vector<std::string> &&args);
+        void pushArrayArg(std::string_view arg);
 
+        /**
+        * Gets an argument by the index of its filter, which
+        * is the fast way - look the index up once with
+        * @ref ArgFilter::indexOf(const std::string &name) const.
+        * @note Does no range checks
+        * @param [in] index Index of the argument's filter
+        * @return The value, @ref value::NONE if not given
+        */
+        const value &at(std::size_t index) const;
         /**
         * Check if object @e has the given argument.
         * @param [in] name Name of the argument
@@ -68,6 +158,7 @@ namespace etm {
         * @note If the argument doesn't exist
         * (@ref has(const std::string &name) returns false),
         * the returned shared pointer will not be callable.
+        * @note Allocates, prefer @ref at(std::size_t index) const
         * @param [in] name Name of the argument
         */
         data_t get(const std::string &name);
@@ -75,12 +166,12 @@ namespace etm {
         * Gets the alias that was used to invoke the command.
         * @return The alias
         */
-        std::string &getCall();
+        std::string_view getCall();
         /**
         * Gets the flagless parameters
         * @return The args
         */
-        std::vector<std::string> &getArrayArgs();
+        std::vector<std::string_view> &getArrayArgs();
     };
 }
 
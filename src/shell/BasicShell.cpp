@@ -2,16 +2,17 @@
 
 #include <iostream>
 #include <utility>
+#include <algorithm>
 
 #include "../ETerminal.h"
 #include "shellError.h"
+#include "completion.h"
 
 static void makeLowercase(std::string &str);
 static void defaultErrorCallback(const etm::shellError &error);
 static std::string defaultNoCommandCallback(const std::string &command);
-std::vector<std::string> chopString(const std::string &str);
 
-static constexpr unsigned int MAX_COMMAND_HISTORY = 10;
+std::vector<std::string> chopString(const std::string &str);
 
 void makeLowercase(std::string &str) {
     for (char &c : str) {
@@ -41,9 +42,8 @@ etm::BasicShell::BasicShell(const errCallback_t &callback):
     terminal(nullptr),
     flags(flag::none),
     prompt("\nuser@terminal ~\n$ "),
-    seekI(0)
+    seekI(History::NONE)
 {
-    commandHistory.reserve(MAX_COMMAND_HISTORY);
     setErrorCallback(callback);
     setNoCommandCallback(defaultNoCommandCallback);
 }
@@ -129,11 +129,8 @@ void etm::BasicShell::input(const std::string &commandString) {
             terminal->dispText(noCommandCallback(params[0]));
         }
 
-        if (commandHistory.size() >= MAX_COMMAND_HISTORY) {
-            commandHistory.erase(commandHistory.begin(), commandHistory.begin() + (commandHistory.size() - MAX_COMMAND_HISTORY + 1));
-        }
-        commandHistory.push_back(commandString);
-        seekI = commandHistory.size();
+        history.add(commandString);
+        seekI = history.end();
     }
 
     // Does flushing for us
@@ -147,25 +144,64 @@ void etm::BasicShell::setInput(const std::string &str) {
 }
 
 void etm::BasicShell::cursorUp() {
-    if (commandHistory.size() > 0 && seekI != 0) {
-        if (seekI == commandHistory.size()) {
-            currentText = terminal->pollInput();
-        }
-        seekI--;
-        setInput(commandHistory[seekI]);
+    if (seekI >= history.end()) {
+        seekI = history.end();
+        currentText = terminal->pollInput();
+    }
+    // Only entries that start with what was typed
+    const History::index_t found = history.findBack(currentText, seekI, true);
+    if (found != History::NONE) {
+        seekI = found;
+        setInput(history.get(seekI));
     }
 }
 void etm::BasicShell::cursorDown() {
-    if (commandHistory.size() > 0) {
-        if (seekI < commandHistory.size() - 1) {
-            seekI++;
-            setInput(commandHistory[seekI]);
-        } else {
-            seekI = commandHistory.size();
-            setInput(currentText);
-            currentText.clear();
-            currentText.shrink_to_fit();
-        }
+    if (seekI >= history.end()) {
+        return;
+    }
+    const History::index_t found = history.findForward(currentText, seekI, true);
+    if (found != History::NONE) {
+        seekI = found;
+        setInput(history.get(seekI));
+    } else {
+        // Back to what was being typed
+        seekI = history.end();
+        setInput(currentText);
+        currentText.clear();
+        currentText.shrink_to_fit();
+    }
+}
+
+etm::History &etm::BasicShell::getHistory() {
+    return history;
+}
+
+std::size_t etm::BasicShell::getCompletions(const std::string &text, std::vector<std::string> &out) {
+    out.clear();
+    // Only commands have names to complete
+    const std::string::size_type first = text.find_first_not_of(' ');
+    if (first != std::string::npos && text.find(' ', first) != std::string::npos) {
+        return text.size();
+    }
+    const std::string::size_type start = first == std::string::npos ? text.size() : first;
+    std::string word = text.substr(start);
+    if (flagSet(flag::nocase)) {
+        makeLowercase(word);
+    }
+    aliasTree.complete(word, out);
+    return start;
+}
+
+void etm::BasicShell::complete() {
+    if (terminal == nullptr) {
+        return;
+    }
+    const std::string text = terminal->pollInput();
+    const std::size_t start = getCompletions(text, completions);
+    if (completion::apply(*terminal, text, start, completions)) {
+        // The choices were listed, so start over
+        prepTerminal();
+        setInput(text);
     }
 }
 
@@ -193,8 +229,10 @@ void etm::BasicShell::alias(const std::string &name) {
             std::string lower(name);
             makeLowercase(lower);
             aliasMap[lower] = commands.size() - 1;
+            aliasTree.insert(lower);
         } else {
             aliasMap[name] = commands.size() - 1;
+            aliasTree.insert(name);
         }
     } else {
         postError(
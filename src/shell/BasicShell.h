@@ -7,6 +7,8 @@
 #include <map>
 
 #include "../EShell.h"
+#include "History.h"
+#include "RadixTree.h"
 
 namespace etm {
     // ETerminal
@@ -79,20 +81,24 @@ namespace etm {
         /// Command aliases, all point to a nameless command in @ref commands
         /// @see alias(const std::string &name)
         aliasMap_t aliasMap;
+        /// The keys of @ref aliasMap again, for completion
+        RadixTree aliasTree;
+        /// Completions, kept to reuse their memory
+        std::vector<std::string> completions;
         /// Flags
         /// @see setFlags(flag::type flags)
         flag::type flags;
         /// Printed to screen after each command invokation is complete
         /// @see setPrompt(const std::string &str)
         std::string prompt;
-        /// The shell's command history.
-        /// Capped at an arbitrary number (small)
-        std::vector<std::string> commandHistory;
+        /// The shell's command history
+        /// @see getHistory()
+        History history;
         /// Stored text so that seeking operations can
         /// return to what the user was preveously typing.
         std::string currentText;
         /// Seek index for command history
-        std::vector<std::string>::size_type seekI;
+        History::index_t seekI;
 
         /**
         * Checks if a flag is set.
@@ -193,6 +199,27 @@ namespace etm {
         void input(const std::string &commandString) override;
         void cursorUp() override;
         void cursorDown() override;
+        /**
+        * Gets the command history, ex. to set its
+        * capacity or the file it's saved to.
+        * Moving the cursor up and down with some input
+        * typed only goes through entries that start with it.
+        * @return The history
+        */
+        History &getHistory();
+        /**
+        * Finds what the command in some input could be completed to.
+        * @param [in] text The input
+        * @param [out] out The completions, best first (replaced)
+        * @return Where in `text` the word being completed starts
+        * @see complete()
+        */
+        std::size_t getCompletions(const std::string &text, std::vector<std::string> &out);
+        /**
+        * Completes the input as far as it can, or if there's
+        * a choice to be made, lists the choices.
+        */
+        void complete() override;
 
         /**
         * Add a new command to the BasicShell.
@@ -0,0 +1,329 @@
+#include "History.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <system_error>
+
+/// Rewrite the file once it has this many times
+/// as many entries as are kept
+static constexpr std::size_t COMPACT_FACTOR = 2;
+
+/**
+* Escapes an entry so that it fits on one line.
+* @param [in] command The entry
+* @param [out] out Where to put the escaped entry (replaced)
+*/
+static void escape(std::string_view command, std::string &out);
+/**
+* Undoes @ref escape(std::string_view command, std::string &out)
+* @param [in] line The escaped entry
+* @param [out] out Where to put the entry (replaced)
+*/
+static void unescape(std::string_view line, std::string &out);
+/**
+* Packs the three bytes at a position into a trigram.
+* @param [in] text The text
+* @param [in] i The position
+* @return The trigram
+*/
+static std::uint32_t trigramAt(std::string_view text, std::size_t i);
+
+void escape(std::string_view command, std::string &out) {
+    out.clear();
+    for (char c : command) {
+        switch (c) {
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            default: out.push_back(c);
+        }
+    }
+}
+
+void unescape(std::string_view line, std::string &out) {
+    out.clear();
+    for (std::size_t i = 0; i < line.size(); i++) {
+        if (line[i] == '\\' && i + 1 < line.size()) {
+            i++;
+            switch (line[i]) {
+                case 'n': out.push_back('\n'); break;
+                case 'r': out.push_back('\r'); break;
+                default: out.push_back(line[i]);
+            }
+        } else {
+            out.push_back(line[i]);
+        }
+    }
+}
+
+std::uint32_t trigramAt(std::string_view text, std::size_t i) {
+    return static_cast<unsigned char>(text[i]) |
+        (static_cast<unsigned char>(text[i + 1]) << 8) |
+        (static_cast<std::uint32_t>(static_cast<unsigned char>(text[i + 2])) << 16);
+}
+
+etm::History::History(std::size_t capacity):
+    ring(std::max<std::size_t>(capacity, 1)),
+    capacity(ring.size()),
+    next(0),
+    count(0),
+    indexed(0),
+    loaded(true),
+    fileEntries(0)
+{
+}
+
+void etm::History::load() {
+    if (loaded) {
+        return;
+    }
+    loaded = true;
+
+    // Whatever was added before the file was
+    // set comes after what's in it
+    std::vector<std::string> added;
+    added.reserve(count);
+    for (index_t i = first(); i < next; i++) {
+        added.push_back(std::move(ring[i % capacity]));
+    }
+    count = 0;
+    reindex();
+
+    std::ifstream in(path, std::ios::binary);
+    std::string line;
+    std::string command;
+    fileEntries = 0;
+    while (std::getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        unescape(line, command);
+        push(command);
+        fileEntries++;
+    }
+    in.close();
+
+    file.open(path, std::ios::binary | std::ios::app);
+    for (const std::string &c : added) {
+        add(c);
+    }
+    if (fileEntries >= capacity * COMPACT_FACTOR) {
+        compact();
+    }
+}
+
+void etm::History::push(std::string_view command) {
+    ring[next % capacity].assign(command);
+    next++;
+    if (count < capacity) {
+        count++;
+    }
+    indexEntry(next - 1);
+    // Clean out dropped entries once there's
+    // as many of them as there are kept ones
+    if (first() - indexed >= capacity) {
+        reindex();
+    }
+}
+
+void etm::History::indexEntry(index_t i) {
+    const std::string &entry = ring[i % capacity];
+    for (std::size_t c = 0; c + 2 < entry.size(); c++) {
+        std::vector<index_t> &entries = trigrams[trigramAt(entry, c)];
+        // Only once per entry
+        if (entries.empty() || entries.back() != i) {
+            entries.push_back(i);
+        }
+    }
+}
+
+void etm::History::reindex() {
+    trigrams.clear();
+    indexed = first();
+    for (index_t i = indexed; i < next; i++) {
+        indexEntry(i);
+    }
+}
+
+const std::vector<etm::History::index_t> *etm::History::candidates(std::string_view text) {
+    // Every match has all of the text's trigrams,
+    // so the rarest one narrows it down the most
+    const std::vector<index_t> *best = nullptr;
+    for (std::size_t c = 0; c + 2 < text.size(); c++) {
+        trigrams_t::const_iterator loc = trigrams.find(trigramAt(text, c));
+        if (loc == trigrams.end()) {
+            return nullptr;
+        }
+        if (best == nullptr || loc->second.size() < best->size()) {
+            best = &loc->second;
+        }
+    }
+    return best;
+}
+
+bool etm::History::matches(index_t i, std::string_view text, bool prefix) {
+    const std::string &entry = ring[i % capacity];
+    if (prefix) {
+        return entry.compare(0, text.size(), text) == 0;
+    }
+    return entry.find(text) != std::string::npos;
+}
+
+void etm::History::setCapacity(std::size_t capacity) {
+    load();
+    capacity = std::max<std::size_t>(capacity, 1);
+    const std::size_t kept = std::min(count, capacity);
+    std::vector<std::string> resized(capacity);
+    for (index_t i = next - kept; i < next; i++) {
+        resized[i % capacity] = std::move(ring[i % this->capacity]);
+    }
+    ring = std::move(resized);
+    this->capacity = capacity;
+    count = kept;
+    reindex();
+}
+std::size_t etm::History::getCapacity() {
+    return capacity;
+}
+
+void etm::History::setFile(const std::string &path) {
+    load();
+    file.close();
+    this->path = path;
+    fileEntries = 0;
+    loaded = path.empty();
+}
+
+bool etm::History::compact() {
+    load();
+    if (path.empty()) {
+        return true;
+    }
+    file.close();
+
+    // Written to the side and swapped in, so that
+    // the history isn't lost if something goes wrong
+    const std::string temp = path + ".tmp";
+    std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+    std::string line;
+    for (index_t i = first(); i < next; i++) {
+        escape(ring[i % capacity], line);
+        out << line << '\n';
+    }
+    out.close();
+    std::error_code error;
+    if (out.fail()) {
+        std::filesystem::remove(temp, error);
+    } else {
+        std::filesystem::rename(temp, path, error);
+    }
+    const bool good = !out.fail() && !error;
+    if (good) {
+        fileEntries = count;
+    }
+
+    file.open(path, std::ios::binary | std::ios::app);
+    return good;
+}
+
+void etm::History::add(std::string_view command) {
+    load();
+    push(command);
+    if (file.is_open()) {
+        std::string line;
+        escape(command, line);
+        line.push_back('\n');
+        file.write(line.data(), line.size());
+        // So that it's there even if we crash
+        file.flush();
+        fileEntries++;
+        if (fileEntries >= capacity * COMPACT_FACTOR) {
+            compact();
+        }
+    }
+}
+
+void etm::History::clear() {
+    load();
+    count = 0;
+    reindex();
+    if (!path.empty()) {
+        file.close();
+        file.open(path, std::ios::binary | std::ios::trunc);
+        file.close();
+        file.open(path, std::ios::binary | std::ios::app);
+        fileEntries = 0;
+    }
+}
+
+etm::History::index_t etm::History::first() {
+    load();
+    return next - count;
+}
+etm::History::index_t etm::History::end() {
+    load();
+    return next;
+}
+std::size_t etm::History::size() {
+    load();
+    return count;
+}
+const std::string &etm::History::get(index_t i) {
+    load();
+    return ring[i % capacity];
+}
+
+etm::History::index_t etm::History::findBack(std::string_view text, index_t before, bool prefix) {
+    load();
+    const index_t oldest = first();
+    before = std::min(before, next);
+    if (text.size() < 3) {
+        // Too short for the index, but then
+        // again, most things will match
+        for (index_t i = before; i-- > oldest;) {
+            if (matches(i, text, prefix)) {
+                return i;
+            }
+        }
+        return NONE;
+    }
+    const std::vector<index_t> *entries = candidates(text);
+    if (entries == nullptr) {
+        return NONE;
+    }
+    std::vector<index_t>::const_iterator it = std::lower_bound(entries->begin(), entries->end(), before);
+    while (it != entries->begin()) {
+        --it;
+        if (*it < oldest) {
+            break;
+        }
+        if (matches(*it, text, prefix)) {
+            return *it;
+        }
+    }
+    return NONE;
+}
+
+etm::History::index_t etm::History::findForward(std::string_view text, index_t after, bool prefix) {
+    load();
+    const index_t from = after == NONE ? first() : std::max(after + 1, first());
+    if (text.size() < 3) {
+        for (index_t i = from; i < next; i++) {
+            if (matches(i, text, prefix)) {
+                return i;
+            }
+        }
+        return NONE;
+    }
+    const std::vector<index_t> *entries = candidates(text);
+    if (entries == nullptr) {
+        return NONE;
+    }
+    std::vector<index_t>::const_iterator it = std::lower_bound(entries->begin(), entries->end(), from);
+    for (; it != entries->end(); ++it) {
+        if (matches(*it, text, prefix)) {
+            return *it;
+        }
+    }
+    return NONE;
+}
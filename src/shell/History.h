@@ -0,0 +1,196 @@
+#ifndef ETERMAL_HISTORY_H_INCLUDED
+#define ETERMAL_HISTORY_H_INCLUDED
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <fstream>
+#include <cstddef>
+#include <cstdint>
+
+namespace etm {
+
+    /**
+    * Command history.
+    * Entries are kept in a ring, so adding one is constant time
+    * no matter how big it gets, and the oldest entries are dropped
+    * once it's full.
+    * Each entry has an index that counts up from the first ever added,
+    * and doesn't change as older ones are dropped - valid indices
+    * are [@ref first(), @ref end()).
+    *
+    * Optionally, the history is saved to a file, one entry per line,
+    * appended to as entries are added. Since the file keeps the
+    * dropped entries too, it's rewritten with just the kept ones
+    * once it's grown to twice the capacity.
+    * The file is only read when the history is first used.
+    *
+    * Searches go through an index of the three byte sequences
+    * (trigrams) in each entry, so that only entries that could match
+    * are looked at.
+    * @see Shell::getHistory()
+    */
+    class History {
+    public:
+        /// Type of entry indices
+        typedef unsigned long long index_t;
+        /// Returned by searches when nothing was found
+        static constexpr index_t NONE = ~static_cast<index_t>(0);
+        /// Default max number of entries
+        static constexpr std::size_t DEFAULT_CAPACITY = 1000;
+    private:
+        /// Type of the trigram index
+        typedef std::unordered_map<std::uint32_t, std::vector<index_t>> trigrams_t;
+
+        /// The entries, entry `i` is at `i % ring.size()`
+        std::vector<std::string> ring;
+        /// Max number of entries
+        std::size_t capacity;
+        /// Index of the next entry to be added
+        index_t next;
+        /// Number of entries
+        std::size_t count;
+
+        /// The entries that have each trigram, oldest first.
+        /// Dropped entries are weeded out by @ref reindex().
+        trigrams_t trigrams;
+        /// The oldest entry in @ref trigrams
+        index_t indexed;
+
+        /// The file to save to, none if empty
+        std::string path;
+        /// Whether @ref path has been read
+        bool loaded;
+        /// Where new entries are appended
+        std::ofstream file;
+        /// Number of entries in the file
+        std::size_t fileEntries;
+
+        /**
+        * Reads the file, if it hasn't been yet.
+        */
+        void load();
+        /**
+        * Adds an entry to the ring and index, without saving it.
+        * @param [in] command The entry
+        */
+        void push(std::string_view command);
+        /**
+        * Adds an entry to @ref trigrams.
+        * @param [in] i The entry's index
+        */
+        void indexEntry(index_t i);
+        /**
+        * Rebuilds @ref trigrams from the kept entries.
+        */
+        void reindex();
+        /**
+        * Gets the entries that could contain some text.
+        * @param [in] text The text, at least 3 bytes
+        * @return The entries, or `nullptr` if there
+        * aren't any
+        */
+        const std::vector<index_t> *candidates(std::string_view text);
+        /**
+        * Check if an entry matches.
+        * @param [in] i The entry's index
+        * @param [in] text The text to look for
+        * @param [in] prefix Whether the entry has to start with it
+        * @return `true` if it matches
+        */
+        bool matches(index_t i, std::string_view text, bool prefix);
+    public:
+        /**
+        * Construct an empty history.
+        * @param [in] capacity Max number of entries, at least 1
+        */
+        History(std::size_t capacity = DEFAULT_CAPACITY);
+
+        /**
+        * Sets the max number of entries, dropping the
+        * oldest ones if there are too many.
+        * @param [in] capacity Max number of entries, at least 1
+        */
+        void setCapacity(std::size_t capacity);
+        /**
+        * Gets the max number of entries.
+        * @return The max
+        */
+        std::size_t getCapacity();
+
+        /**
+        * Sets the file to save the history to.
+        * If it exists, its entries are loaded (eventually), before
+        * any added so far.
+        * @param [in] path Path to the file, or empty for none
+        */
+        void setFile(const std::string &path);
+        /**
+        * Rewrites the file with just the kept entries.
+        * This is done automatically, but can be done
+        * sooner (ex. on exit).
+        * @return `false` if the file couldn't be written
+        */
+        bool compact();
+
+        /**
+        * Adds an entry, dropping the oldest
+        * one if it's full.
+        * @param [in] command The entry
+        */
+        void add(std::string_view command);
+        /**
+        * Removes all entries, and empties the file.
+        * Indices keep counting up.
+        */
+        void clear();
+
+        /**
+        * Gets the index of the oldest entry.
+        * @return The index
+        */
+        index_t first();
+        /**
+        * Gets one past the index of the newest entry.
+        * @return The index
+        */
+        index_t end();
+        /**
+        * Gets the number of entries.
+        * @return The count
+        */
+        std::size_t size();
+        /**
+        * Gets an entry.
+        * @note Does no range checks
+        * @param [in] i The entry's index, in [@ref first(), @ref end())
+        * @return The entry
+        */
+        const std::string &get(index_t i);
+
+        /**
+        * Finds the newest entry before another that contains some text,
+        * ex. for a Ctrl+R style search.
+        * @param [in] text The text to look for, empty matches anything
+        * @param [in] before Index to search back from, exclusive -
+        * @ref end() for the newest entry, or the last match to
+        * find the one before it
+        * @param [in] prefix If `true`, only entries that start
+        * with `text` match
+        * @return The entry's index, or @ref NONE
+        */
+        index_t findBack(std::string_view text, index_t before, bool prefix);
+        /**
+        * Finds the oldest entry after another that contains some text.
+        * @param [in] text The text to look for, empty matches anything
+        * @param [in] after Index to search on from, exclusive
+        * @param [in] prefix If `true`, only entries that start
+        * with `text` match
+        * @return The entry's index, or @ref NONE
+        */
+        index_t findForward(std::string_view text, index_t after, bool prefix);
+    };
+}
+
+#endif
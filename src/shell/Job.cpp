@@ -0,0 +1,86 @@
+#include "Job.h"
+
+etm::Job::Job(): cancelled(false), finished(false) {
+}
+
+bool etm::Job::write(std::string_view text) {
+    if (next) {
+        return next->write(text);
+    }
+    std::lock_guard<std::mutex> guard(lock);
+    output.append(text);
+    return true;
+}
+bool etm::Job::read(std::string &chunk) {
+    if (!pending.empty()) {
+        chunk.clear();
+        chunk.swap(pending);
+        return true;
+    }
+    return input && input->read(chunk);
+}
+bool etm::Job::readLine(std::string &line) {
+    std::string::size_type end;
+    std::string chunk;
+    while ((end = pending.find('\n')) == std::string::npos) {
+        if (!input || !input->read(chunk)) {
+            // Whatever's left is the last line
+            if (pending.empty()) {
+                return false;
+            }
+            line.clear();
+            line.swap(pending);
+            return true;
+        }
+        pending += chunk;
+    }
+    line.assign(pending, 0, end);
+    pending.erase(0, end + 1);
+    return true;
+}
+bool etm::Job::isCancelled() const {
+    return cancelled.load();
+}
+
+void etm::Job::connect(const std::shared_ptr<Pipe> &input, const std::shared_ptr<Pipe> &next) {
+    this->input = input;
+    this->next = next;
+}
+void etm::Job::cancel() {
+    cancelled.store(true);
+    // Wake the callback if it's waiting on a pipe
+    if (input) {
+        input->abandon();
+    }
+    if (next) {
+        next->close();
+    }
+}
+void etm::Job::finish() {
+    // Let the stages on either side know
+    if (input) {
+        input->abandon();
+    }
+    if (next) {
+        next->close();
+    }
+    std::lock_guard<std::mutex> guard(lock);
+    finished.store(true);
+    done.notify_all();
+}
+bool etm::Job::isFinished() const {
+    return finished.load();
+}
+void etm::Job::wait() {
+    std::unique_lock<std::mutex> guard(lock);
+    done.wait(guard, [this]() -> bool {
+        return finished.load();
+    });
+}
+bool etm::Job::take(std::string &out) {
+    out.clear();
+    std::lock_guard<std::mutex> guard(lock);
+    // Swapping keeps both buffers' memory around
+    output.swap(out);
+    return !out.empty();
+}
@@ -0,0 +1,119 @@
+#ifndef ETERMAL_JOB_H_INCLUDED
+#define ETERMAL_JOB_H_INCLUDED
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <string>
+#include <string_view>
+
+#include "Pipe.h"
+
+namespace etm {
+
+    /**
+    * A command running in the background, as seen by
+    * its callback (see @ref Shell::addJobCommand()).
+    * Output written to it is picked up by the shell once
+    * a frame, and shown all at once.
+    * Cancellation is cooperative - the callback should
+    * check @ref isCancelled() every so often, and return
+    * early if it's set.
+    *
+    * In a pipeline (`a | b`), each stage is a job, on a thread of
+    * its own. What a stage writes is read by the next one through
+    * a @ref Pipe, and only the last stage's output is shown.
+    * @note The callback's own thread may use every public
+    * function here, the rest is for the shell.
+    */
+    class Job {
+        /// Guards @ref output and @ref finished
+        std::mutex lock;
+        /// Signalled when the callback returns
+        std::condition_variable done;
+        /// Output that hasn't been picked up yet
+        std::string output;
+        /// Whether the job was asked to stop
+        std::atomic<bool> cancelled;
+        /// Whether the callback returned
+        std::atomic<bool> finished;
+        /// Where input comes from, if it's not the first stage
+        std::shared_ptr<Pipe> input;
+        /// Where output goes, if it's not the last stage
+        std::shared_ptr<Pipe> next;
+        /// Input read but not yet given out by
+        /// @ref readLine(std::string &line)
+        std::string pending;
+    public:
+        /**
+        * Construct a job that's running.
+        */
+        Job();
+
+        /**
+        * Writes text to the terminal (eventually), or
+        * to the next stage of the pipeline.
+        * @param [in] text UTF-8 encoded text, may
+        * have formatting sequences
+        * @return `false` if the next stage has stopped
+        * reading, so there's no point in going on
+        */
+        bool write(std::string_view text);
+        /**
+        * Reads output from the previous stage of the pipeline,
+        * in whatever chunks it was written in.
+        * Waits for some if there isn't any yet.
+        * @param [out] chunk The text (replaced)
+        * @return `false` if there's no more (or
+        * it's the first stage)
+        */
+        bool read(std::string &chunk);
+        /**
+        * Reads a line of output from the previous stage of the pipeline.
+        * Waits for one if there isn't one yet.
+        * @param [out] line The line, without the newline (replaced)
+        * @return `false` if there's no more (or
+        * it's the first stage)
+        */
+        bool readLine(std::string &line);
+        /**
+        * Check if the job has been asked to stop.
+        * @return `true` if it should stop
+        */
+        bool isCancelled() const;
+
+        /** @internal
+        * Connects the job to the stages on either side.
+        * @param [in] input Where input comes from, or `nullptr`
+        * @param [in] next Where output goes, or `nullptr` for the terminal
+        */
+        void connect(const std::shared_ptr<Pipe> &input, const std::shared_ptr<Pipe> &next);
+        /** @internal
+        * Ask the job to stop.
+        */
+        void cancel();
+        /** @internal
+        * Mark that the callback returned.
+        */
+        void finish();
+        /** @internal
+        * Check if the callback returned.
+        * @return `true` if it did
+        */
+        bool isFinished() const;
+        /** @internal
+        * Waits for the callback to return.
+        */
+        void wait();
+        /** @internal
+        * Takes the output written since the last call.
+        * @param [out] out Where to put it, replaced
+        * (swapped, so no copying)
+        * @return `true` if there was any
+        */
+        bool take(std::string &out);
+    };
+}
+
+#endif
@@ -0,0 +1,149 @@
+#include "PerfectHash.h"
+
+#include <algorithm>
+
+/// Number of seeds tried for a bucket before giving up on the salt
+static constexpr std::uint32_t MAX_SEED = 1 << 16;
+/// Number of salts tried before the table is made bigger
+static constexpr std::uint64_t MAX_SALT = 8;
+
+/**
+* Scrambles a key's hash with a bucket's seed.
+* @param [in] h The hash
+* @param [in] seed The seed
+* @return The scrambled hash
+*/
+static std::uint64_t scramble(std::uint64_t h, std::uint32_t seed);
+
+std::uint64_t scramble(std::uint64_t h, std::uint32_t seed) {
+    // splitmix64's finalizer
+    h += (seed + 1) * 0x9E3779B97F4A7C15ull;
+    h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ull;
+    h = (h ^ (h >> 27)) * 0x94D049BB133111EBull;
+    return h ^ (h >> 31);
+}
+
+etm::PerfectHash::PerfectHash(): salt(0), count(0) {
+}
+
+std::uint64_t etm::PerfectHash::hash(std::string_view key) const {
+    // FNV-1a
+    std::uint64_t h = 0xCBF29CE484222325ull ^ salt;
+    for (char c : key) {
+        h = (h ^ static_cast<unsigned char>(c)) * 0x100000001B3ull;
+    }
+    return h;
+}
+
+std::size_t etm::PerfectHash::slotOf(std::uint64_t h) const {
+    // Both are powers of two
+    return scramble(h, seeds[h & (seeds.size() - 1)]) & (slots.size() - 1);
+}
+
+bool etm::PerfectHash::place(const entries_t &entries, std::size_t slotCount) {
+    std::size_t bucketCount = 1;
+    while (bucketCount * 2 < entries.size()) {
+        bucketCount *= 2;
+    }
+    seeds.assign(bucketCount, 0);
+    slots.assign(slotCount, slot{std::string(), NONE});
+
+    std::vector<std::uint64_t> hashes;
+    hashes.reserve(entries.size());
+    std::vector<std::vector<std::size_t>> buckets(bucketCount);
+    for (std::size_t i = 0; i < entries.size(); i++) {
+        hashes.push_back(hash(entries[i].first));
+        buckets[hashes.back() & (bucketCount - 1)].push_back(i);
+    }
+
+    // The biggest buckets are the hardest to place,
+    // so do them while there's the most room
+    std::vector<std::size_t> order(bucketCount);
+    for (std::size_t i = 0; i < bucketCount; i++) {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&buckets](std::size_t a, std::size_t b) -> bool {
+        return buckets[a].size() > buckets[b].size();
+    });
+
+    std::vector<std::size_t> taken;
+    for (std::size_t b : order) {
+        const std::vector<std::size_t> &bucket = buckets[b];
+        if (bucket.empty()) {
+            break;
+        }
+        std::uint32_t seed = 0;
+        for (; seed < MAX_SEED; seed++) {
+            taken.clear();
+            bool fits = true;
+            for (std::size_t i : bucket) {
+                const std::size_t s = scramble(hashes[i], seed) & (slotCount - 1);
+                if (slots[s].value != NONE || std::find(taken.begin(), taken.end(), s) != taken.end()) {
+                    fits = false;
+                    break;
+                }
+                taken.push_back(s);
+            }
+            if (fits) {
+                break;
+            }
+        }
+        if (seed == MAX_SEED) {
+            return false;
+        }
+        seeds[b] = seed;
+        for (std::size_t i = 0; i < bucket.size(); i++) {
+            slots[taken[i]] = slot{entries[bucket[i]].first, entries[bucket[i]].second};
+        }
+    }
+    return true;
+}
+
+void etm::PerfectHash::build(const entries_t &entries) {
+    // Duplicate keys could never be told apart, so the first one wins
+    entries_t unique(entries);
+    std::stable_sort(unique.begin(), unique.end(), [](const entries_t::value_type &a, const entries_t::value_type &b) -> bool {
+        return a.first < b.first;
+    });
+    unique.erase(std::unique(unique.begin(), unique.end(), [](const entries_t::value_type &a, const entries_t::value_type &b) -> bool {
+        return a.first == b.first;
+    }), unique.end());
+
+    clear();
+    if (unique.empty()) {
+        return;
+    }
+
+    // Half full at most, so that it doesn't take long to build
+    std::size_t slotCount = 1;
+    while (slotCount < unique.size() * 2) {
+        slotCount *= 2;
+    }
+    for (;; slotCount *= 2) {
+        for (salt = 0; salt < MAX_SALT; salt++) {
+            if (place(unique, slotCount)) {
+                count = unique.size();
+                return;
+            }
+        }
+    }
+}
+
+etm::PerfectHash::value_type etm::PerfectHash::find(std::string_view key) const {
+    if (!count) {
+        return NONE;
+    }
+    const slot &s = slots[slotOf(hash(key))];
+    return s.key == key ? s.value : NONE;
+}
+
+void etm::PerfectHash::clear() {
+    seeds.clear();
+    slots.clear();
+    salt = 0;
+    count = 0;
+}
+
+std::size_t etm::PerfectHash::size() const {
+    return count;
+}
@@ -0,0 +1,105 @@
+#ifndef ETERMAL_PERFECTHASH_H_INCLUDED
+#define ETERMAL_PERFECTHASH_H_INCLUDED
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+
+namespace etm {
+
+    /**
+    * A read-only string table with a perfect hash, so that
+    * a lookup is one hash of the key and one string compare.
+    * It's built in one go from a fixed set of keys (hash and
+    * displace: keys are put in buckets, and each bucket is given
+    * a seed that scatters its keys into free slots), which is
+    * slow-ish, so it's meant for tables that rarely change,
+    * like command aliases once they're all registered.
+    * @see Shell::freeze()
+    * @see ArgFilter::freeze()
+    */
+    class PerfectHash {
+    public:
+        /// Type of the values the keys map to
+        typedef std::size_t value_type;
+        /// Type of the entries to build from
+        typedef std::vector<std::pair<std::string, value_type>> entries_t;
+        /// Returned by @ref find(std::string_view key) const
+        /// if the key isn't in the table
+        static constexpr value_type NONE = ~static_cast<value_type>(0);
+    private:
+        /**
+        * A slot in the table.
+        */
+        struct slot {
+            /// The key, empty if the slot is
+            std::string key;
+            /// The value, @ref NONE if the slot is empty
+            value_type value;
+        };
+
+        /// The seed of each bucket
+        std::vector<std::uint32_t> seeds;
+        /// The slots, a power of two of them
+        std::vector<slot> slots;
+        /// Salt for the key hash, changed if
+        /// the keys can't be placed with the last one
+        std::uint64_t salt;
+        /// Number of keys
+        std::size_t count;
+
+        /**
+        * Hashes a key.
+        * @param [in] key The key
+        * @return The hash
+        */
+        std::uint64_t hash(std::string_view key) const;
+        /**
+        * Gets the slot of a key's hash.
+        * @param [in] h The hash of the key
+        * @return Index into @ref slots
+        */
+        std::size_t slotOf(std::uint64_t h) const;
+        /**
+        * Try to place every key with the current @ref salt.
+        * @param [in] entries The entries
+        * @param [in] slotCount Number of slots to use
+        * @return `true` if it worked, `false` if
+        * some bucket couldn't be placed
+        */
+        bool place(const entries_t &entries, std::size_t slotCount);
+    public:
+        /**
+        * Construct an empty table.
+        */
+        PerfectHash();
+
+        /**
+        * Replaces the contents of the table.
+        * @note If a key is given more than once, the first
+        * entry with it wins, and the rest are ignored
+        * @param [in] entries The keys and their values
+        */
+        void build(const entries_t &entries);
+        /**
+        * Looks up a key.
+        * @param [in] key The key
+        * @return The key's value, or @ref NONE
+        */
+        value_type find(std::string_view key) const;
+        /**
+        * Empties the table.
+        */
+        void clear();
+        /**
+        * Gets the number of keys.
+        * @return The number of keys
+        */
+        std::size_t size() const;
+    };
+}
+
+#endif
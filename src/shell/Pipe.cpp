@@ -0,0 +1,50 @@
+#include "Pipe.h"
+
+#include <algorithm>
+
+etm::Pipe::Pipe(std::size_t capacity):
+    capacity(std::max<std::size_t>(capacity, 1)),
+    closed(false),
+    abandoned(false)
+{
+}
+
+bool etm::Pipe::write(std::string_view text) {
+    std::unique_lock<std::mutex> guard(lock);
+    writable.wait(guard, [this]() -> bool {
+        return abandoned || chunks.size() < capacity;
+    });
+    if (abandoned) {
+        return false;
+    }
+    chunks.emplace_back(text);
+    readable.notify_one();
+    return true;
+}
+
+void etm::Pipe::close() {
+    std::lock_guard<std::mutex> guard(lock);
+    closed = true;
+    readable.notify_all();
+}
+
+bool etm::Pipe::read(std::string &out) {
+    std::unique_lock<std::mutex> guard(lock);
+    readable.wait(guard, [this]() -> bool {
+        return closed || !chunks.empty();
+    });
+    if (chunks.empty()) {
+        return false;
+    }
+    out.swap(chunks.front());
+    chunks.pop_front();
+    writable.notify_one();
+    return true;
+}
+
+void etm::Pipe::abandon() {
+    std::lock_guard<std::mutex> guard(lock);
+    abandoned = true;
+    chunks.clear();
+    writable.notify_all();
+}
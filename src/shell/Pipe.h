@@ -0,0 +1,74 @@
+#ifndef ETERMAL_PIPE_H_INCLUDED
+#define ETERMAL_PIPE_H_INCLUDED
+
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <string>
+#include <string_view>
+#include <cstddef>
+
+namespace etm {
+
+    /**
+    * A bounded queue of text between two pipeline stages,
+    * each on its own thread.
+    * Writing blocks while it's full, so a fast stage can't
+    * run too far ahead of a slow one, and reading blocks
+    * while it's empty.
+    * @see Shell
+    * @see Job
+    */
+    class Pipe {
+    public:
+        /// Default max number of chunks waiting to be read
+        static constexpr std::size_t DEFAULT_CAPACITY = 64;
+    private:
+        /// Guards everything
+        std::mutex lock;
+        /// Signalled when there's something to read, or it's closed
+        std::condition_variable readable;
+        /// Signalled when there's room to write, or it's abandoned
+        std::condition_variable writable;
+        /// Chunks written but not read
+        std::deque<std::string> chunks;
+        /// Max number of @ref chunks
+        std::size_t capacity;
+        /// Whether the writer is done
+        bool closed;
+        /// Whether the reader is done
+        bool abandoned;
+    public:
+        /**
+        * Construct an empty pipe.
+        * @param [in] capacity Max number of chunks waiting
+        * to be read, at least 1
+        */
+        Pipe(std::size_t capacity = DEFAULT_CAPACITY);
+
+        /**
+        * Writes a chunk, waiting for room if it's full.
+        * @param [in] text The chunk
+        * @return `false` if the reader is done, in which
+        * case it's dropped
+        */
+        bool write(std::string_view text);
+        /**
+        * Marks that nothing more will be written.
+        */
+        void close();
+        /**
+        * Reads the next chunk, waiting for one if it's empty.
+        * @param [out] out The chunk (replaced)
+        * @return `false` if it's closed and empty
+        */
+        bool read(std::string &out);
+        /**
+        * Marks that nothing more will be read, dropping
+        * anything waiting to be.
+        */
+        void abandon();
+    };
+}
+
+#endif
@@ -0,0 +1,140 @@
+#include "RadixTree.h"
+
+#include <algorithm>
+#include <utility>
+
+/**
+* Gets how many characters two strings share at the start.
+* @param [in] a A string
+* @param [in] b The other string
+* @return The length of the shared prefix
+*/
+static std::size_t sharedLength(std::string_view a, std::string_view b);
+
+std::size_t sharedLength(std::string_view a, std::string_view b) {
+    const std::size_t length = std::min(a.size(), b.size());
+    std::size_t i = 0;
+    for (; i < length && a[i] == b[i]; i++);
+    return i;
+}
+
+etm::RadixTree::node::node(std::string_view edge, bool terminal):
+    edge(edge), terminal(terminal) {
+}
+
+etm::RadixTree::RadixTree(): root(std::string_view(), false), count(0) {
+}
+
+std::size_t etm::RadixTree::findChild(const node &parent, char c) {
+    return std::lower_bound(parent.children.begin(), parent.children.end(), c, [](const node &n, char c) -> bool {
+        return n.edge[0] < c;
+    }) - parent.children.begin();
+}
+
+void etm::RadixTree::insert(std::string_view str) {
+    node *n = &root;
+    while (!str.empty()) {
+        const std::size_t i = findChild(*n, str[0]);
+        if (i == n->children.size() || n->children[i].edge[0] != str[0]) {
+            n->children.emplace(n->children.begin() + i, str, true);
+            count++;
+            return;
+        }
+        node *child = &n->children[i];
+        const std::size_t shared = sharedLength(child->edge, str);
+        if (shared < child->edge.size()) {
+            // Split the edge where they part ways
+            node tail(std::move(*child));
+            tail.edge.erase(0, shared);
+            *child = node(str.substr(0, shared), false);
+            child->children.push_back(std::move(tail));
+        }
+        n = child;
+        str.remove_prefix(shared);
+    }
+    if (!n->terminal) {
+        n->terminal = true;
+        count++;
+    }
+}
+
+bool etm::RadixTree::contains(std::string_view str) const {
+    const node *n = &root;
+    while (!str.empty()) {
+        const std::size_t i = findChild(*n, str[0]);
+        if (i == n->children.size()) {
+            return false;
+        }
+        const node &child = n->children[i];
+        if (str.compare(0, child.edge.size(), child.edge) != 0) {
+            return false;
+        }
+        n = &child;
+        str.remove_prefix(child.edge.size());
+    }
+    return n->terminal;
+}
+
+void etm::RadixTree::clear() {
+    root.children.clear();
+    root.terminal = false;
+    count = 0;
+}
+
+std::size_t etm::RadixTree::size() const {
+    return count;
+}
+
+void etm::RadixTree::collect(const node &n, std::string &path, std::vector<std::string> &out) {
+    if (n.terminal) {
+        out.push_back(path);
+    }
+    for (const node &child : n.children) {
+        path += child.edge;
+        collect(child, path, out);
+        path.resize(path.size() - child.edge.size());
+    }
+}
+
+void etm::RadixTree::complete(std::string_view prefix, std::vector<std::string> &out, std::size_t max) const {
+    out.clear();
+    // Find the node the prefix ends in
+    const node *n = &root;
+    std::string path;
+    std::string_view rest = prefix;
+    while (!rest.empty()) {
+        const std::size_t i = findChild(*n, rest[0]);
+        if (i == n->children.size()) {
+            return;
+        }
+        const node &child = n->children[i];
+        const std::size_t shared = sharedLength(child.edge, rest);
+        // The prefix has to run out, or the edge
+        if (shared < rest.size() && shared < child.edge.size()) {
+            return;
+        }
+        path += child.edge;
+        rest.remove_prefix(shared);
+        n = &child;
+    }
+    collect(*n, path, out);
+
+    // Children are sorted, so they're already in alphabetical order
+    std::stable_sort(out.begin(), out.end(), [](const std::string &a, const std::string &b) -> bool {
+        return a.size() < b.size();
+    });
+    if (max && out.size() > max) {
+        out.resize(max);
+    }
+}
+
+std::string etm::RadixTree::commonPrefix(const std::vector<std::string> &strings) {
+    if (strings.empty()) {
+        return std::string();
+    }
+    std::size_t length = strings[0].size();
+    for (const std::string &str : strings) {
+        length = std::min(length, sharedLength(strings[0], str));
+    }
+    return strings[0].substr(0, length);
+}
@@ -0,0 +1,104 @@
+#ifndef ETERMAL_RADIXTREE_H_INCLUDED
+#define ETERMAL_RADIXTREE_H_INCLUDED
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstddef>
+
+namespace etm {
+
+    /**
+    * A set of strings as a compressed trie (radix tree), where
+    * each edge holds as many characters as it can.
+    * Used for completion - finding every string that starts with
+    * some prefix only looks at the prefix, and then the strings found.
+    * @see Shell::getCompletions()
+    */
+    class RadixTree {
+        /**
+        * A node in the tree.
+        */
+        struct node {
+            /// The characters leading to this node from its parent
+            std::string edge;
+            /// Whether a string ends here
+            bool terminal;
+            /// Child nodes, sorted by the first
+            /// character of their edge
+            std::vector<node> children;
+            /**
+            * Construct a node.
+            * @param [in] edge The characters leading to it
+            * @param [in] terminal Whether a string ends here
+            */
+            node(std::string_view edge, bool terminal);
+        };
+
+        /// The root, its edge is empty
+        node root;
+        /// Number of strings
+        std::size_t count;
+
+        /**
+        * Finds the child whose edge starts with a character.
+        * @param [in] parent The node to look in
+        * @param [in] c The character
+        * @return Index of the child, or where it would go
+        * if there isn't one
+        */
+        static std::size_t findChild(const node &parent, char c);
+        /**
+        * Adds every string under a node.
+        * @param [in] n The node
+        * @param [in,out] path The string up to and including `n`,
+        * restored when done
+        * @param [out] out Where to add the strings
+        */
+        static void collect(const node &n, std::string &path, std::vector<std::string> &out);
+    public:
+        /**
+        * Construct an empty tree.
+        */
+        RadixTree();
+
+        /**
+        * Adds a string, if it's not already there.
+        * @param [in] str The string
+        */
+        void insert(std::string_view str);
+        /**
+        * Check if a string is in the tree.
+        * @param [in] str The string
+        * @return `true` if it is
+        */
+        bool contains(std::string_view str) const;
+        /**
+        * Removes all strings.
+        */
+        void clear();
+        /**
+        * Gets the number of strings.
+        * @return The number of strings
+        */
+        std::size_t size() const;
+
+        /**
+        * Finds the strings that start with a prefix.
+        * They're ranked shortest first, then alphabetically.
+        * @param [in] prefix The prefix
+        * @param [out] out Where to put the strings (replaced)
+        * @param [in] max Most strings to give, 0 for no limit
+        */
+        void complete(std::string_view prefix, std::vector<std::string> &out, std::size_t max = 0) const;
+        /**
+        * Gets the longest prefix that a list of strings share,
+        * ex. how far completion can go without choosing.
+        * @param [in] strings The strings
+        * @return The prefix
+        */
+        static std::string commonPrefix(const std::vector<std::string> &strings);
+    };
+}
+
+#endif
@@ -0,0 +1,518 @@
+#ifndef ETERMAL_SCHEMA_H_INCLUDED
+#define ETERMAL_SCHEMA_H_INCLUDED
+
+#include <algorithm>
+#include <charconv>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+#include <cstddef>
+
+#include "ArgFilter.h"
+#include "data/data.h"
+
+namespace etm {
+
+    /**
+    * A string built at compile time, ex. a @ref Schema's usage.
+    * @tparam N The capacity
+    */
+    template<std::size_t N>
+    struct FixedString {
+        /// The characters, not null terminated
+        char data[N] = {};
+        /// Number of characters in @ref data
+        std::size_t length = 0;
+
+        /**
+        * Appends a string.
+        * @param [in] str The string
+        * @throw std::out_of_range If it doesn't fit (which
+        * won't compile, if done at compile time)
+        */
+        constexpr void append(std::string_view str);
+        /**
+        * Views the string.
+        * @return The view
+        */
+        constexpr std::string_view view() const;
+    };
+
+    /**
+    * A flag of a @ref Schema, and the field its value goes in.
+    * @see option()
+    * @tparam T The struct
+    * @tparam V The type of the field - `bool` (set if the flag is given),
+    * any integer, `float`, `std::string_view` (views the argument) or `std::string`
+    */
+    template<class T, class V>
+    struct SchemaOption {
+        static_assert(
+            std::is_integral_v<V> || std::is_same_v<V, float> ||
+            std::is_same_v<V, std::string_view> || std::is_same_v<V, std::string>,
+            "Schema fields must be bool, integers, float, std::string_view or std::string"
+        );
+        /// The type of the field
+        typedef V value_type;
+        /// The name, ex. `-n`
+        std::string_view name;
+        /// Another name, ex. `--count`, or empty
+        std::string_view alias;
+        /// The field
+        V T::*field;
+
+        /**
+        * Gets the closest @ref ArgFilter type, for error
+        * messages and @ref Schema::toFilter().
+        * @return The type
+        */
+        static constexpr ArgFilter::datatype datatype();
+        /**
+        * Gets the name of the type, as shown in the usage.
+        * Same as @ref ArgFilter::datatypeToString(), but at compile time.
+        * @return The name
+        */
+        static constexpr std::string_view typeName();
+        /**
+        * Check if it's one of this option's names.
+        * @param [in] flag The flag, including the dash(es)
+        * @return `true` if it is
+        */
+        constexpr bool matches(std::string_view flag) const;
+        /**
+        * Parses a value into the field.
+        * @param [in] text The value
+        * @param [out] out The struct
+        * @return `false` if it couldn't be parsed
+        */
+        bool parse(std::string_view text, T &out) const;
+        /**
+        * Appends the option to a usage string, ex. ` [-n|--count int]`.
+        * @param [in,out] out The usage
+        * @tparam S A @ref FixedString, or `std::string`
+        */
+        template<class S>
+        constexpr void describe(S &out) const;
+        /**
+        * Adds the option to a filter.
+        * @param [in,out] filter The filter
+        */
+        void addTo(ArgFilter &filter) const;
+    };
+
+    /**
+    * Where a @ref Schema puts arguments that aren't flags
+    * (array args), and how many there can be.
+    * @see rest()
+    * @tparam T The struct
+    */
+    template<class T>
+    struct SchemaRest {
+        /// What they're called in the usage, ex. `file`
+        std::string_view name;
+        /// Most that can be given
+        unsigned int max;
+        /// The field
+        std::vector<std::string_view> T::*field;
+
+        /**
+        * Appends the args to a usage string, ex. ` [file...]`.
+        * @param [in,out] out The usage
+        * @tparam S A @ref FixedString, or `std::string`
+        */
+        template<class S>
+        constexpr void describe(S &out) const;
+    };
+
+    /**
+    * The flags of a command, declared as the fields of a struct,
+    * at compile time. Rather than an @ref ArgFilter filling an
+    * @ref Args with values whose types are checked as it goes, the
+    * values are parsed straight into the struct, as the types of
+    * the fields say - no lookups by name, no type switches and no
+    * exceptions. Fields that aren't given keep their defaults.
+    * @code
+    * struct countArgs {
+    *     int count = 10;
+    *     bool verbose = false;
+    *     std::vector<std::string_view> files;
+    * };
+    * constexpr auto countSchema = etm::makeSchema(
+    *     etm::option("-n", "--count", &countArgs::count),
+    *     etm::option("-v", &countArgs::verbose),
+    *     etm::rest("file", 4, &countArgs::files)
+    * );
+    * // "Usage: count [-n|--count int] [-v] [file...]\n", at compile time
+    * constexpr auto countUsage = countSchema.usage("count");
+    * @endcode
+    * @see Shell::addCommand(const std::string &name, const Schema<T, Fields...> &schema, F callback)
+    * @tparam T The struct
+    * @tparam Fields @ref SchemaOption "SchemaOptions" and at most one @ref SchemaRest
+    */
+    template<class T, class... Fields>
+    class Schema {
+    public:
+        /// The struct that's parsed into
+        typedef T value_type;
+        /// Default capacity of @ref usage()
+        static constexpr std::size_t USAGE_CAPACITY = 256;
+    private:
+        /// The fields
+        std::tuple<Fields...> fields;
+    public:
+        /**
+        * Construct a schema.
+        * @param [in] fields The fields
+        * @see makeSchema()
+        */
+        constexpr Schema(const Fields&... fields);
+
+        /**
+        * Parses arguments into a struct, as @ref ArgFilter::filter()
+        * would, reporting errors through an error handle.
+        * Nothing is allocated unless there's an error, array args
+        * are given, or there are `std::string` fields.
+        * @note Assumes that `arguments.size() > 0`
+        * @note `std::string_view` fields view the arguments, so they
+        * must outlive `out`
+        * @param [in] arguments The arguments split up into parts
+        * @param [out] out The struct (only given fields are set)
+        * @param [out] errMsg String to dump error messages
+        * @param [in] handle The error handle
+        * @return `true` if encountered an error
+        */
+        bool parse(const std::vector<std::string_view> &arguments, T &out, std::string &errMsg, ArgFilter::ErrorHandle &handle) const;
+        /**
+        * Generates the command usage, ex. for
+        * @ref ArgFilter::setUsage(const std::string &usage).
+        * Can be done at compile time.
+        * @param [in] name The command
+        * @return The usage
+        * @throw std::out_of_range If it's longer than `N`
+        * @tparam N The capacity of the usage
+        */
+        template<std::size_t N = USAGE_CAPACITY>
+        constexpr FixedString<N> usage(std::string_view name) const;
+        /**
+        * Generates the command usage at runtime, which,
+        * unlike @ref usage(std::string_view name) const,
+        * can be as long as it needs to be.
+        * @param [in] name The command
+        * @param [out] out The usage (replaced)
+        */
+        void usage(std::string_view name, std::string &out) const;
+        /**
+        * Makes an @ref ArgFilter with the same flags and usage,
+        * for code that works with those.
+        * @param [in] name The command, for the usage
+        * @param [in] handle The error handle of the filter
+        * @return The filter
+        */
+        ArgFilter toFilter(std::string_view name, ArgFilter::ErrorHandle &handle = ArgFilter::getDefaultErrorHandle()) const;
+    };
+
+    /**
+    * Declares a flag of a @ref Schema.
+    * @param [in] name The flag, including the dash(es)
+    * @param [in] field The field its value goes in
+    * @return The option
+    */
+    template<class T, class V>
+    constexpr SchemaOption<T, V> option(std::string_view name, V T::*field);
+    /**
+    * Declares a flag of a @ref Schema, with two names.
+    * @param [in] name The flag, including the dash(es)
+    * @param [in] alias Another name for it
+    * @param [in] field The field its value goes in
+    * @return The option
+    */
+    template<class T, class V>
+    constexpr SchemaOption<T, V> option(std::string_view name, std::string_view alias, V T::*field);
+    /**
+    * Declares where a @ref Schema puts array args.
+    * Without this, there can't be any.
+    * @param [in] name What they're called in the usage
+    * @param [in] max Most that can be given
+    * @param [in] field The field
+    * @return The args
+    */
+    template<class T>
+    constexpr SchemaRest<T> rest(std::string_view name, unsigned int max, std::vector<std::string_view> T::*field);
+    /**
+    * Makes a @ref Schema, working out the types.
+    * @param [in] fields The fields
+    * @return The schema
+    */
+    template<class T, class V, class... Fields>
+    constexpr Schema<T, SchemaOption<T, V>, Fields...> makeSchema(const SchemaOption<T, V> &first, const Fields&... fields);
+    /**
+    * Makes a @ref Schema, working out the types.
+    * @param [in] fields The fields
+    * @return The schema
+    */
+    template<class T, class... Fields>
+    constexpr Schema<T, SchemaRest<T>, Fields...> makeSchema(const SchemaRest<T> &first, const Fields&... fields);
+}
+
+// FixedString
+
+template<std::size_t N>
+constexpr void etm::FixedString<N>::append(std::string_view str) {
+    if (str.size() > N - length) {
+        throw std::out_of_range("FixedString::append: Out of room");
+    }
+    for (char c : str) {
+        data[length++] = c;
+    }
+}
+template<std::size_t N>
+constexpr std::string_view etm::FixedString<N>::view() const {
+    return std::string_view(data, length);
+}
+
+// SchemaOption
+
+template<class T, class V>
+constexpr etm::ArgFilter::datatype etm::SchemaOption<T, V>::datatype() {
+    if constexpr (std::is_same_v<V, bool>) {
+        return ArgFilter::BOOL;
+    } else if constexpr (std::is_integral_v<V>) {
+        return ArgFilter::INT;
+    } else if constexpr (std::is_same_v<V, float>) {
+        return ArgFilter::FLOAT;
+    } else {
+        return ArgFilter::STRING;
+    }
+}
+template<class T, class V>
+constexpr std::string_view etm::SchemaOption<T, V>::typeName() {
+    switch (datatype()) {
+        case ArgFilter::INT: return "int";
+        case ArgFilter::FLOAT: return "float";
+        case ArgFilter::BOOL: return "bool";
+        default: return "string";
+    }
+}
+template<class T, class V>
+constexpr bool etm::SchemaOption<T, V>::matches(std::string_view flag) const {
+    return flag == name || (!alias.empty() && flag == alias);
+}
+template<class T, class V>
+bool etm::SchemaOption<T, V>::parse(std::string_view text, T &out) const {
+    V &value = out.*field;
+    // Numbers have to be the whole thing
+    if constexpr (std::is_same_v<V, std::string_view>) {
+        value = text;
+    } else if constexpr (std::is_same_v<V, std::string>) {
+        value.assign(text);
+    } else if constexpr (std::is_same_v<V, float>) {
+        return data::parseFloat(text, value, true);
+    } else {
+        const char *first = text.data();
+        const char *last = text.data() + text.size();
+        // A plus is fine, but not a minus after it
+        if (first + 1 < last && *first == '+' && first[1] != '-') {
+            first++;
+        }
+        const std::from_chars_result result = std::from_chars(first, last, value);
+        return result.ec == std::errc() && result.ptr == last;
+    }
+    return true;
+}
+template<class T, class V>
+template<class S>
+constexpr void etm::SchemaOption<T, V>::describe(S &out) const {
+    out.append(" [");
+    out.append(name);
+    if (!alias.empty()) {
+        out.append("|");
+        out.append(alias);
+    }
+    if constexpr (!std::is_same_v<V, bool>) {
+        out.append(" ");
+        out.append(typeName());
+    }
+    out.append("]");
+}
+template<class T, class V>
+void etm::SchemaOption<T, V>::addTo(ArgFilter &filter) const {
+    // Named for the long flag, without the dashes
+    std::string_view longest = alias.size() > name.size() ? alias : name;
+    longest.remove_prefix(std::min(longest.find_first_not_of('-'), longest.size()));
+    filter.addFilter(std::string(longest), datatype(), false);
+    // The filter adds a dash of its own
+    filter.addAlias(std::string(name.substr(name.empty() ? 0 : 1)));
+    if (!alias.empty()) {
+        filter.addAlias(std::string(alias.substr(1)));
+    }
+}
+
+// SchemaRest
+
+template<class T>
+template<class S>
+constexpr void etm::SchemaRest<T>::describe(S &out) const {
+    out.append(" [");
+    out.append(name);
+    out.append("...]");
+}
+
+// Schema
+
+template<class T, class... Fields>
+constexpr etm::Schema<T, Fields...>::Schema(const Fields&... fields): fields(fields...) {
+    static_assert(
+        (std::is_same_v<Fields, SchemaRest<T>> + ... + 0) <= 1,
+        "A schema can only have one place for array args"
+    );
+}
+
+template<class T, class... Fields>
+bool etm::Schema<T, Fields...>::parse(const std::vector<std::string_view> &arguments, T &out, std::string &errMsg, ArgFilter::ErrorHandle &handle) const {
+    typedef std::vector<std::string_view>::size_type size;
+
+    // Was an error set?
+    bool failed = false;
+
+    for (size i = 1; i < arguments.size(); i++) {
+        bool loopError = false;
+        if (!arguments[i].empty() && arguments[i][0] == '-') {
+            // Is flag, try each option in turn - the
+            // compiler unrolls it, so it's just compares
+            bool found = false;
+            std::apply([&](const Fields&... f) -> void {
+                ([&](const auto &field) -> bool {
+                    if constexpr (std::is_same_v<std::decay_t<decltype(field)>, SchemaRest<T>>) {
+                        return false;
+                    } else {
+                        typedef typename std::decay_t<decltype(field)>::value_type value_t;
+                        if (!field.matches(arguments[i])) {
+                            return false;
+                        }
+                        found = true;
+                        if constexpr (std::is_same_v<value_t, bool>) {
+                            // The presence of the flag sets it to `true`
+                            out.*field.field = true;
+                        } else if (i + 1 < arguments.size()) {
+                            i++;
+                            if (!field.parse(arguments[i], out)) {
+                                loopError = true;
+                                errMsg += handle.badDatatype(i, std::string(arguments[i]), field.datatype());
+                            }
+                        } else {
+                            loopError = true;
+                            errMsg += handle.noParam(i + 1, std::string(arguments[i]), field.datatype());
+                        }
+                        return true;
+                    }
+                }(f) || ...);
+            }, fields);
+            if (!found) {
+                // The flag doesn't exist
+                loopError = true;
+                errMsg += handle.badFlag(i, std::string(arguments[i]));
+            }
+        } else {
+            // Is array param
+            bool taken = false;
+            unsigned int max = 0;
+            std::apply([&](const Fields&... f) -> void {
+                ([&](const auto &field) -> void {
+                    if constexpr (std::is_same_v<std::decay_t<decltype(field)>, SchemaRest<T>>) {
+                        std::vector<std::string_view> &args = out.*field.field;
+                        max = field.max;
+                        if (args.size() < max) {
+                            args.push_back(arguments[i]);
+                            taken = true;
+                        }
+                    }
+                }(f), ...);
+            }, fields);
+            if (!taken) {
+                // Too many args
+                loopError = true;
+                errMsg += handle.tooManyArgs(i, max);
+            }
+        }
+
+        if (loopError) {
+            // Only stop and exit now if failfast is true
+            if (handle.doFailfast()) {
+                return true;
+            }
+            failed = true;
+        }
+    }
+
+    return failed;
+}
+
+template<class T, class... Fields>
+template<std::size_t N>
+constexpr etm::FixedString<N> etm::Schema<T, Fields...>::usage(std::string_view name) const {
+    FixedString<N> result;
+    result.append("Usage: ");
+    result.append(name);
+    std::apply([&result](const Fields&... f) -> void {
+        (f.describe(result), ...);
+    }, fields);
+    result.append("\n");
+    return result;
+}
+template<class T, class... Fields>
+void etm::Schema<T, Fields...>::usage(std::string_view name, std::string &out) const {
+    out.assign("Usage: ");
+    out.append(name);
+    std::apply([&out](const Fields&... f) -> void {
+        (f.describe(out), ...);
+    }, fields);
+    out.push_back('\n');
+}
+
+template<class T, class... Fields>
+etm::ArgFilter etm::Schema<T, Fields...>::toFilter(std::string_view name, ArgFilter::ErrorHandle &handle) const {
+    ArgFilter filter(handle);
+    unsigned int max = 0;
+    std::apply([&](const Fields&... f) -> void {
+        ([&](const auto &field) -> void {
+            if constexpr (std::is_same_v<std::decay_t<decltype(field)>, SchemaRest<T>>) {
+                max = field.max;
+            } else {
+                field.addTo(filter);
+            }
+        }(f), ...);
+    }, fields);
+    filter.setMaxArrayArgs(max);
+    std::string text;
+    usage(name, text);
+    filter.setUsage(text);
+    return filter;
+}
+
+// Factories
+
+template<class T, class V>
+constexpr etm::SchemaOption<T, V> etm::option(std::string_view name, V T::*field) {
+    return SchemaOption<T, V>{name, std::string_view(), field};
+}
+template<class T, class V>
+constexpr etm::SchemaOption<T, V> etm::option(std::string_view name, std::string_view alias, V T::*field) {
+    return SchemaOption<T, V>{name, alias, field};
+}
+template<class T>
+constexpr etm::SchemaRest<T> etm::rest(std::string_view name, unsigned int max, std::vector<std::string_view> T::*field) {
+    return SchemaRest<T>{name, max, field};
+}
+template<class T, class V, class... Fields>
+constexpr etm::Schema<T, etm::SchemaOption<T, V>, Fields...> etm::makeSchema(const SchemaOption<T, V> &first, const Fields&... fields) {
+    return Schema<T, SchemaOption<T, V>, Fields...>(first, fields...);
+}
+template<class T, class... Fields>
+constexpr etm::Schema<T, etm::SchemaRest<T>, Fields...> etm::makeSchema(const SchemaRest<T> &first, const Fields&... fields) {
+    return Schema<T, SchemaRest<T>, Fields...>(first, fields...);
+}
+
+#endif
@@ -1,21 +1,36 @@
 #include "Shell.h"
 
 #include <iostream>
+#include <istream>
 #include <utility>
+#include <algorithm>
 
 #include "../ETerminal.h"
+#include "../terminal/util/ThreadPool.h"
+#include "../terminal/InputBuffer.h"
 #include "shellError.h"
+#include "completion.h"
 
-static void makeLowercase(std::string &str);
+static void makeLowercase(char *begin, char *end);
 static void defaultErrorCallback(const etm::shellError &error);
 static std::string defaultNoCommandCallback(const std::string &command);
 
-static constexpr unsigned int MAX_COMMAND_HISTORY = 10;
+/**
+* Splits a pipeline (`a | b > name`) into its stages.
+* Anything in quotes is left alone.
+* @param [in] commandString The command
+* @param [out] stages The stages (appended to)
+* @param [out] target The buffer that output is redirected
+* to, or empty if it isn't
+* @param [out] append Whether it's appended to the buffer (`>>`)
+* @return `false` if it's malformed (ex. a stage is blank)
+*/
+static bool splitPipeline(std::string_view commandString, std::vector<std::string_view> &stages, std::string_view &target, bool &append);
 
-void makeLowercase(std::string &str) {
-    for (char &c : str) {
-        if ('A' <= c && c <= 'Z') {
-            c |= 0x20;
+void makeLowercase(char *begin, char *end) {
+    for (; begin < end; begin++) {
+        if ('A' <= *begin && *begin <= 'Z') {
+            *begin |= 0x20;
         }
     }
 }
@@ -34,25 +49,81 @@ std::string defaultNoCommandCallback(const std::string &command) {
     return "\e[fd13400;Error\e[F: Command not found: " + command + "\n";
 }
 
+bool splitPipeline(std::string_view commandString, std::vector<std::string_view> &stages, std::string_view &target, bool &append) {
+    std::string_view::size_type start = 0;
+    bool inString = false;
+    std::string_view::size_type i = 0;
+    for (; i < commandString.size(); i++) {
+        const char c = commandString[i];
+        if (c == '\"') {
+            inString = !inString;
+        } else if (!inString && (c == '|' || c == '>')) {
+            stages.push_back(commandString.substr(start, i - start));
+            start = i + 1;
+            if (c == '>') {
+                break;
+            }
+        }
+    }
+    if (i < commandString.size()) {
+        // Everything after the `>` is the name
+        append = start < commandString.size() && commandString[start] == '>';
+        target = commandString.substr(start + append);
+        const std::string_view::size_type first = target.find_first_not_of(' ');
+        if (first == std::string_view::npos) {
+            return false;
+        }
+        target = target.substr(first, target.find_last_not_of(' ') + 1 - first);
+        if (target.find_first_of(" |>\"") != std::string_view::npos) {
+            return false;
+        }
+    } else {
+        target = std::string_view();
+        append = false;
+        stages.push_back(commandString.substr(start));
+    }
+    for (std::string_view stage : stages) {
+        if (stage.find_first_not_of(' ') == std::string_view::npos) {
+            return false;
+        }
+    }
+    return true;
+}
+
 etm::Shell::Command::Command() {
 }
 etm::Shell::Command::Command(const ArgFilter &filter, const callback_t &callback):
     filter(filter), callback(callback) {
 }
+etm::Shell::Command::Command(const ArgFilter &filter, const jobCallback_t &job):
+    filter(filter), job(job) {
+}
+etm::Shell::Command::Command(const ArgFilter &filter, const parsedCallback_t &parsed):
+    filter(filter), parsed(parsed) {
+}
 
 etm::Shell::Shell(): Shell(defaultErrorCallback) {
 }
 etm::Shell::Shell(const errCallback_t &callback):
     terminal(nullptr),
+    frozen(false),
     flags(flag::none),
     prompt("\nuser@terminal ~\n$ "),
     commandId(0),
-    seekI(0)
+    seekI(History::NONE),
+    depth(0),
+    scripting(false)
 {
-    commandHistory.reserve(MAX_COMMAND_HISTORY);
     setErrorCallback(callback);
     setNoCommandCallback(defaultNoCommandCallback);
 }
+etm::Shell::~Shell() {
+    for (std::shared_ptr<task> &stage : jobs) {
+        stage->job.cancel();
+    }
+    // Waits for the jobs
+    pool.reset();
+}
 
 void etm::Shell::setErrorCallback(const errCallback_t &callback) {
     if (callback) {
@@ -102,62 +173,341 @@ void etm::Shell::input(const std::string &commandString) {
         return;
     }
 
+    if (!jobs.empty()) {
+        postError(
+            "Shell::input(const std::string&)",
+            "A command is running in the background, the input \"" + commandString + "\" is ignored",
+            false
+        );
+        return;
+    }
+
+    terminal->setTakeInput(false);
+
+    const outcome result = dispatch(commandString);
+    if (result != BLANK) {
+        history.add(commandString);
+        seekI = history.end();
+    }
+
+    // The prompt comes back when it's done
+    if (result == STARTED) {
+        terminal->flush();
+        return;
+    }
+
+    // Does flushing for us
+    prepTerminal();
+}
+
+std::size_t etm::Shell::runScript(std::istream &stream, unsigned int flushInterval) {
+    if (terminal == nullptr) {
+        postError(
+            "Shell::runScript(std::istream&,unsigned int)",
+            "Cannot run script, terminal is nullptr (not set)",
+            false
+        );
+        return 0;
+    }
+
     terminal->setTakeInput(false);
 
-    std::vector<std::string> params;
+    // Might be called from a command
+    const bool wasScripting = scripting;
+    scripting = true;
+
+    std::size_t count = 0;
+    std::string line;
+    while (std::getline(stream, line)) {
+        // Scripts written on Windows
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        const std::string::size_type start = line.find_first_not_of(' ');
+        if (start == std::string::npos || line[start] == '#') {
+            continue;
+        }
+        const outcome result = dispatch(line);
+        count++;
+        if (result == ABORTED) {
+            break;
+        }
+        if (flushInterval && count % flushInterval == 0) {
+            terminal->flush();
+        }
+    }
+
+    scripting = wasScripting;
+
+    if (wasScripting || depth) {
+        // Whatever called it brings the prompt back
+        terminal->flush();
+    } else {
+        // Does flushing for us
+        prepTerminal();
+    }
+    return count;
+}
+
+etm::Shell::outcome etm::Shell::dispatch(const std::string &commandString) {
+    // Commands can run commands, so each
+    // level gets its own scratch space
+    if (depth == parses.size()) {
+        parses.emplace_back();
+    }
+    parse &current = parses[depth];
+
+    // Most commands aren't pipelines, so don't bother splitting them
+    if (commandString.find_first_of("|>") != std::string::npos) {
+        std::vector<std::string_view> stages;
+        std::string_view target;
+        bool append;
+        const bool wellFormed = splitPipeline(commandString, stages, target, append);
+        // Only background commands can be piped, so for any other
+        // command, the `|` and `>` are just part of its arguments
+        if (stages.size() && isJob(stages[0], current)) {
+            if (!wellFormed) {
+                terminal->dispText("\e[fd13400;Error\e[F: Malformed pipeline: " + commandString + "\n");
+                return ArgFilter::getDefaultErrorHandle().doFailfast() ? ABORTED : FAILED;
+            }
+            // It might have been quoted
+            if (stages.size() > 1 || !target.empty()) {
+                return pipeline(stages, target, append);
+            }
+        }
+    }
+
+    tokenize(commandString, current);
+    const std::vector<std::string_view> &params = current.tokens;
+    if (!params.size()) {
+        return BLANK;
+    }
+    if (flagSet(flag::nocase)) {
+        // The first token is at the start of the text
+        makeLowercase(&current.text[0], &current.text[0] + params[0].size());
+    }
+
+    outcome result = RAN;
+    depth++;
+    // Check the command exists
+    Command *found = findCommand(params[0]);
+    if (found != nullptr && found->parsed) {
+        // It parses its own arguments (it has a schema)
+        ArgFilter::ErrorHandle &handle = found->filter.getErrorHandle();
+        if (found->parsed(*this, *terminal, params, handle)) {
+            result = handle.doFailfast() ? ABORTED : FAILED;
+        }
+    } else if (found != nullptr) {
+        Command &com = *found;
+        // A background command outlives this call, so
+        // it needs scratch space of its own
+        std::shared_ptr<task> background;
+        if (com.job && !scripting && depth == 1) {
+            background = std::make_shared<task>();
+            tokenize(commandString, background->scratch);
+        }
+        parse &scratch = background ? background->scratch : current;
+        if (background) {
+            background->filter = com.filter;
+        }
+        ArgFilter &filter = background ? background->filter : com.filter;
+        // Parse the commands
+        std::string error;
+        const bool failed = filter.filter(scratch.tokens, scratch.args, error);
+        bool run = true;
+        if (failed) {
+            terminal->dispText(error);
+            terminal->dispText(com.filter.getUsage());
+            ArgFilter::ErrorHandle &handle = com.filter.getErrorHandle();
+            result = handle.doFailfast() ? ABORTED : FAILED;
+            run = !handle.doFail();
+            if (run) {
+                terminal->flush();
+            }
+        }
+        if (run && background) {
+            background->callback = com.job;
+            jobs.assign(1, background);
+            redirect.clear();
+            launch(getPool(1), jobs);
+            result = STARTED;
+        } else if (run && com.job) {
+            // Run it here and now
+            Job now;
+            com.job(now, scratch.args);
+            if (now.take(jobOutput)) {
+                terminal->dispText(jobOutput);
+            }
+        } else if (run) {
+            com.callback(*this, *terminal, scratch.args);
+        }
+    } else {
+        terminal->dispText(noCommandCallback(std::string(params[0])));
+        result = ArgFilter::getDefaultErrorHandle().doFailfast() ? ABORTED : FAILED;
+    }
+    depth--;
+
+    return result;
+}
+
+bool etm::Shell::isJob(std::string_view commandString, parse &scratch) {
+    tokenize(commandString, scratch);
+    if (scratch.tokens.empty()) {
+        return false;
+    }
+    if (flagSet(flag::nocase)) {
+        makeLowercase(&scratch.text[0], &scratch.text[0] + scratch.tokens[0].size());
+    }
+    Command *found = findCommand(scratch.tokens[0]);
+    return found != nullptr && found->job;
+}
+
+etm::Shell::outcome etm::Shell::pipeline(const std::vector<std::string_view> &stages, std::string_view target, bool append) {
+    outcome result = RAN;
+    // Each stage outlives this call if it's run in
+    // the background, so they get scratch space of their own
+    std::vector<std::shared_ptr<task>> tasks;
+    tasks.reserve(stages.size());
+    for (std::string_view stage : stages) {
+        std::shared_ptr<task> current = std::make_shared<task>();
+        parse &scratch = current->scratch;
+        // Stages aren't blank, so there's at least one token
+        tokenize(stage, scratch);
+        if (flagSet(flag::nocase)) {
+            makeLowercase(&scratch.text[0], &scratch.text[0] + scratch.tokens[0].size());
+        }
+        Command *found = findCommand(scratch.tokens[0]);
+        if (found == nullptr) {
+            terminal->dispText(noCommandCallback(std::string(scratch.tokens[0])));
+            return ArgFilter::getDefaultErrorHandle().doFailfast() ? ABORTED : FAILED;
+        }
+        if (!found->job) {
+            terminal->dispText(
+                "\e[fd13400;Error\e[F: Only background commands can be piped or redirected: " +
+                std::string(scratch.tokens[0]) + "\n"
+            );
+            return ArgFilter::getDefaultErrorHandle().doFailfast() ? ABORTED : FAILED;
+        }
+        current->filter = found->filter;
+        std::string error;
+        if (current->filter.filter(scratch.tokens, scratch.args, error)) {
+            terminal->dispText(error);
+            terminal->dispText(found->filter.getUsage());
+            ArgFilter::ErrorHandle &handle = found->filter.getErrorHandle();
+            result = handle.doFailfast() ? ABORTED : FAILED;
+            // Nothing runs unless every stage can
+            if (handle.doFail()) {
+                return result;
+            }
+        }
+        current->callback = found->job;
+        tasks.push_back(std::move(current));
+    }
+
+    // Connect each stage to the next
+    std::shared_ptr<Pipe> input;
+    for (std::size_t i = 0; i < tasks.size(); i++) {
+        std::shared_ptr<Pipe> output;
+        if (i + 1 < tasks.size()) {
+            output = std::make_shared<Pipe>();
+        }
+        tasks[i]->job.connect(input, output);
+        input = std::move(output);
+    }
+
+    std::string name(target);
+    if (!name.empty() && !append) {
+        buffers[name].clear();
+    }
+
+    if (!scripting && depth == 0) {
+        // The prompt comes back when they're all done
+        jobs = std::move(tasks);
+        redirect = std::move(name);
+        launch(getPool(jobs.size()), jobs);
+        return STARTED;
+    }
+
+    // The pool can't be remade while it's in use
+    std::unique_ptr<ThreadPool> local;
+    ThreadPool *runner;
+    if (jobs.empty()) {
+        runner = &getPool(tasks.size());
+    } else {
+        local = std::make_unique<ThreadPool>(tasks.size());
+        runner = local.get();
+    }
+    launch(*runner, tasks);
+    for (std::shared_ptr<task> &stage : tasks) {
+        stage->job.wait();
+    }
+    collect(tasks.back()->job, name);
+    return result;
+}
+
+etm::ThreadPool &etm::Shell::getPool(std::size_t workers) {
+    // Stages wait on each other, so each needs a worker of its own
+    if (!pool || pool->size() < workers) {
+        pool = std::make_unique<ThreadPool>(workers);
+    }
+    return *pool;
+}
+
+void etm::Shell::launch(ThreadPool &runner, const std::vector<std::shared_ptr<task>> &stages) {
+    for (const std::shared_ptr<task> &stage : stages) {
+        runner.submit([stage](std::size_t) -> void {
+            try {
+                stage->callback(stage->job, stage->scratch.args);
+            } catch (std::exception &e) {
+                stage->job.write(std::string("\nError: ") + e.what() + "\n");
+            }
+            stage->job.finish();
+        });
+    }
+}
+
+bool etm::Shell::collect(Job &job, const std::string &target) {
+    if (!job.take(jobOutput)) {
+        return false;
+    }
+    if (!target.empty()) {
+        // Never goes near the terminal
+        buffers[target] += jobOutput;
+        return false;
+    }
+    terminal->dispText(jobOutput);
+    return true;
+}
+
+void etm::Shell::tokenize(std::string_view commandString, parse &out) {
+    out.text.clear();
+    out.tokens.clear();
+    // The text never gets longer than the command,
+    // so the views won't be invalidated
+    out.text.reserve(commandString.size());
+    std::string::size_type start = 0;
     // If bypassing whitespace
     bool waiting = true;
     bool inString = false;
     for (char c : commandString) {
         if (c != ' ' || inString) {
             if (waiting) {
-                params.emplace_back();
+                start = out.text.size();
                 waiting = false;
             }
             if (c == '\"') {
                 inString = !inString;
             } else {
-                params.back().push_back(c);
+                out.text.push_back(c);
             }
-        } else {
+        } else if (!waiting) {
+            out.tokens.emplace_back(out.text.data() + start, out.text.size() - start);
             waiting = true;
         }
     }
-    if (params.size()) {
-        if (flagSet(flag::nocase)) {
-            makeLowercase(params[0]);
-        }
-        // Check the command exists
-        aliasMap_t::iterator loc = aliasMap.find(params[0]);
-        if (loc != aliasMap.end()) {
-            Command &com = commands[loc->second];
-            // Parse the commands
-            Args args;
-            std::string error;
-            const bool failed = com.filter.filter(params, args, error);
-            if (failed) {
-                terminal->dispText(error);
-                terminal->dispText(com.filter.getUsage());
-                if (!com.filter.getErrorHandle().doFail()) {
-                    terminal->flush();
-                    com.callback(*this, *terminal, args);
-                }
-            } else {
-                com.callback(*this, *terminal, args);
-            }
-        } else {
-            terminal->dispText(noCommandCallback(params[0]));
-        }
-
-        if (commandHistory.size() >= MAX_COMMAND_HISTORY) {
-            commandHistory.erase(commandHistory.begin(), commandHistory.begin() + (commandHistory.size() - MAX_COMMAND_HISTORY + 1));
-        }
-        commandHistory.push_back(commandString);
-        seekI = commandHistory.size();
+    if (!waiting) {
+        out.tokens.emplace_back(out.text.data() + start, out.text.size() - start);
     }
-
-    // Does flushing for us
-    prepTerminal();
 }
 
 void etm::Shell::setInput(const std::string &str) {
@@ -167,28 +517,168 @@ void etm::Shell::setInput(const std::string &str) {
 }
 
 void etm::Shell::cursorUp() {
-    if (commandHistory.size() > 0 && seekI != 0) {
-        if (seekI == commandHistory.size()) {
-            currentText = terminal->pollInput();
-        }
-        seekI--;
-        setInput(commandHistory[seekI]);
+    if (seekI >= history.end()) {
+        seekI = history.end();
+        currentText = terminal->pollInput();
+    }
+    // Only entries that start with what was typed
+    const History::index_t found = history.findBack(currentText, seekI, true);
+    if (found != History::NONE) {
+        seekI = found;
+        setInput(history.get(seekI));
     }
 }
 void etm::Shell::cursorDown() {
-    if (commandHistory.size() > 0) {
-        if (seekI < commandHistory.size() - 1) {
-            seekI++;
-            setInput(commandHistory[seekI]);
-        } else {
-            seekI = commandHistory.size();
-            setInput(currentText);
-            currentText.clear();
-            currentText.shrink_to_fit();
+    if (seekI >= history.end()) {
+        return;
+    }
+    const History::index_t found = history.findForward(currentText, seekI, true);
+    if (found != History::NONE) {
+        seekI = found;
+        setInput(history.get(seekI));
+    } else {
+        // Back to what was being typed
+        seekI = history.end();
+        setInput(currentText);
+        currentText.clear();
+        currentText.shrink_to_fit();
+    }
+}
+
+etm::History &etm::Shell::getHistory() {
+    return history;
+}
+
+const std::string &etm::Shell::getBuffer(const std::string &name) {
+    static const std::string empty;
+    std::map<std::string, std::string>::iterator loc = buffers.find(name);
+    return loc != buffers.end() ? loc->second : empty;
+}
+void etm::Shell::clearBuffer(const std::string &name) {
+    buffers.erase(name);
+}
+
+void etm::Shell::update() {
+    if (jobs.empty() || terminal == nullptr) {
+        return;
+    }
+    // Checked first, so that all of the output
+    // is taken if it's done
+    const bool finished = std::all_of(jobs.begin(), jobs.end(), [](const std::shared_ptr<task> &stage) -> bool {
+        return stage->job.isFinished();
+    });
+    // Only the last stage's output is left over
+    // for us, the rest goes down the pipeline.
+    // Once a frame, rather than once a write.
+    if (collect(jobs.back()->job, redirect)) {
+        terminal->flush();
+    }
+    if (finished) {
+        jobs.clear();
+        redirect.clear();
+        prepTerminal();
+    }
+}
+
+void etm::Shell::interrupt() {
+    if (!jobs.empty()) {
+        // The prompt comes back once they stop
+        for (std::shared_ptr<task> &stage : jobs) {
+            stage->job.cancel();
         }
+    } else if (terminal != nullptr) {
+        terminal->clearInput();
     }
 }
 
+std::size_t etm::Shell::getCompletions(const std::string &text, std::vector<std::string> &out) {
+    out.clear();
+    // The word being completed starts after the last space
+    const std::string::size_type start = text.find_last_of(' ') + 1;
+    std::string word = text.substr(start);
+    const std::string::size_type first = text.find_first_not_of(' ');
+    if (first == std::string::npos || first >= start) {
+        // It's the command
+        if (flagSet(flag::nocase)) {
+            makeLowercase(&word[0], &word[0] + word.size());
+        }
+        aliasTree.complete(word, out);
+    } else if (!word.empty() && word[0] == '-') {
+        // It's a flag of the command
+        std::string name = text.substr(first, text.find(' ', first) - first);
+        if (flagSet(flag::nocase)) {
+            makeLowercase(&name[0], &name[0] + name.size());
+        }
+        Command *command = findCommand(name);
+        if (command != nullptr) {
+            command->filter.complete(word, out);
+        }
+    }
+    return start;
+}
+
+void etm::Shell::complete() {
+    if (terminal == nullptr || !jobs.empty()) {
+        return;
+    }
+    const std::string text = terminal->pollInput();
+    const std::size_t start = getCompletions(text, completions);
+    if (completion::apply(*terminal, text, start, completions)) {
+        // The choices were listed, so start over
+        prepTerminal();
+        setInput(text);
+    }
+}
+
+void etm::Shell::lint(const InputBuffer &input, std::vector<bool> &flagged) {
+    if (flagSet(flag::nolint)) {
+        return;
+    }
+    const InputBuffer::tokens_t &tokens = input.getTokens();
+    Command *command = nullptr;
+    // If the next token is a command
+    bool first = true;
+    // If the next token is the value of a flag
+    bool value = false;
+    // If it can be a pipeline (see dispatch())
+    bool piped = false;
+    for (std::size_t i = 0; i < tokens.size(); i++) {
+        const std::string_view raw(input.getText().data() + tokens[i].start, tokens[i].end - tokens[i].start);
+        if (piped && raw == "|") {
+            first = true;
+            continue;
+        }
+        if (piped && raw.find_first_of("|>") != std::string_view::npos) {
+            // Could be quoted, could be a redirection...
+            // Either way, it's up to the command to tell
+            return;
+        }
+        input.getToken(i, lintToken);
+        if (first) {
+            first = false;
+            value = false;
+            if (flagSet(flag::nocase)) {
+                makeLowercase(&lintToken[0], &lintToken[0] + lintToken.size());
+            }
+            command = findCommand(lintToken);
+            flagged[i] = command == nullptr;
+            if (i == 0) {
+                piped = command != nullptr && command->job;
+            }
+        } else if (value) {
+            value = false;
+        } else if (command != nullptr && !lintToken.empty() && lintToken[0] == '-') {
+            const ArgFilter::Filter *filter = command->filter.findFilter(lintToken);
+            flagged[i] = filter == nullptr;
+            value = filter != nullptr && filter->type != ArgFilter::BOOL;
+        }
+    }
+}
+
+bool etm::Shell::isBusy() {
+    return !jobs.empty();
+}
+
 void etm::Shell::prepTerminal() {
     terminal->dispText(prompt);
     terminal->flush();
@@ -197,28 +687,64 @@ void etm::Shell::prepTerminal() {
 
 void etm::Shell::doAlias(comid_t id, const std::string &name) {
     aliasMap.insert_or_assign(name, id);
+    aliasTree.insert(name);
 }
 
-etm::Shell::comid_t etm::Shell::addCommand(const std::string &name, const ArgFilter &filter, const callback_t &callback) {
-    if (callback) {
+etm::Shell::Command *etm::Shell::findCommand(std::string_view name) {
+    if (frozen) {
+        const PerfectHash::value_type index = frozenAliases.find(name);
+        return index != PerfectHash::NONE ? frozenCommands[index] : nullptr;
+    }
+    aliasMap_t::iterator loc = aliasMap.find(name);
+    return loc != aliasMap.end() ? &commands[loc->second] : nullptr;
+}
+
+etm::Shell::comid_t etm::Shell::add(const std::string &name, const Command &command, bool callable, const char *location) {
+    if (frozen) {
+        postError(
+            location,
+            "The shell is frozen. The command \"" + name + "\" will not be added",
+            false
+        );
+        return 0;
+    }
+    if (callable) {
         commandId++;
-        commands.insert_or_assign(commandId, Command(filter, callback));
+        commands.insert_or_assign(commandId, command);
         doAlias(commandId, name);
         return commandId;
     } else {
         postError(
-            "Shell::addCommand(const std::string&, const ArgFilter&, const callback_t&)",
+            location,
             "The given callback is not callable. The command \"" + name + "\" will not be added",
             false
         );
         return 0;
     }
 }
+etm::Shell::comid_t etm::Shell::addCommand(const std::string &name, const ArgFilter &filter, const callback_t &callback) {
+    return add(
+        name, Command(filter, callback), static_cast<bool>(callback),
+        "Shell::addCommand(const std::string&, const ArgFilter&, const callback_t&)"
+    );
+}
+etm::Shell::comid_t etm::Shell::addJobCommand(const std::string &name, const ArgFilter &filter, const jobCallback_t &callback) {
+    return add(
+        name, Command(filter, callback), static_cast<bool>(callback),
+        "Shell::addJobCommand(const std::string&, const ArgFilter&, const jobCallback_t&)"
+    );
+}
 void etm::Shell::alias(comid_t id, const std::string &name) {
-    if (commands.find(id) != commands.end()) {
+    if (frozen) {
+        postError(
+            "Shell::alias(comid_t,const std::string&)",
+            "The shell is frozen. The alias \"" + name + "\" will not be added",
+            false
+        );
+    } else if (commands.find(id) != commands.end()) {
         if (flagSet(flag::nocase)) {
             std::string lower(name);
-            makeLowercase(lower);
+            makeLowercase(&lower[0], &lower[0] + lower.size());
             doAlias(id, lower);
         } else {
             doAlias(id, name);
@@ -236,6 +762,36 @@ void etm::Shell::alias(const std::string &name) {
     alias(commandId, name);
 }
 
+void etm::Shell::freeze() {
+    // Map nodes don't move, so the pointers stay good
+    // for as long as the shell is frozen
+    std::map<comid_t, PerfectHash::value_type> indices;
+    frozenCommands.clear();
+    for (commands_t::value_type &command : commands) {
+        indices[command.first] = frozenCommands.size();
+        frozenCommands.push_back(&command.second);
+        command.second.filter.freeze();
+    }
+    PerfectHash::entries_t entries;
+    entries.reserve(aliasMap.size());
+    for (const aliasMap_t::value_type &entry : aliasMap) {
+        entries.emplace_back(entry.first, indices[entry.second]);
+    }
+    frozenAliases.build(entries);
+    frozen = true;
+}
+void etm::Shell::thaw() {
+    frozenAliases.clear();
+    frozenCommands.clear();
+    for (commands_t::value_type &command : commands) {
+        command.second.filter.thaw();
+    }
+    frozen = false;
+}
+bool etm::Shell::isFrozen() {
+    return frozen;
+}
+
 void etm::Shell::postError(const std::string &location, const std::string &message, bool severe) {
     errorCallback(shellError(location, message, severe));
 }
@@ -3,19 +3,31 @@
 
 #include <functional>
 #include <map>
+#include <deque>
 #include <vector>
 #include <string>
+#include <string_view>
+#include <istream>
+#include <memory>
+#include <cstddef>
 
 #include "../EShell.h"
+#include "../ETerminal.h"
+#include "History.h"
+#include "RadixTree.h"
 #include "ArgFilter.h"
+#include "Args.h"
+#include "Job.h"
+#include "PerfectHash.h"
+#include "Schema.h"
 
 namespace etm {
     // Args
     class Args;
-    // ETerminal
-    class ETerminal;
     // shellError
     class shellError;
+    // ThreadPool
+    class ThreadPool;
 }
 
 namespace etm {
@@ -29,6 +41,19 @@ namespace etm {
         /// Command callback.
         /// Called when a command is invoked.
         typedef std::function<void(Shell&,ETerminal&,Args&)> callback_t;
+        /// Background command callback.
+        /// Called on a worker thread when a command is invoked,
+        /// so it mustn't touch the shell or terminal - output
+        /// goes through the @ref Job.
+        typedef std::function<void(Job&,Args&)> jobCallback_t;
+        /// Command callback, of a command with a @ref Schema.
+        /// Called with the struct the arguments were parsed into.
+        template<class T>
+        using schemaCallback_t = std::function<void(Shell&,ETerminal&,T&)>;
+        /// Callback of a command that parses its own arguments
+        /// (see @ref Schema), reporting errors through the
+        /// error handle. Returns `true` if there were errors.
+        typedef std::function<bool(Shell&,ETerminal&,const std::vector<std::string_view>&,ArgFilter::ErrorHandle&)> parsedCallback_t;
 
         /**
         * Container for a command callback and its
@@ -37,8 +62,13 @@ namespace etm {
         struct Command {
             /// The argument processor
             ArgFilter filter;
-            /// The command callback
+            /// The command callback, if it runs in the foreground
             callback_t callback;
+            /// The command callback, if it runs in the background
+            jobCallback_t job;
+            /// The command callback, if it parses its own arguments.
+            /// @ref filter is then only used for completion and errors.
+            parsedCallback_t parsed;
             /**
             * Construct a default-initialized command.
             */
@@ -49,8 +79,24 @@ namespace etm {
             * @param [in] callback The command callback
             */
             Command(const ArgFilter &filter, const callback_t &callback);
+            /**
+            * Construct a background command with args.
+            * @param [in] filter The argument processor
+            * @param [in] job The command callback
+            */
+            Command(const ArgFilter &filter, const jobCallback_t &job);
+            /**
+            * Construct a command that parses its own arguments.
+            * @param [in] filter The argument processor, for
+            * completion and errors
+            * @param [in] parsed The command callback
+            */
+            Command(const ArgFilter &filter, const parsedCallback_t &parsed);
         };
 
+        /// Default number of commands @ref runScript() runs between flushes
+        static constexpr unsigned int DEFAULT_FLUSH_INTERVAL = 1024;
+
         /// The command string type
         typedef std::string key_type;
         /// Type used for command IDs
@@ -77,11 +123,63 @@ namespace etm {
             /// and so will the invokation commands (first command given,
             /// like in say `g++ ...`, "g++" is the invokation command)
             static constexpr type nocase = 1 << 0;
+            /// If set, the input isn't checked as it's typed
+            /// @see lint(const InputBuffer &input, std::vector<bool> &flagged)
+            static constexpr type nolint = 1 << 1;
         };
 
     private:
         /// Type used for the alias map
-        typedef std::map<key_type, comid_t> aliasMap_t;
+        typedef std::map<key_type, comid_t, std::less<>> aliasMap_t;
+
+        /**
+        * Scratch space for parsing a command.
+        * Kept between commands so that its memory is reused,
+        * and nothing is allocated once it's big enough.
+        */
+        struct parse {
+            /// The tokens of the command, back to back,
+            /// with the quotes taken out
+            std::string text;
+            /// Views of each token in @ref text
+            std::vector<std::string_view> tokens;
+            /// The command's args
+            Args args;
+        };
+
+        /**
+        * What came of running a command.
+        */
+        enum outcome {
+            /// There was no command
+            BLANK,
+            /// It ran
+            RAN,
+            /// It failed, carry on
+            FAILED,
+            /// It failed, and the error handle
+            /// says to stop (fail fast)
+            ABORTED,
+            /// It's running in the background
+            STARTED
+        };
+
+        /**
+        * A command running in the background, or
+        * a stage of a pipeline.
+        */
+        struct task {
+            /// What the callback sees
+            Job job;
+            /// The command, the args view it
+            parse scratch;
+            /// Copy of the command's filter, which the args point
+            /// to. The command's own can change while this runs (ex.
+            /// by @ref freeze()), so it can't be used.
+            ArgFilter filter;
+            /// The command callback
+            jobCallback_t callback;
+        };
 
         /// Called when functional errors are encountered
         /// @see setErrorCallback(const errCallback_t &callback)
@@ -100,6 +198,21 @@ namespace etm {
         /// Command aliases, all point to a nameless command in @ref commands
         /// @see alias(const std::string &name)
         aliasMap_t aliasMap;
+        /// The keys of @ref aliasMap again, for completion
+        RadixTree aliasTree;
+        /// Completions, kept to reuse their memory
+        std::vector<std::string> completions;
+        /// The token being linted, kept to reuse its memory
+        /// @see lint(const InputBuffer &input, std::vector<bool> &flagged)
+        std::string lintToken;
+        /// @ref aliasMap compiled into a perfect hash, the values
+        /// are indices into @ref frozenCommands
+        /// @see freeze()
+        PerfectHash frozenAliases;
+        /// The commands that @ref frozenAliases points to
+        std::vector<Command*> frozenCommands;
+        /// Whether dispatch goes through @ref frozenAliases
+        bool frozen;
         /// Flags
         /// @see setFlags(flag::type flags)
         flag::type flags;
@@ -108,14 +221,38 @@ namespace etm {
         std::string prompt;
         /// The command ID of the last added command
         comid_t commandId;
-        /// The shell's command history.
-        /// Capped at an arbitrary number (small)
-        std::vector<std::string> commandHistory;
+        /// The shell's command history
+        /// @see getHistory()
+        History history;
         /// Stored text so that seeking operations can
         /// return to what the user was preveously typing.
         std::string currentText;
         /// Seek index for command history
-        std::vector<std::string>::size_type seekI;
+        History::index_t seekI;
+        /// Parse scratch space, one for each nested
+        /// @ref input(const std::string &commandString)
+        /// (ex. a command that runs commands).
+        /// A deque, so that they stay put as it grows.
+        std::deque<parse> parses;
+        /// Number of @ref parses in use
+        std::deque<parse>::size_type depth;
+        /// Whether @ref runScript() is running, in which
+        /// case background commands are run in the foreground
+        bool scripting;
+        /// The command running in the background, or the
+        /// stages of the pipeline, if any
+        std::vector<std::shared_ptr<task>> jobs;
+        /// The buffer that the output of @ref jobs goes to,
+        /// or empty if it goes to the terminal
+        std::string redirect;
+        /// Output taken from @ref jobs, kept to reuse its memory
+        std::string jobOutput;
+        /// Redirected output
+        /// @see getBuffer(const std::string &name)
+        std::map<std::string, std::string> buffers;
+        /// Runs background commands, made when first needed
+        /// and grown to fit the longest pipeline
+        std::unique_ptr<ThreadPool> pool;
 
         /**
         * Checks if a flag is set.
@@ -135,6 +272,80 @@ namespace etm {
         * @param [in] name The name to alias with
         */
         void doAlias(comid_t id, const std::string &name);
+        /**
+        * Finds the command with the given alias.
+        * @param [in] name The alias
+        * @return The command, or `nullptr` if there isn't one
+        */
+        Command *findCommand(std::string_view name);
+        /**
+        * Splits a command into tokens.
+        * Tokens are separated by spaces, and quotes
+        * group spaces into a token.
+        * @param [in] commandString The command
+        * @param [out] out Where to put the tokens
+        */
+        void tokenize(std::string_view commandString, parse &out);
+        /**
+        * Runs a command, without touching the prompt
+        * or the history.
+        * @param [in] commandString The command
+        * @return What came of it
+        */
+        outcome dispatch(const std::string &commandString);
+        /**
+        * Checks if a command is a background command, which
+        * are the only ones that can be piped or redirected.
+        * @param [in] commandString The command, or the first
+        * stage of a pipeline
+        * @param [out] scratch Where to tokenize it
+        * @return `true` if it is
+        */
+        bool isJob(std::string_view commandString, parse &scratch);
+        /**
+        * Runs a pipeline, and/or redirects its output.
+        * Each stage must be a background command.
+        * @param [in] stages The commands, in order
+        * @param [in] target The buffer to redirect to, or
+        * empty to show the output
+        * @param [in] append Whether to append to the buffer,
+        * rather than replace it
+        * @return What came of it
+        */
+        outcome pipeline(const std::vector<std::string_view> &stages, std::string_view target, bool append);
+        /**
+        * Gets the pool, making sure that it has enough workers.
+        * @note Nothing may be running on it, in case it's remade.
+        * @param [in] workers The number of workers needed
+        * @return The pool
+        */
+        ThreadPool &getPool(std::size_t workers);
+        /**
+        * Starts background commands.
+        * @param [in,out] runner Where to run them, with at least
+        * as many workers as there are commands (they might be
+        * waiting on each other)
+        * @param [in] stages The commands
+        */
+        static void launch(ThreadPool &runner, const std::vector<std::shared_ptr<task>> &stages);
+        /**
+        * Takes the output of a background command, and shows it
+        * or appends it to a buffer.
+        * @param [in,out] job The job
+        * @param [in] target The buffer, or empty to show it
+        * @return `true` if anything was shown
+        */
+        bool collect(Job &job, const std::string &target);
+        /**
+        * Adds a command.
+        * @param [in] name The initial alias for the command
+        * @param [in] command The command
+        * @param [in] callable Whether its callback is callable
+        * @param [in] location Where the request came from,
+        * for error messages
+        * @return ID of the command, or zero if an error occurred
+        */
+        comid_t add(const std::string &name, const Command &command, bool callable, const char *location);
 
         /**
         * Replaces the current user input.
@@ -157,6 +368,11 @@ namespace etm {
         * @see setErrorCallback(const errCallback_t &callback)
         */
         Shell(const errCallback_t &callback);
+        /**
+        * Cancels the background command, if any,
+        * and waits for it to return.
+        */
+        ~Shell();
 
         /**
         * Set the callback that will be called whenever
@@ -222,8 +438,93 @@ namespace etm {
         void setTerminal(ETerminal &terminal);
 
         void input(const std::string &commandString) override;
+        /**
+        * Runs commands from a stream, one per line, as though
+        * they were each given to @ref input(const std::string &commandString) -
+        * minus the prompt, history and flush that come with each.
+        * The stream is read as it goes, so it can be as long as you like.
+        * Blank lines and lines starting with `#` are skipped.
+        * If a command fails and its error handle says to fail fast
+        * (@ref ArgFilter::ErrorHandle::doFailfast()), the script stops
+        * there. Commands that don't exist go by the
+        * @ref ArgFilter::getDefaultErrorHandle() "default error handle".
+        * The prompt is shown when it's done, unless it was called from
+        * a command or another script, which show it themselves.
+        * @param [in,out] stream The script
+        * @param [in] flushInterval Flush the terminal every this
+        * many commands, or only at the end if 0
+        * @return The number of commands run, including the one
+        * that stopped the script, if any
+        */
+        std::size_t runScript(std::istream &stream, unsigned int flushInterval = DEFAULT_FLUSH_INTERVAL);
         void cursorUp() override;
         void cursorDown() override;
+        /**
+        * Gets the command history, ex. to set its
+        * capacity or the file it's saved to.
+        * Moving the cursor up and down with some input
+        * typed only goes through entries that start with it.
+        * @return The history
+        */
+        History &getHistory();
+        /**
+        * Gets the output that was redirected to a buffer
+        * (`command > name`, or `>> name` to append).
+        * Output of a command running in the background
+        * is added to it as it comes in.
+        * @param [in] name The name of the buffer
+        * @return The output, or an empty string if nothing
+        * was redirected to it
+        */
+        const std::string &getBuffer(const std::string &name);
+        /**
+        * Deletes a buffer.
+        * @param [in] name The name of the buffer
+        * @see getBuffer(const std::string &name)
+        */
+        void clearBuffer(const std::string &name);
+        /**
+        * Finds what the last word of some input could be completed to -
+        * the command, or if that's been typed, one of its flags.
+        * @param [in] text The input
+        * @param [out] out The completions, best first (replaced)
+        * @return Where in `text` the word being completed starts
+        * @see complete()
+        */
+        std::size_t getCompletions(const std::string &text, std::vector<std::string> &out);
+        /**
+        * Completes the input as far as it can, or if there's
+        * a choice to be made, lists the choices.
+        */
+        void complete() override;
+        /**
+        * Flags commands that don't exist, and flags that the
+        * command doesn't have, as they're typed.
+        * If the command is a background command, it stops at
+        * anything to do with redirection, but each stage of a
+        * pipeline is checked.
+        * @param [in] input The input
+        * @param [out] flagged If each token is flagged
+        * @see flag::nolint
+        */
+        void lint(const InputBuffer &input, std::vector<bool> &flagged) override;
+        /**
+        * Shows output from the background command, and the
+        * prompt once it's done.
+        * Called by the terminal once a frame.
+        */
+        void update() override;
+        /**
+        * Cancels the background command, or if there
+        * isn't one, clears the input.
+        */
+        void interrupt() override;
+        /**
+        * Check if a command is running in the background.
+        * @return `true` if there is one
+        * @see addJobCommand(const std::string &name, const ArgFilter &filter, const jobCallback_t &callback)
+        */
+        bool isBusy();
 
         /**
         * Add a new command to the Shell.
@@ -239,6 +540,54 @@ namespace etm {
         */
         comid_t addCommand(const std::string &name, const ArgFilter &filter, const callback_t &callback);
         /**
+        * Add a new command, with its flags declared as a struct
+        * (see @ref Schema). The arguments are parsed straight into
+        * the struct, which the callback is given.
+        * Errors are handled by the default error handle, as
+        * with an @ref ArgFilter, and the usage is generated.
+        * @note If the parameter `callback` is not callable,
+        * an error is set and the command is not added.
+        * @param [in] name The initial alias for the command
+        * @param [in] schema The flags of the command
+        * @param [in] callback A callable callback for the command,
+        * convertible to a @ref schemaCallback_t "schemaCallback_t<T>"
+        * @return ID of the command (used to modify it), or zero if
+        * an error occurred.
+        */
+        template<class T, class... Fields, class F>
+        comid_t addCommand(const std::string &name, const Schema<T, Fields...> &schema, F callback);
+        /**
+        * Add a new command that runs in the background, on a worker
+        * thread, so that a slow command doesn't hold up rendering.
+        * Output written to the @ref Job is shown once a frame, and
+        * the prompt comes back when the callback returns.
+        * Only one runs at a time, and input is ignored until it's
+        * done - except for @ref interrupt(), which cancels it.
+        * Background commands can be chained into a pipeline
+        * (`a | b | c`), where each reads what the one before it
+        * wrote (see @ref Job::read(std::string &chunk)). They all
+        * run at once, each on its own worker, with a bounded
+        * @ref Pipe between them, and only the last one's output
+        * is shown. Output can also be redirected to a buffer
+        * (`a > name`), so it's never shown at all.
+        * This is only done if the first command is a background
+        * command - for any other, `|` and `>` are just part of
+        * its arguments.
+        * @see getBuffer(const std::string &name)
+        * @note Commands run from @ref runScript() or from other
+        * commands run in the foreground, as normal commands would.
+        * Pipelines do as well, in that the shell waits for them.
+        * @note If the parameter `callback` is not callable,
+        * an error is set and the command is not added.
+        * @param [in] name The initial alias for the command
+        * @param [in] filter The command filter for the command
+        * @param [in] callback A callable callback for the command
+        * @return ID of the command (used to modify it), or zero if
+        * an error occurred.
+        * @see addCommand(const std::string &name, const ArgFilter &filter, const callback_t &callback)
+        */
+        comid_t addJobCommand(const std::string &name, const ArgFilter &filter, const jobCallback_t &callback);
+        /**
         * Associate another name with the given command.
         * @note An error is set if `id` is invalid (doesn't exist)
         * @note If `name` already exists as an alias to some other
@@ -261,6 +610,29 @@ namespace etm {
         */
         void alias(const std::string &name);
 
+        /**
+        * Compile the aliases of every command, and the flags
+        * of each of their filters, into perfect hashes.
+        * Finding a command is then one hash and one compare,
+        * which adds up when scripts push a lot of commands through
+        * @ref input(const std::string &commandString).
+        * @note While frozen, commands and aliases can't be added -
+        * an error is set, and nothing happens.
+        * @see thaw()
+        * @see ArgFilter::freeze()
+        */
+        void freeze();
+        /**
+        * Undo @ref freeze(), so that commands can be added again.
+        */
+        void thaw();
+        /**
+        * Check if the shell is frozen.
+        * @return `true` if it is
+        * @see freeze()
+        */
+        bool isFrozen();
+
         /**
         * Send an error to the error callback.
         * The given parameters are packaged into a @ref shellError object.
@@ -272,4 +644,32 @@ namespace etm {
     };
 }
 
+template<class T, class... Fields, class F>
+etm::Shell::comid_t etm::Shell::addCommand(const std::string &name, const Schema<T, Fields...> &schema, F callback) {
+    const schemaCallback_t<T> function(std::move(callback));
+    const ArgFilter filter = schema.toFilter(name);
+    std::string usage;
+    schema.usage(name, usage);
+    const parsedCallback_t parsed = [schema, function, usage](Shell &shell, ETerminal &terminal, const std::vector<std::string_view> &arguments, ArgFilter::ErrorHandle &handle) -> bool {
+        // Fields that aren't given keep their defaults
+        T values{};
+        std::string error;
+        const bool failed = schema.parse(arguments, values, error, handle);
+        if (failed) {
+            terminal.dispText(error);
+            terminal.dispText(usage);
+            if (handle.doFail()) {
+                return true;
+            }
+            terminal.flush();
+        }
+        function(shell, terminal, values);
+        return failed;
+    };
+    return add(
+        name, Command(filter, parsed), static_cast<bool>(function),
+        "Shell::addCommand(const std::string&, const Schema<T, Fields...>&, F)"
+    );
+}
+
 #endif
@@ -0,0 +1,64 @@
+#include "completion.h"
+
+#include <algorithm>
+
+#include "../ETerminal.h"
+#include "RadixTree.h"
+
+/// Most completions shown at once
+static constexpr std::size_t MAX_LISTED_COMPLETIONS = 100;
+
+/**
+* Replaces the input.
+* @param [in,out] terminal The terminal
+* @param [in] str The new input
+*/
+static void setInput(etm::ETerminal &terminal, const std::string &str);
+/**
+* Shows completions under the input.
+* @param [in,out] terminal The terminal
+* @param [in] text The input
+* @param [in] completions The completions
+*/
+static void listCompletions(etm::ETerminal &terminal, const std::string &text, const std::vector<std::string> &completions);
+
+void setInput(etm::ETerminal &terminal, const std::string &str) {
+    terminal.clearInput();
+    terminal.dispText(str);
+    terminal.softFlush();
+}
+
+void listCompletions(etm::ETerminal &terminal, const std::string &text, const std::vector<std::string> &completions) {
+    std::string list = text + "\n";
+    const std::size_t shown = std::min<std::size_t>(completions.size(), MAX_LISTED_COMPLETIONS);
+    for (std::size_t i = 0; i < shown; i++) {
+        list += completions[i];
+        list += "  ";
+    }
+    if (shown < completions.size()) {
+        list += "(" + std::to_string(completions.size() - shown) + " more)";
+    }
+    list += "\n";
+    terminal.clearInput();
+    terminal.dispText(list);
+}
+
+bool etm::completion::apply(ETerminal &terminal, const std::string &text, std::size_t start, const std::vector<std::string> &completions) {
+    if (completions.empty()) {
+        return false;
+    }
+    const std::string before = text.substr(0, start);
+    if (completions.size() == 1) {
+        setInput(terminal, before + completions[0] + " ");
+        return false;
+    }
+    // Go as far as they agree
+    const std::string common = RadixTree::commonPrefix(completions);
+    if (common.size() > text.size() - start) {
+        setInput(terminal, before + common);
+        return false;
+    }
+    // Otherwise, show the choices and start over
+    listCompletions(terminal, text, completions);
+    return true;
+}
@@ -0,0 +1,34 @@
+#ifndef ETERMAL_COMPLETION_H_INCLUDED
+#define ETERMAL_COMPLETION_H_INCLUDED
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+namespace etm {
+    // ../ETerminal
+    class ETerminal;
+}
+
+/**
+* What the shells do with completions once they've found them,
+* so that they all complete the same way.
+* @see Shell::complete()
+* @see BasicShell::complete()
+*/
+namespace etm::completion {
+
+    /**
+    * Completes the input as far as the completions agree, or if
+    * there's a choice to be made, lists them under the input.
+    * @param [in,out] terminal The terminal
+    * @param [in] text The input
+    * @param [in] start Where the word being completed starts
+    * @param [in] completions The completions, best first
+    * @return `true` if the completions were listed, in which case
+    * the prompt and the input need to be shown again
+    */
+    bool apply(ETerminal &terminal, const std::string &text, std::size_t start, const std::vector<std::string> &completions);
+}
+
+#endif
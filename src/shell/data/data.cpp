@@ -1,33 +1,68 @@
 #include "data.h"
 
 #include <exception>
+#include <charconv>
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
 
-/**
-* Does a very dumb parse for bool.
-* The point is not accuracy, but rather to get some
-* reasonable value.
-* @param [in] str The string to parse
-* @return The boolean value
-*/
-static bool parseBool(const std::string &str);
+/// Longest number @ref etm::data::parseFloat() will parse
+static constexpr std::size_t MAX_NUMBER = 64;
 
-bool parseBool(const std::string &str) {
-    typedef std::string::size_type size;
-    size start = 0;
-    size end = str.size() - 1;
-    for (; start < str.size() - 1 && str[start] == ' '; start++);
-    for (; end > 0 && str[end] == ' '; end--);
-    if (end - start == 1) {
-        return str[start] == '1';
+bool etm::data::parseBool(std::string_view str) {
+    std::string_view::size_type start = 0;
+    std::string_view::size_type end = str.size();
+    for (; start < end && str[start] == ' '; start++);
+    for (; end > start && str[end - 1] == ' '; end--);
+    str = str.substr(start, end - start);
+    if (str.size() == 1) {
+        return str[0] == '1';
     }
 
-    std::string test = str.substr(start, end - start + 1);
-    for (char &c : test) {
-        if ('A' <= c && c <= 'Z') {
-            c |= 0x20;
+    constexpr std::string_view test = "true";
+    if (str.size() != test.size()) {
+        return false;
+    }
+    for (std::string_view::size_type i = 0; i < str.size(); i++) {
+        if ((('A' <= str[i] && str[i] <= 'Z') ? str[i] | 0x20 : str[i]) != test[i]) {
+            return false;
         }
     }
-    return test == "true";
+    return true;
+}
+
+bool etm::data::parseInt(std::string_view str, int &out) {
+    // Like std::stoi, leading whitespace and
+    // trailing junk are fine
+    const char *first = str.data();
+    const char *last = str.data() + str.size();
+    for (; first < last && std::isspace(static_cast<unsigned char>(*first)); first++);
+    // std::from_chars doesn't take a plus, but it would take
+    // a minus after one (ex. "+-5"), which std::stoi doesn't
+    if (first + 1 < last && *first == '+' && std::isdigit(static_cast<unsigned char>(first[1]))) {
+        first++;
+    }
+    return std::from_chars(first, last, out).ec == std::errc();
+}
+
+bool etm::data::parseFloat(std::string_view str, float &out, bool whole) {
+    // Takes care of the hex, `inf` and `nan`
+    // that std::strtof would otherwise take
+    if (whole && str.find_first_not_of("0123456789.eE+-") != std::string_view::npos) {
+        return false;
+    }
+    // std::strtof needs a null terminator, which
+    // a view doesn't have
+    char buffer[MAX_NUMBER];
+    if (str.size() >= MAX_NUMBER) {
+        return false;
+    }
+    str.copy(buffer, str.size());
+    buffer[str.size()] = '\0';
+    char *end;
+    errno = 0;
+    out = std::strtof(buffer, &end);
+    return end != buffer && errno != ERANGE && (!whole || end == buffer + str.size());
 }
 
 etm::data::String::String(const std::string &str) noexcept: str(str) {
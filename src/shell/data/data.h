@@ -2,11 +2,40 @@
 #define ETERMAL_DATA_H_INCLUDED
 
 #include <string>
+#include <string_view>
 
 #include "ArgData.h"
 
 namespace etm::data {
 
+    /**
+    * Does a very dumb parse for bool.
+    * The point is not accuracy, but rather to get some
+    * reasonable value.
+    * @param [in] str The string to parse
+    * @return The boolean value
+    */
+    bool parseBool(std::string_view str);
+    /**
+    * Parses an int, like `std::stoi` but without
+    * allocating or throwing.
+    * @param [in] str The string to parse
+    * @param [out] out The int
+    * @return `true` if it parsed
+    */
+    bool parseInt(std::string_view str, int &out);
+    /**
+    * Parses a float, like `std::stof` but without
+    * allocating or throwing.
+    * @param [in] str The string to parse
+    * @param [out] out The float
+    * @param [in] whole If the whole string has to be a plain
+    * decimal number - no whitespace, trailing junk,
+    * hex, `inf` or `nan`, unlike `std::stof`
+    * @return `true` if it parsed
+    */
+    bool parseFloat(std::string_view str, float &out, bool whole = false);
+
     /**
     * Represents string data.
     */
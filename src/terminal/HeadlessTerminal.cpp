@@ -0,0 +1,295 @@
+#include "HeadlessTerminal.h"
+
+#include <iostream>
+#include <algorithm>
+#include <cctype>
+
+#include "util/termError.h"
+#include "../TermInput.h"
+#include "../EShell.h"
+
+/**
+* The default error callback.
+* @param [in] error The error object
+*/
+static void defaultErrorCallback(const etm::termError &error);
+/**
+* Strips escapes from input, as the @ref etm::Terminal does
+* (see @ref term_input).
+* @param [in] input The input, as it was typed
+* @return The input, as the shell sees it
+*/
+static std::string filterInput(const std::string &input);
+/**
+* Appends text to the output, without formatting sequences.
+* @param [in] text The text
+* @param [in,out] out The output
+*/
+static void appendStripped(const std::string &text, std::string &out);
+
+void defaultErrorCallback(const etm::termError &error) {
+    std::cerr
+        << "---------------------------\n"
+        << "ETERMAL::HEADLESSTERMINAL::ERROR:\n"
+        << "location = " << error.location << "\n"
+        << "severe = " << (error.severe ? "TRUE" : "FALSE") << "\n"
+        << "message = \"" << error.message << "\"\n"
+        << "---------------------------\n";
+}
+
+std::string filterInput(const std::string &input) {
+    std::string filtered;
+    filtered.reserve(input.size());
+    bool escaped = false;
+    for (char c : input) {
+        if (escaped) {
+            escaped = false;
+            filtered.push_back(c == '\n' ? ' ' : c);
+        } else if (c == '\\') {
+            escaped = true;
+        } else {
+            filtered.push_back(c);
+        }
+    }
+    return filtered;
+}
+
+void appendStripped(const std::string &text, std::string &out) {
+    constexpr char ESCAPE = '\x1b';
+    out.reserve(out.size() + text.size());
+    for (std::string::size_type i = 0; i < text.size();) {
+        // Same sequences that the Terminal reads
+        if (text[i] == ESCAPE && i + 2 < text.size() && text[i+1] == '[') {
+            std::string::size_type end = i + 2;
+            switch (text[end]) {
+                case 'b': // Fallthrough
+                case 'f': {
+                    end++;
+                    // Up to six hex digits
+                    const std::string::size_type limit = std::min(end + 6, text.size());
+                    for (; end < limit && std::isxdigit(static_cast<unsigned char>(text[end])); end++);
+                    break;
+                }
+                case 'B': // Fallthrough
+                case 'F': // Fallthrough
+                case 'r':
+                    end++;
+                    break;
+                default:
+                    end = i;
+            }
+            if (end != i) {
+                // Skip the optional semicolon
+                if (end < text.size() && text[end] == ';') {
+                    end++;
+                }
+                i = end;
+                continue;
+            }
+        }
+        // Copy up to the next escape
+        std::string::size_type next = text.find(ESCAPE, i + 1);
+        if (next == std::string::npos) {
+            next = text.size();
+        }
+        out.append(text, i, next - i);
+        i = next;
+    }
+}
+
+etm::HeadlessTerminal::HeadlessTerminal(): HeadlessTerminal(defaultErrorCallback) {
+}
+etm::HeadlessTerminal::HeadlessTerminal(const errCallback_t &errorCallback):
+    // Make sure that the provided callback is valid
+    errorCallback(errorCallback ? errorCallback : defaultErrorCallback),
+    inputStart(0),
+    maxOutput(0),
+    keepFormatting(false),
+    takeInput(false),
+    escapeNext(false),
+    shell(nullptr)
+{
+}
+
+void etm::HeadlessTerminal::postError(const std::string &location, const std::string &message) {
+    errorCallback(termError(location, message, 0, false));
+}
+
+void etm::HeadlessTerminal::setShell(EShell &shell) {
+    this->shell = &shell;
+}
+void etm::HeadlessTerminal::setErrorCallback(const errCallback_t &callback) {
+    if (callback) {
+        errorCallback = callback;
+    }
+}
+void etm::HeadlessTerminal::setMaxOutput(std::string::size_type bytes) {
+    maxOutput = bytes;
+    trim();
+}
+void etm::HeadlessTerminal::setKeepFormatting(bool value) {
+    keepFormatting = value;
+}
+
+bool etm::HeadlessTerminal::acceptInput() {
+    return takeInput || inputRequests.size();
+}
+
+void etm::HeadlessTerminal::inputString(const std::string &text) {
+    for (char c : text) {
+        if (!acceptInput()) break;
+        // Basically if it's a carrige return, we don't want it.
+        if (c == '\r') {
+            continue;
+        }
+        if (escapeNext) {
+            escapeNext = false;
+            output.push_back(c);
+        } else if (c == '\n') {
+            // Don't actually include the newline
+            // in the input
+            std::string input = pollInput();
+            output.push_back(c);
+            inputStart = output.size();
+            pushInput(input);
+        } else {
+            escapeNext = c == '\\';
+            output.push_back(c);
+        }
+    }
+}
+
+void etm::HeadlessTerminal::inputActionKey(actionKey key) {
+    // Parts of the function depend on a valid shell
+    if (shell == nullptr) {
+        postError(
+            "HeadlessTerminal::inputActionKey(actionKey)",
+            "Shell is nullptr (not set)"
+        );
+        return;
+    }
+    switch (key) {
+        case ENTER:
+            inputString("\n");
+            break;
+        case BACKSPACE:
+            if (output.size() > inputStart) {
+                // Remove the continuation bytes, then the header
+                while (output.size() > inputStart + 1 && (output.back() & 0xC0) == 0x80) {
+                    output.pop_back();
+                }
+                output.pop_back();
+            }
+            break;
+        case UP:
+            shell->cursorUp();
+            break;
+        case DOWN:
+            shell->cursorDown();
+            break;
+        case INTERRUPT:
+            shell->interrupt();
+            break;
+        case TAB:
+            if (takeInput) {
+                shell->complete();
+            }
+            break;
+        // The cursor is always at the end
+        default:
+            break;
+    }
+}
+
+void etm::HeadlessTerminal::update() {
+    if (shell != nullptr) {
+        shell->update();
+    }
+}
+
+void etm::HeadlessTerminal::pushInput(const std::string &input) {
+    const std::string filtered = filterInput(input);
+    if (inputRequests.size()) {
+        TermInput *request = inputRequests.front();
+        inputRequests.pop_front();
+        request->terminalInput(filtered);
+    } else if (shell != nullptr) {
+        shell->input(filtered);
+    } else {
+        postError(
+            "HeadlessTerminal::pushInput(const std::string&)",
+            "Shell is nullptr (not set)"
+        );
+    }
+}
+
+void etm::HeadlessTerminal::trim() {
+    // Only once it's twice the max, so that the cost
+    // of moving everything down is spread out
+    if (!maxOutput || output.size() <= maxOutput * 2) {
+        return;
+    }
+    // Drop whole lines, but never the input
+    std::string::size_type cut = output.find('\n', output.size() - maxOutput - 1);
+    cut = cut == std::string::npos ? output.size() - maxOutput : cut + 1;
+    cut = std::min(cut, inputStart);
+    output.erase(0, cut);
+    inputStart -= cut;
+}
+
+const std::string &etm::HeadlessTerminal::getOutput() {
+    return output;
+}
+void etm::HeadlessTerminal::clearOutput() {
+    output.erase(0, inputStart);
+    inputStart = 0;
+}
+
+void etm::HeadlessTerminal::setTakeInput(bool value) {
+    takeInput = value;
+}
+
+void etm::HeadlessTerminal::clear() {
+    output.clear();
+    inputStart = 0;
+    displayBuffer.clear();
+    displayBuffer.shrink_to_fit();
+}
+
+void etm::HeadlessTerminal::requestInput(TermInput &callback) {
+    inputRequests.push_back(&callback);
+}
+void etm::HeadlessTerminal::cancelInputRequest(TermInput *callback) {
+    inputRequests.erase(std::remove(inputRequests.begin(), inputRequests.end(), callback), inputRequests.end());
+}
+void etm::HeadlessTerminal::clearInputRequests() {
+    inputRequests.clear();
+}
+
+void etm::HeadlessTerminal::clearInput() {
+    output.resize(inputStart);
+}
+
+std::string etm::HeadlessTerminal::pollInput() {
+    return output.substr(inputStart);
+}
+
+void etm::HeadlessTerminal::dispText(const std::string &str) {
+    displayBuffer += str;
+}
+
+void etm::HeadlessTerminal::flush() {
+    softFlush();
+    // Lock the input to the end
+    inputStart = output.size();
+}
+
+void etm::HeadlessTerminal::softFlush() {
+    if (keepFormatting) {
+        output += displayBuffer;
+    } else {
+        appendStripped(displayBuffer, output);
+    }
+    displayBuffer.clear();
+    trim();
+}
@@ -0,0 +1,182 @@
+#ifndef ETERMAL_HEADLESSTERMINAL_H_INCLUDED
+#define ETERMAL_HEADLESSTERMINAL_H_INCLUDED
+
+#include <deque>
+#include <functional>
+#include <string>
+
+#include "util/enums.h"
+#include "../ETerminal.h"
+
+namespace etm {
+    // ../shell/EShell
+    class EShell;
+    // ../shell/TermInput
+    class TermInput;
+    // util/termError
+    class termError;
+}
+
+namespace etm {
+
+    /**
+    * An @ref ETerminal that doesn't draw anything, so it
+    * needs neither a window nor OpenGL.
+    * Output is kept as plain text, followed by the input,
+    * and input is given as though it were typed - so shells,
+    * commands and input requests behave as they would with
+    * a @ref Terminal. Good for tests, benchmarks and servers.
+    * @see Terminal
+    */
+    class HeadlessTerminal: public ETerminal {
+    public:
+        /// Error callback function.
+        /// @param [in] error An object with error information
+        typedef std::function<void(const termError &error)> errCallback_t;
+    private:
+        /// Type used for @ref inputRequests
+        typedef std::deque<TermInput*> inputRequests_t;
+
+        /// The error callback.
+        /// Is always callable.
+        errCallback_t errorCallback;
+
+        /// UTF-8 encoded string waiting to
+        /// be pushed to @ref output
+        std::string displayBuffer;
+        /// Everything that's been flushed, followed by the input
+        /// @see getOutput()
+        std::string output;
+        /// Where the input starts in @ref output (the cursor lock)
+        std::string::size_type inputStart;
+        /// Max size of @ref output, or zero for no limit
+        /// @see setMaxOutput(std::string::size_type bytes)
+        std::string::size_type maxOutput;
+        /// Whether formatting sequences are kept in @ref output
+        /// @see setKeepFormatting(bool value)
+        bool keepFormatting;
+
+        /// All pending input requests
+        inputRequests_t inputRequests;
+        /// Does the shell want user input?
+        /// If false and @ref inputRequests is empty,
+        /// ignores all user input.
+        bool takeInput;
+        /// If the next character should be escaped
+        bool escapeNext;
+
+        /// The tied shell
+        EShell *shell;
+
+        /**
+        * Posts an error to the error callback.
+        * @param [in] location Where the error happened
+        * @param [in] message What happened
+        */
+        void postError(const std::string &location, const std::string &message);
+        /**
+        * Sends input to the first input request, or the shell.
+        * @param [in] input The input, as it was typed
+        */
+        void pushInput(const std::string &input);
+        /**
+        * Trims @ref output down to @ref maxOutput, if it's
+        * gotten too long.
+        */
+        void trim();
+    public:
+        /**
+        * Construct a headless terminal with the
+        * default error callback.
+        */
+        HeadlessTerminal();
+        /**
+        * Construct a headless terminal.
+        * @param [in] errorCallback The error callback, or
+        * the default one if it isn't callable
+        */
+        HeadlessTerminal(const errCallback_t &errorCallback);
+
+        /**
+        * Sets the shell that input goes to.
+        * @param [in] shell The shell
+        */
+        void setShell(EShell &shell);
+        /**
+        * Sets the error callback.
+        * @note If `callback` is not callable, nothing is changed.
+        * @param [in] callback The error callback
+        */
+        void setErrorCallback(const errCallback_t &callback);
+        /**
+        * Sets how much output to keep, as scrollback is limited
+        * in a @ref Terminal. Once it's twice this, the oldest
+        * lines are dropped, so that it's at most this.
+        * The input is never dropped.
+        * @param [in] bytes The max size, or zero for no limit
+        * (the default)
+        */
+        void setMaxOutput(std::string::size_type bytes);
+        /**
+        * Sets whether formatting sequences (see @ref escape_sequences)
+        * are kept in the output, or stripped (the default).
+        * @param [in] value `true` to keep them
+        */
+        void setKeepFormatting(bool value);
+
+        /**
+        * Checks if the terminal takes input right now -
+        * either the shell wants it, or there's an input request.
+        * @return `true` if it does
+        */
+        bool acceptInput();
+        /**
+        * Types text into the terminal, as a user would.
+        * A newline enters the input, as @ref ENTER would,
+        * unless it's escaped with a backslash (see @ref term_input).
+        * Stops if the terminal stops taking input.
+        * @param [in] text UTF-8 encoded text
+        */
+        void inputString(const std::string &text);
+        /**
+        * Presses an action key, as a user would.
+        * There's no cursor to move, so @ref LEFT and
+        * @ref RIGHT do nothing.
+        * @param [in] key The key
+        */
+        void inputActionKey(actionKey key);
+        /**
+        * Lets the shell do its work for the frame (ex. show
+        * output from background commands), as rendering
+        * a @ref Terminal would.
+        */
+        void update();
+
+        /**
+        * Gets all of the output that's been flushed, followed by
+        * the input being typed (see @ref pollInput()), as it
+        * would appear on screen.
+        * @return The output, UTF-8 encoded
+        */
+        const std::string &getOutput();
+        /**
+        * Clears the output, but not the input being typed.
+        */
+        void clearOutput();
+
+        // Implementations of ETerminal
+
+        void setTakeInput(bool value) override;
+        void clear() override;
+        void requestInput(TermInput &callback) override;
+        void cancelInputRequest(TermInput *callback) override;
+        void clearInputRequests() override;
+        void clearInput() override;
+        std::string pollInput() override;
+        void dispText(const std::string &str) override;
+        void flush() override;
+        void softFlush() override;
+    };
+}
+
+#endif
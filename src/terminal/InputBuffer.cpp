@@ -0,0 +1,189 @@
+#include "InputBuffer.h"
+
+#include <algorithm>
+
+etm::InputBuffer::InputBuffer(): escapes(0), revision(0) {
+}
+
+etm::InputBuffer::size_type etm::InputBuffer::countEscapes(size_type start, size_type count) const {
+    return std::count(text.begin() + start, text.begin() + (start + count), '\\');
+}
+
+void etm::InputBuffer::reindex(size_type offset, size_type inserted, size_type erased) {
+    const size_type editEnd = offset + inserted;
+    const size_type oldEditEnd = offset + erased;
+
+    // The first token that could've changed - one that ends
+    // right where the edit starts could be getting longer, as could
+    // one that ends in an escaped space that the edit splits
+    const tokens_t::iterator first = std::lower_bound(tokens.begin(), tokens.end(), offset,
+        [](const token &t, size_type value) -> bool {
+            return t.end + 1 < value;
+        }
+    );
+    // Old tokens that start after the edit can be reused
+    tokens_t::iterator reuse = std::lower_bound(first, tokens.end(), oldEditEnd,
+        [](const token &t, size_type value) -> bool {
+            return t.start < value;
+        }
+    );
+
+    // The token before ended at a space that wasn't quoted,
+    // so the scan can safely start there
+    size_type i = first == tokens.begin() ? 0 : (first - 1)->end;
+    size_type start = 0;
+    // If bypassing whitespace
+    bool waiting = true;
+    bool inString = false;
+    bool caughtUp = false;
+    scanned.clear();
+    while (i < text.size()) {
+        char c = text[i];
+        size_type step = 1;
+        // Escaped chars are taken as they are,
+        // except for newlines which become spaces
+        if (c == '\\') {
+            if (i + 1 >= text.size()) {
+                // Nothing's been escaped yet, so the shell wouldn't see it
+                break;
+            }
+            c = text[i + 1] == '\n' ? ' ' : text[i + 1];
+            step = 2;
+        }
+        if (c != ' ' || inString) {
+            if (waiting) {
+                if (i >= editEnd) {
+                    // If a token starts past the edit where an old one
+                    // did, everything after is the same as it was
+                    const size_type old = i - inserted + erased;
+                    while (reuse != tokens.end() && reuse->start < old) {
+                        ++reuse;
+                    }
+                    if (reuse != tokens.end() && reuse->start == old) {
+                        caughtUp = true;
+                        break;
+                    }
+                }
+                start = i;
+                waiting = false;
+            }
+            if (c == '\"') {
+                inString = !inString;
+            }
+        } else if (!waiting) {
+            scanned.push_back({start, i});
+            waiting = true;
+        }
+        i += step;
+    }
+    if (!caughtUp) {
+        if (!waiting) {
+            scanned.push_back({start, i});
+        }
+        reuse = tokens.end();
+    }
+
+    for (tokens_t::iterator it = reuse; it < tokens.end(); ++it) {
+        it->start = it->start + inserted - erased;
+        it->end = it->end + inserted - erased;
+    }
+    const tokens_t::difference_type at = first - tokens.begin();
+    tokens.erase(first, reuse);
+    tokens.insert(tokens.begin() + at, scanned.begin(), scanned.end());
+}
+
+void etm::InputBuffer::replace(size_type offset, size_type count, std::string_view str) {
+    offset = std::min(offset, text.size());
+    count = std::min(count, text.size() - offset);
+    escapes -= countEscapes(offset, count);
+    escapes += std::count(str.begin(), str.end(), '\\');
+    text.replace(offset, count, str.data(), str.size());
+    reindex(offset, str.size(), count);
+    revision++;
+}
+void etm::InputBuffer::insert(size_type offset, std::string_view str) {
+    replace(offset, 0, str);
+}
+void etm::InputBuffer::erase(size_type offset, size_type count) {
+    replace(offset, count, std::string_view());
+}
+void etm::InputBuffer::assign(std::string_view str) {
+    text.assign(str.data(), str.size());
+    tokens.clear();
+    escapes = countEscapes(0, text.size());
+    reindex(0, text.size(), 0);
+    revision++;
+}
+void etm::InputBuffer::clear() {
+    text.clear();
+    tokens.clear();
+    escapes = 0;
+    revision++;
+}
+
+void etm::InputBuffer::take(std::string &out) {
+    out.clear();
+    if (escapes) {
+        // Same as what the Terminal has always done
+        out.reserve(text.size());
+        bool escaped = false;
+        for (char c : text) {
+            if (escaped) {
+                escaped = false;
+                out.push_back(c == '\n' ? ' ' : c);
+            } else if (c == '\\') {
+                escaped = true;
+            } else {
+                out.push_back(c);
+            }
+        }
+    } else {
+        out.swap(text);
+    }
+    clear();
+}
+
+const std::string &etm::InputBuffer::getText() const {
+    return text;
+}
+etm::InputBuffer::size_type etm::InputBuffer::size() const {
+    return text.size();
+}
+bool etm::InputBuffer::hasEscapes() const {
+    return escapes != 0;
+}
+unsigned int etm::InputBuffer::getRevision() const {
+    return revision;
+}
+
+const etm::InputBuffer::tokens_t &etm::InputBuffer::getTokens() const {
+    return tokens;
+}
+std::size_t etm::InputBuffer::tokenAt(size_type offset) const {
+    const tokens_t::const_iterator loc = std::lower_bound(tokens.begin(), tokens.end(), offset,
+        [](const token &t, size_type value) -> bool {
+            return t.end < value;
+        }
+    );
+    if (loc == tokens.end() || loc->start > offset) {
+        return NONE;
+    }
+    return loc - tokens.begin();
+}
+void etm::InputBuffer::getToken(std::size_t index, std::string &out) const {
+    out.clear();
+    const token &t = tokens[index];
+    for (size_type i = t.start; i < t.end; i++) {
+        char c = text[i];
+        if (c == '\\') {
+            if (++i >= t.end) {
+                break;
+            }
+            c = text[i] == '\n' ? ' ' : text[i];
+        }
+        // The shell takes out quotes, even escaped ones
+        if (c != '\"') {
+            out.push_back(c);
+        }
+    }
+}
@@ -0,0 +1,161 @@
+#ifndef ETERMAL_INPUTBUFFER_H_INCLUDED
+#define ETERMAL_INPUTBUFFER_H_INCLUDED
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <cstddef>
+
+namespace etm {
+
+    /**
+    * The text of the input being typed into a @ref TextBuffer, kept
+    * apart from the rows that display it, so that it doesn't have to be
+    * read back out of them each time it's needed.
+    *
+    * Along with the text, it keeps an index of the tokens in it, split
+    * the way the @ref Shell splits them once escapes are filtered
+    * (see @ref term_input) - by spaces that aren't quoted.
+    * An edit only re-scans the tokens from the one before it up until
+    * the scan lines up with a token that came after it, from which point
+    * the old tokens are just shifted over. That's the token being typed
+    * in most cases, unless the edit opened or closed a quote.
+    * @see TextBuffer::getInput()
+    */
+    class InputBuffer {
+    public:
+        /// Byte offset into the text
+        typedef std::string::size_type size_type;
+        /// A token, as a range of the @e unfiltered text
+        struct token {
+            /// Offset of the first byte
+            size_type start;
+            /// Offset of the byte after the last
+            size_type end;
+        };
+        /// Type used for the token index
+        typedef std::vector<token> tokens_t;
+
+        /// Returned by @ref tokenAt(size_type offset)
+        /// if the offset isn't part of any token
+        static constexpr std::size_t NONE = static_cast<std::size_t>(-1);
+    private:
+        /// The input, as it was typed
+        std::string text;
+        /// Tokens of @ref text, in order
+        tokens_t tokens;
+        /// Tokens made by the last scan, before they're
+        /// moved into @ref tokens.
+        /// Kept so that the memory is reused.
+        tokens_t scanned;
+        /// Number of backslashes in @ref text, so that escapes
+        /// don't have to be looked for if there are none
+        size_type escapes;
+        /// Incremented on each change
+        /// @see getRevision()
+        unsigned int revision;
+
+        /**
+        * Counts the backslashes in a range of @ref text.
+        * @param [in] start The offset of the first byte
+        * @param [in] count The number of bytes
+        * @return The number of backslashes
+        */
+        size_type countEscapes(size_type start, size_type count) const;
+        /**
+        * Updates the token index after a range of @ref text
+        * was replaced.
+        * @param [in] offset Where the range starts
+        * @param [in] inserted The size of the new range
+        * @param [in] erased The size of the old range
+        */
+        void reindex(size_type offset, size_type inserted, size_type erased);
+    public:
+        /**
+        * Construct an empty input buffer.
+        */
+        InputBuffer();
+
+        /**
+        * Replaces a range of the text.
+        * @param [in] offset Where the range starts, clamped to the end
+        * @param [in] count The size of the range, clamped to the end
+        * @param [in] str What to replace it with
+        */
+        void replace(size_type offset, size_type count, std::string_view str);
+        /**
+        * Inserts text.
+        * @param [in] offset Where to insert it, clamped to the end
+        * @param [in] str The text
+        */
+        void insert(size_type offset, std::string_view str);
+        /**
+        * Erases text.
+        * @param [in] offset Where the range starts, clamped to the end
+        * @param [in] count The size of the range, clamped to the end
+        */
+        void erase(size_type offset, size_type count);
+        /**
+        * Replaces all of the text, re-scanning every token.
+        * @param [in] str The new text
+        */
+        void assign(std::string_view str);
+        /**
+        * Erases all of the text.
+        */
+        void clear();
+
+        /**
+        * Moves the text out of the buffer, with its escapes filtered
+        * (see @ref term_input), and clears it.
+        * If there aren't any escapes, the text is just moved.
+        * @param [out] out The input, as the shell sees it (replaced)
+        */
+        void take(std::string &out);
+
+        /**
+        * Gets the text, as it was typed.
+        * @return The text
+        */
+        const std::string &getText() const;
+        /**
+        * Gets the size of the text.
+        * @return The size, in bytes
+        */
+        size_type size() const;
+        /**
+        * Checks if there are any escapes in the text.
+        * @return `true` if there's at least one backslash
+        */
+        bool hasEscapes() const;
+        /**
+        * Gets the revision of the text. This changes each time
+        * the text does, so it can be used to tell if something
+        * computed from the text is out of date.
+        * @return The revision
+        */
+        unsigned int getRevision() const;
+
+        /**
+        * Gets the tokens of the text, in order.
+        * @return The token index
+        */
+        const tokens_t &getTokens() const;
+        /**
+        * Finds the token that contains an offset, or that ends at it
+        * (ex. the one the cursor is at the end of).
+        * @param [in] offset The offset
+        * @return Index into @ref getTokens(), or @ref NONE
+        */
+        std::size_t tokenAt(size_type offset) const;
+        /**
+        * Gets the text of a token as the shell sees it, with
+        * escapes filtered and quotes taken out.
+        * @param [in] index Index into @ref getTokens()
+        * @param [out] out The text (replaced)
+        */
+        void getToken(std::size_t index, std::string &out) const;
+    };
+}
+
+#endif
@@ -1,6 +1,7 @@
 #include "Line.h"
 
 #include <algorithm>
+#include <utility>
 
 #include "codec.h"
 
@@ -63,10 +64,15 @@ void etm::Line::iterator::operator--() {
         index -= ctrl::getJump() + 1;
     }
     index -= utf8::lookbehind(parent->getString(), index);
+    // Back to the start of the cluster
+    while (index > 1 && index < parent->dejureSize() && grapheme::testJoin(parent->getDejure(index - 1))) {
+        index -= 2;
+        index -= utf8::lookbehind(parent->getString(), index);
+    }
 }
 void etm::Line::iterator::operator++() {
     if (index >= parent->dejureSize()) return;
-    index += utf8::test(parent->getDejure(index));
+    index = parent->cellEnd(index);
     // Don't trust the offset given by the byte header.
     if (index >= parent->dejureSize()) return;
     while (ctrl::testStart(parent->getDejure(index))) {
@@ -75,8 +81,7 @@ void etm::Line::iterator::operator++() {
 }
 
 etm::Line::codepoint etm::Line::iterator::operator*() {
-    const int size = utf8::test(parent->getDejure(index));
-    return codepoint(parent->getString().begin() + index, parent->getString().begin() + (index + size));
+    return codepoint(parent->getString().begin() + index, parent->getString().begin() + parent->cellEnd(index));
 }
 
 etm::Line::size_type etm::Line::iterator::getIndex() const {
@@ -104,6 +109,12 @@ etm::Line::size_type etm::Line::findDefactoSize(const string_t::const_iterator &
     for (string_t::const_iterator it = start; it < end;) {
         if (ctrl::testStart(*it)) {
             it += ctrl::getJump() + 1;
+        } else if (grapheme::testJoin(*it)) {
+            // Part of the last cluster
+            it++;
+            if (it < end) {
+                it += utf8::test(*it);
+            }
         } else {
             it += utf8::test(*it);
             size++;
@@ -117,14 +128,31 @@ etm::Line::Line():
     newline(false),
     startSpace(false) {
 }
+etm::Line::Line(string_t &&string, size_type defactoSize, bool newline, bool startSpace):
+    string(std::move(string)),
+    defactoSize(defactoSize),
+    newline(newline),
+    startSpace(startSpace) {
+}
+
+etm::Line::size_type etm::Line::cellEnd(size_type index) {
+    index += utf8::test(string[index]);
+    while (index < string.size() && grapheme::testJoin(string[index])) {
+        index++;
+        if (index < string.size()) {
+            index += utf8::test(string[index]);
+        }
+    }
+    return index;
+}
 
 etm::Line::size_type etm::Line::correctIndex(size_type index) {
     size_type i = 0;
-    for (size_type cIndex = 0; cIndex < index;) {
+    for (size_type cIndex = 0; cIndex < index && i < string.size();) {
         if (ctrl::testStart(string[i])) {
-            i += ctrl::getJump();
+            i += ctrl::getJump() + 1;
         } else {
-            i += utf8::test(string[i]);
+            i = cellEnd(i);
             cIndex++;
         }
     }
@@ -133,6 +161,9 @@ etm::Line::size_type etm::Line::correctIndex(size_type index) {
     }
     return i;
 }
+etm::Line::size_type etm::Line::dejureIndex(size_type index) {
+    return std::min(correctIndex(index), string.size());
+}
 etm::Line::value_type &etm::Line::operator[](size_type index) {
     return string[correctIndex(index)];
 }
@@ -144,7 +175,13 @@ etm::Line::iterator etm::Line::last() {
     while (ctrl::testEnd(string[index])) {
         index -= ctrl::getJump() + 1;
     }
-    return iterator(this, index - utf8::lookbehind(string, index));
+    index -= utf8::lookbehind(string, index);
+    // Back to the start of the cluster
+    while (index > 1 && grapheme::testJoin(string[index - 1])) {
+        index -= 2;
+        index -= utf8::lookbehind(string, index);
+    }
+    return iterator(this, index);
 }
 
 etm::Line::iterator etm::Line::begin() {
@@ -187,10 +224,46 @@ void etm::Line::erase(const iterator &start) {
 }
 void etm::Line::eraseChar(size_type index) {
     index = correctIndex(index);
-    // Remove the entire codepoint
-    string.erase(index, utf8::test(string[index]));
+    // Remove the entire cluster
+    string.erase(index, cellEnd(index) - index);
     defactoSize--;
 }
+bool etm::Line::lastCluster(std::vector<unsigned int> &codepoints) {
+    codepoints.clear();
+    size_type end = string.size();
+    if (end > 0 && wide::testFiller(string[end - 1])) {
+        end--;
+    }
+    // Clusters don't carry on past control sequences
+    if (end == 0 || ctrl::testEnd(string[end - 1])) {
+        return false;
+    }
+    size_type start = end - 1;
+    start -= utf8::lookbehind(string, start);
+    while (start > 1 && grapheme::testJoin(string[start - 1])) {
+        start -= 2;
+        start -= utf8::lookbehind(string, start);
+    }
+    for (size_type i = start; i < end;) {
+        if (grapheme::testJoin(string[i])) {
+            i++;
+        } else {
+            const int size = utf8::test(string[i]);
+            codepoints.push_back(utf8::read(string, i, size));
+            i += size;
+        }
+    }
+    return true;
+}
+void etm::Line::extendCluster(const codepoint &c) {
+    // Goes before the filler of a wide cluster
+    size_type index = string.size();
+    if (index > 0 && wide::testFiller(string[index - 1])) {
+        index--;
+    }
+    string.insert(string.begin() + index, c.start, c.end);
+    string.insert(string.begin() + index, grapheme::JOIN);
+}
 void etm::Line::appendStr(const string_t &str) {
     string += str;
     defactoSize += findDefactoSize(str);
@@ -225,6 +298,28 @@ void etm::Line::copyTo(string_t &str) {
     str.insert(str.end(), string.begin(), string.end());
 }
 
+void etm::Line::copyTextTo(string_t &str) {
+    // Copy in spans between control blocks (and wide char
+    // fillers and cluster joins) rather than one codepoint at a time
+    size_type span = 0;
+    for (size_type i = 0; i < string.size();) {
+        if (ctrl::testStart(string[i])) {
+            str.append(string, span, i - span);
+            i += ctrl::getJump() + 1;
+            span = i;
+        } else if (wide::testFiller(string[i]) || grapheme::testJoin(string[i])) {
+            str.append(string, span, i - span);
+            i++;
+            span = i;
+        } else {
+            i++;
+        }
+    }
+    if (span < string.size()) {
+        str.append(string, span, string.size() - span);
+    }
+}
+
 void etm::Line::setNewline(bool value) {
     newline = value;
 }
@@ -15,6 +15,10 @@ namespace etm {
     * (so that UTF-8 char would actually have a length of 4).
     * This is important because when accessing a line index, the caller
     * only cares about contiguous characters, not their byte sizes.
+    * Wide chars are followed by a filler (see @ref wide::FILLER),
+    * so the deFacto index is also the column on the screen.
+    * A grapheme cluster (see @ref grapheme::JOIN) is a single
+    * deFacto char, however many codepoints it's made of.
     * @see TextBuffer
     */
     class Line {
@@ -31,6 +35,8 @@ namespace etm {
         /**
         * Dual iterators that describe a range containing
         * an encoded codepoint in a string.
+        * When taken from a line, that's a whole grapheme cluster,
+        * joins included.
         * @note This goes without saying, but the iterators
         * @ref start and @ref end must be valid when passing
         * this object to a function.
@@ -200,6 +206,13 @@ namespace etm {
         */
         size_type correctIndex(size_type index);
         /**
+        * Find the end of the cell (codepoint, and any
+        * others joined to it) starting at an index.
+        * @param [in] index The @e deJure index of the cell
+        * @return The @e deJure index after the cell
+        */
+        size_type cellEnd(size_type index);
+        /**
         * Erase all characters from `index` to the end of the line.
         * @param [in] index The @e deJure index
         * @see erase(size_type index)
@@ -228,6 +241,18 @@ namespace etm {
         static constexpr size_type max = std::numeric_limits<size_type>::max() / 2;
         Line();
         /**
+        * Construct a line from its raw parts, ex. from
+        * a saved session.
+        * @warning `defactoSize` is trusted and not checked
+        * against `string`, which must already be a valid line
+        * string (see @ref getString())
+        * @param [in] string The internal string
+        * @param [in] defactoSize The @e deFacto size of `string`
+        * @param [in] newline Whether the line is terminated by a newline
+        * @param [in] startSpace Whether the line starts with a zero length space
+        */
+        Line(string_t &&string, size_type defactoSize, bool newline, bool startSpace);
+        /**
         * Access the codepoint header of the codepoint starting
         * at the @e deFacto index.
         * @param [in] index The @e deFacto index of the codepoint
@@ -302,6 +327,22 @@ namespace etm {
         */
         void eraseChar(size_type index);
         /**
+        * Gets the codepoints of the last grapheme cluster in the line,
+        * to check if the next codepoint continues it.
+        * @param [out] codepoints The codepoints of the cluster
+        * @return `false` if the line doesn't end with a cluster
+        * (it's empty, or ends with a control sequence)
+        * @see grapheme::continues()
+        */
+        bool lastCluster(std::vector<unsigned int> &codepoints);
+        /**
+        * Joins a codepoint to the last grapheme cluster in the line.
+        * Doesn't change the @e deFacto size.
+        * @param [in] c The codepoint
+        * @see lastCluster(std::vector<unsigned int> &codepoints)
+        */
+        void extendCluster(const codepoint &c);
+        /**
         * Appends a UTF-8 encoded string to the end of the line.
         * @param [in] str The string to append
         */
@@ -348,6 +389,14 @@ namespace etm {
         * @param [out] str String to append to
         */
         void copyTo(string_t &str);
+        /**
+        * Append this line's text to `str`, without any of the
+        * control sequences, wide char fillers or cluster joins.
+        * @note Does not include the start space or newline
+        * @param [out] str String to append to
+        * @see copyTo(string_t &str)
+        */
+        void copyTextTo(string_t &str);
 
         /**
         * Set whether this line is terminated with a newline (`\n`).
@@ -383,6 +432,14 @@ namespace etm {
         */
         value_type &getDejure(size_type index);
         /**
+        * Convert a @e deFacto index to a @e deJure index.
+        * Indices past the end are clamped to @ref dejureSize().
+        * @param [in] index The @e deFacto index
+        * @return The @e deJure index of the codepoint, after any
+        * control sequences that precede it
+        */
+        size_type dejureIndex(size_type index);
+        /**
         * Gets the byte size of the line, the @e deJure size.
         * @return The byte size
         * @see size()
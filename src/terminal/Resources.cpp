@@ -8,6 +8,7 @@
 
 etm::Resources::contextdata_t::contextdata_t(Resources *parent):
     textShader(parent),
+    cellShader(parent),
     primitiveShader(parent),
     textureShader(parent),
     termFramebufferTex({GL_CLAMP_TO_BORDER, GL_CLAMP_TO_BORDER, GL_LINEAR, GL_LINEAR})
@@ -35,6 +36,8 @@ void etm::Resources::errNotInit(const char *location) {
 void etm::Resources::init() {
     shader::Shader::State shaderState;
 
+    // New programs may reuse the names of old ones
+    glState.clear();
     contextData.reset(new contextdata_t(this));
     genRectangle();
     genTriangle();
@@ -42,6 +45,7 @@ void etm::Resources::init() {
 
 void etm::Resources::deInit() {
     contextData.reset();
+    glState.clear();
 }
 
 void etm::Resources::setFont(const font_t &font) {
@@ -67,14 +71,18 @@ void etm::Resources::genRectangle() {
         1, 2, 3  // second triangle
     };
 
-    contextData->rectangle.setVerticies(16, vertices);
-    contextData->rectangle.setIndices(6, indices);
-    // First param, two values, stride of 4
-    // to get to the next set, starts at index 0
-    contextData->rectangle.setParam(0, 2, 4, 0);
-    // Second param, two values, stride of 4
-    // to get to the next set, starts at index 2
-    contextData->rectangle.setParam(1, 2, 4, 2);
+    for (Buffer *quad : {&contextData->rectangle, &contextData->cells}) {
+        quad->setVerticies(16, vertices);
+        quad->setIndices(6, indices);
+        // First param, two values, stride of 4
+        // to get to the next set, starts at index 0
+        quad->setParam(0, 2, 4, 0);
+        // Second param, two values, stride of 4
+        // to get to the next set, starts at index 2
+        quad->setParam(1, 2, 4, 2);
+    }
+    // `cells` is still bound from the last setParam
+    shader::Cell::enableInstances();
 }
 
 void etm::Resources::genTriangle() {
@@ -240,10 +248,28 @@ void etm::Resources::renderTriangle() {
     renderRectangle();
 }
 
+std::size_t etm::Resources::streamCells(const shader::Cell::instance *instances, std::size_t count) {
+    return contextData->cellInstances.write(instances, count * sizeof(shader::Cell::instance));
+}
+void etm::Resources::renderCells(std::size_t offset, int count) {
+    ETM_PROFILE(profiler.countDraw(count));
+    contextData->cells.bindArray();
+    contextData->cellInstances.bind();
+    shader::Cell::setInstances(offset);
+    contextData->cells.renderInstanced(count);
+}
+void etm::Resources::fenceCells() {
+    contextData->cellInstances.fence();
+}
+
 void etm::Resources::bindTextShader() {
     currentShader = &contextData->textShader;
     currentShader->use();
 }
+void etm::Resources::bindCellShader() {
+    currentShader = &contextData->cellShader;
+    currentShader->use();
+}
 void etm::Resources::bindPrimitiveShader() {
     currentShader = &contextData->primitiveShader;
     currentShader->use();
@@ -255,6 +281,28 @@ void etm::Resources::bindTextureShader() {
 etm::shader::Shader &etm::Resources::getShader() {
     return *currentShader;
 }
+etm::shader::Cell &etm::Resources::getCellShader() {
+    return contextData->cellShader;
+}
+etm::Profiler &etm::Resources::getProfiler() {
+    return profiler;
+}
+void etm::Resources::beginProfile() {
+    unsigned long long frame;
+    double gpu;
+    while (contextData->gpuTimer.poll(frame, gpu)) {
+        profiler.setGpuTime(frame, gpu);
+    }
+    profiler.beginFrame();
+    contextData->gpuTimer.begin(profiler.getFrameNumber());
+}
+void etm::Resources::endProfile() {
+    contextData->gpuTimer.end();
+    profiler.endFrame();
+}
+etm::GLState &etm::Resources::getGLState() {
+    return glState;
+}
 
 void etm::Resources::bindTermFramebuffer() {
     contextData->termFramebuffer.bind();
@@ -5,12 +5,17 @@
 #include <string>
 
 #include "render/Buffer.h"
+#include "render/StreamBuffer.h"
 #include "render/EtmFont.h"
 #include "render/Texture.h"
 #include "shader/Primitive.h"
 #include "shader/Text.h"
+#include "shader/Cell.h"
 #include "shader/Texture.h"
 #include "render/Framebuffer.h"
+#include "render/GLState.h"
+#include "render/GpuTimer.h"
+#include "util/Profiler.h"
 
 namespace etm {
     // shader/Shader
@@ -36,11 +41,19 @@ namespace etm {
         struct contextdata_t {
             /// Basic 2D quad
             Buffer rectangle;
+            /// The same quad as @ref rectangle, with its
+            /// own vertex array that has the @ref shader::Cell
+            /// per-instance attributes enabled.
+            Buffer cells;
+            /// Per-frame instance data for @ref cells
+            StreamBuffer cellInstances;
             /// Anti-aliased triangle texture
             Texture triangle;
 
             /// @see shader::Text
             shader::Text textShader;
+            /// @see shader::Cell
+            shader::Cell cellShader;
             /// @see shader::Primitive
             shader::Primitive primitiveShader;
             /// @see shader::Texture
@@ -54,6 +67,9 @@ namespace etm {
             /// @see initTex()
             Texture termFramebufferTex;
 
+            /// Times frames on the GPU, for the @ref profiler
+            GpuTimer gpuTimer;
+
             contextdata_t(Resources *parent);
         };
 
@@ -61,6 +77,12 @@ namespace etm {
 
         /// Used font
         font_t font;
+        /// Tracks the GL state, so that redundant calls can be skipped.
+        /// Active while the terminal renders.
+        GLState glState;
+        /// Records how long rendering takes.
+        /// Only used if built with `ETERMAL_PROFILE`.
+        Profiler profiler;
 
         /// The active shader.
         /// Only ever bound if the shader is made
@@ -77,7 +99,7 @@ namespace etm {
         */
         void errNotInit(const char *location);
         /**
-        * Generate @ref rectangle
+        * Generate @ref rectangle and @ref cells
         */
         void genRectangle();
         /**
@@ -153,6 +175,30 @@ namespace etm {
         */
         void renderTriangle();
 
+        /**
+        * Uploads this frame's cell instances.
+        * @param [in] instances The instances
+        * @param [in] count Number of instances
+        * @return Byte offset of the instances, to be
+        * given to @ref renderCells(std::size_t offset, int count)
+        * @see fenceCells()
+        */
+        std::size_t streamCells(const shader::Cell::instance *instances, std::size_t count);
+        /**
+        * Renders cell instances previously uploaded with
+        * @ref streamCells(const shader::Cell::instance *instances, std::size_t count)
+        * @note Doesn't set any shaders. Requires that the cell
+        * shader be set [@ref bindCellShader()]
+        * @param [in] offset Byte offset of the first instance
+        * @param [in] count Number of instances
+        */
+        void renderCells(std::size_t offset, int count);
+        /**
+        * Signals that all of the frame's cells have been rendered,
+        * so that the instance data can eventually be reused.
+        */
+        void fenceCells();
+
         /**
         * Binds the @ref textShader, making it
         * the current OpenGL shader program, and setting
@@ -160,6 +206,13 @@ namespace etm {
         */
         void bindTextShader();
         /**
+        * Binds the @ref cellShader, making it
+        * the current OpenGL shader program, and setting
+        * it as the return value of @ref getShader().
+        * @see getCellShader()
+        */
+        void bindCellShader();
+        /**
         * Binds the @ref primitiveShader, making it
         * the current OpenGL shader program, and setting
         * it as the return value of @ref getShader().
@@ -178,6 +231,36 @@ namespace etm {
         * @return The shader
         */
         shader::Shader &getShader();
+        /**
+        * Gets the cell shader, for setting its
+        * frame and cell values.
+        * @return The @ref cellShader
+        * @see bindCellShader()
+        */
+        shader::Cell &getCellShader();
+        /**
+        * Gets the GL state tracker.
+        * @return The tracker
+        * @see GLState::Scope
+        */
+        GLState &getGLState();
+        /**
+        * Gets the render profiler.
+        * @return The profiler
+        */
+        Profiler &getProfiler();
+        /**
+        * Starts profiling a frame, on the CPU and GPU.
+        * Also picks up the GPU times of earlier frames
+        * that have come in since.
+        * @see endProfile()
+        */
+        void beginProfile();
+        /**
+        * Finishes profiling the frame.
+        * @see beginProfile()
+        */
+        void endProfile();
 
         /**
         * Binds the terminal's framebuffer
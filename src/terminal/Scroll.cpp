@@ -81,3 +81,8 @@ void etm::Scroll::scrollByAlign(int ammount) {
 void etm::Scroll::jump() {
     offset = maxOffset;
 }
+
+void etm::Scroll::setOffset(float value) {
+    offset = std::max(std::min(value, maxOffset), 0.0f);
+    alignBuffer = 0;
+}
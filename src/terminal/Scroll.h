@@ -106,6 +106,13 @@ namespace etm {
         * Set the current scroll offset to the max offset.
         */
         void jump();
+        /**
+        * Set the current scroll offset directly,
+        * ex. when restoring a saved session.
+        * The value is clamped to [0, @ref maxOffset].
+        * @param [in] value The new offset
+        */
+        void setOffset(float value);
     };
 }
 
@@ -0,0 +1,150 @@
+#include "SearchIndex.h"
+
+#include <algorithm>
+
+char etm::SearchIndex::fold(char c) {
+    if ('A' <= c && c <= 'Z') {
+        return c | 0x20;
+    }
+    return c;
+}
+
+etm::SearchIndex::gram_t etm::SearchIndex::gram(char a, char b, char c) {
+    return
+        (static_cast<gram_t>(static_cast<unsigned char>(fold(a))) << 16) |
+        (static_cast<gram_t>(static_cast<unsigned char>(fold(b))) << 8) |
+        static_cast<gram_t>(static_cast<unsigned char>(fold(c)));
+}
+
+etm::SearchIndex::SearchIndex(): offset(0), indexed(0), stale(0), total(0) {
+}
+
+void etm::SearchIndex::invalidate(row_t row) {
+    indexed = std::min(indexed, row);
+}
+
+void etm::SearchIndex::popFront() {
+    if (rowGrams.size()) {
+        stale += rowGrams.front().size();
+        rowGrams.pop_front();
+    }
+    if (indexed) {
+        indexed--;
+    }
+    offset++;
+    // Entries for trimmed rows are at the front of each list, which
+    // is expensive to erase from - so let them pile up for a bit
+    if (stale > 1024 && stale * 2 > total) {
+        compact();
+    }
+}
+
+void etm::SearchIndex::clear() {
+    postings.clear();
+    rowGrams.clear();
+    offset = 0;
+    indexed = 0;
+    stale = 0;
+    total = 0;
+}
+
+void etm::SearchIndex::compact() {
+    for (auto it = postings.begin(); it != postings.end();) {
+        postings_t &list = it->second;
+        list.erase(list.begin(), std::lower_bound(list.begin(), list.end(), offset));
+        if (list.empty()) {
+            it = postings.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    total -= stale;
+    stale = 0;
+}
+
+void etm::SearchIndex::popBack() {
+    const id_t id = offset + rowGrams.size() - 1;
+    for (gram_t g : rowGrams.back()) {
+        auto it = postings.find(g);
+        // Rows are removed last to first, so this row
+        // will always be at the back of the list
+        if (it != postings.end() && it->second.size() && it->second.back() == id) {
+            it->second.pop_back();
+            total--;
+            if (it->second.empty()) {
+                postings.erase(it);
+            }
+        }
+    }
+    rowGrams.pop_back();
+}
+
+void etm::SearchIndex::pushBack(lines_t &lines, row_t row) {
+    std::string text;
+    // The start space is part of the row's text,
+    // as far as searching is concerned
+    if (lines[row].hasStartSpace()) {
+        text.push_back(' ');
+    }
+    lines[row].copyTextTo(text);
+    // Include the first two bytes of the next row if this
+    // one was soft wrapped, for the trigrams that cross over
+    if (!lines[row].hasNewline() && row + 1 < lines.size()) {
+        std::string::size_type size = text.size();
+        if (lines[row + 1].hasStartSpace()) {
+            text.push_back(' ');
+        }
+        lines[row + 1].copyTextTo(text);
+        text.erase(std::min(text.size(), size + 2));
+    }
+
+    std::vector<gram_t> grams;
+    if (text.size() >= 3) {
+        grams.reserve(text.size() - 2);
+        for (std::string::size_type i = 0; i + 2 < text.size(); i++) {
+            grams.push_back(gram(text[i], text[i + 1], text[i + 2]));
+        }
+        std::sort(grams.begin(), grams.end());
+        grams.erase(std::unique(grams.begin(), grams.end()), grams.end());
+    }
+
+    const id_t id = offset + rowGrams.size();
+    for (gram_t g : grams) {
+        postings[g].push_back(id);
+    }
+    total += grams.size();
+    rowGrams.push_back(std::move(grams));
+}
+
+void etm::SearchIndex::sync(lines_t &lines) {
+    while (rowGrams.size() > indexed) {
+        popBack();
+    }
+    for (row_t r = rowGrams.size(); r < lines.size(); r++) {
+        pushBack(lines, r);
+    }
+    indexed = lines.size();
+}
+
+void etm::SearchIndex::find(const std::string &needle, std::vector<row_t> &rows) {
+    rows.clear();
+    if (needle.size() < 3) {
+        return;
+    }
+    // Every match contains every trigram in the needle, so only
+    // the rows where the rarest one starts have to be looked at
+    const postings_t *rarest = nullptr;
+    for (std::string::size_type i = 0; i + 2 < needle.size(); i++) {
+        auto it = postings.find(gram(needle[i], needle[i + 1], needle[i + 2]));
+        if (it == postings.end()) {
+            // Can't be anywhere
+            return;
+        }
+        if (rarest == nullptr || it->second.size() < rarest->size()) {
+            rarest = &it->second;
+        }
+    }
+    for (auto it = std::lower_bound(rarest->begin(), rarest->end(), offset); it < rarest->end(); ++it) {
+        rows.push_back(static_cast<row_t>(*it - offset));
+    }
+}
@@ -0,0 +1,128 @@
+#ifndef ETERMAL_SEARCHINDEX_H_INCLUDED
+#define ETERMAL_SEARCHINDEX_H_INCLUDED
+
+#include <vector>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <cstdint>
+
+#include "Line.h"
+
+namespace etm {
+
+    /**
+    * An incremental trigram index over the rows of a @ref TextBuffer.
+    * Every row is broken up into (case folded) byte trigrams,
+    * each of which is mapped to a sorted list of the rows that contain it.
+    * Lookups then only have to look at the rows that contain the rarest
+    * trigram of the query, as opposed to every row in the scrollback.
+    *
+    * Rows are identified internally via an ID that doesn't change when
+    * rows are trimmed from the front, similar to how @ref IdList works.
+    * This means that trimming the oldest rows is constant, and only
+    * rows that actually changed ever have to be re-indexed.
+    *
+    * Trigrams that cross a soft wrap (the row isn't terminated by a newline)
+    * are credited to the row in which they start, so that a match that was
+    * wrapped onto multiple rows can still be found. A row's start space counts
+    * as the first byte of its text, as it does when the rows are searched.
+    * @see TextBuffer::search(const std::string &query, searchFlag::type flags)
+    */
+    class SearchIndex {
+    public:
+        /// The rows that are indexed
+        typedef std::vector<Line> lines_t;
+        /// Index in the row list
+        typedef lines_t::size_type row_t;
+        /// An encoded trigram
+        typedef std::uint32_t gram_t;
+        /// Row ID that remains stable when rows are trimmed from the front
+        typedef std::uint64_t id_t;
+        /// Rows that contain a trigram, ascending
+        typedef std::vector<id_t> postings_t;
+    private:
+        /// Row ID lists for each trigram
+        std::unordered_map<gram_t, postings_t> postings;
+        /// The trigrams that each row contributed to @ref postings,
+        /// used to un-index a row without having to read it again.
+        std::deque<std::vector<gram_t>> rowGrams;
+        /// The ID of the first row
+        id_t offset;
+        /// Number of rows, starting from the first, that have a
+        /// valid entry in @ref rowGrams
+        row_t indexed;
+        /// Number of entries in @ref postings that refer to rows
+        /// that have been trimmed
+        std::size_t stale;
+        /// Total number of entries in @ref postings
+        std::size_t total;
+
+        /**
+        * Removes the last row in @ref rowGrams from the index.
+        */
+        void popBack();
+        /**
+        * Adds a row to the end of @ref rowGrams and the index.
+        * @param [in] lines The rows
+        * @param [in] row The row to index
+        */
+        void pushBack(lines_t &lines, row_t row);
+        /**
+        * Erases all entries in @ref postings that refer to trimmed rows.
+        */
+        void compact();
+    public:
+
+        /**
+        * Folds a byte to lowercase, if it's ASCII.
+        * @param [in] c The byte
+        * @return The folded byte
+        */
+        static char fold(char c);
+        /**
+        * Encodes a trigram.
+        * @param [in] a The first byte
+        * @param [in] b The second byte
+        * @param [in] c The third byte
+        * @return The trigram
+        */
+        static gram_t gram(char a, char b, char c);
+
+        /**
+        * Creates an empty index.
+        */
+        SearchIndex();
+
+        /**
+        * Marks the given row and all rows after it as changed.
+        * The index isn't updated until the next call to @ref sync(lines_t &lines).
+        * @param [in] row The first changed row
+        */
+        void invalidate(row_t row);
+        /**
+        * Notifies the index that the first row was removed.
+        */
+        void popFront();
+        /**
+        * Drops all indexed rows.
+        */
+        void clear();
+        /**
+        * Re-index all rows that have changed since the last sync.
+        * @param [in] lines The rows, as they are now
+        */
+        void sync(lines_t &lines);
+
+        /**
+        * Finds all rows in which the rarest trigram of the
+        * given (already case folded) string starts.
+        * @note Only fully works after a call to @ref sync(lines_t &lines)
+        * @param [in] needle The text to look for, must be at least 3 bytes long
+        * @param [out] rows Rows that may contain `needle`, ascending
+        */
+        void find(const std::string &needle, std::vector<row_t> &rows);
+    };
+}
+
+#endif
@@ -2,13 +2,22 @@
 
 #include "render/Model.h"
 
-etm::State::State() {
+etm::State::State(bool preserve): preserve(preserve) {
     store();
 }
 etm::State::~State() {
     restore();
 }
 void etm::State::store() {
+    if (!preserve) {
+        depth = GL_TRUE;
+        blend = GL_TRUE;
+        cull = GL_TRUE;
+        program = 0;
+        unpackAlign = 0;
+        activeTexture = 0;
+        return;
+    }
     // All have the same z, so no depth test
     glGetBooleanv(GL_DEPTH_TEST, &depth);
     // If alpha blend is true, will give
@@ -42,6 +51,9 @@ void etm::State::set() {
     }
 }
 void etm::State::restore() {
+    if (!preserve) {
+        return;
+    }
     if (depth == GL_TRUE) {
         glEnable(GL_DEPTH_TEST);
     }
@@ -18,9 +18,17 @@ namespace etm {
     * upon destruction, resores those values.
     * This is to prevent a state from being messed
     * up because someone decided to throw.
+    *
+    * Storing the state requires querying OpenGL, which can stall
+    * the pipeline; if the caller doesn't care about their state
+    * being preserved, that can be turned off.
     * @see Terminal
+    * @see Terminal::setStatePreservation(bool value)
     */
     class State: public singleton {
+        /// Whether the stored state is restored.
+        /// If `false`, nothing is queried or restored.
+        bool preserve;
         /// GL_DEPTH_TEST toggle value
         GLboolean depth;
         /// GL_BLEND toggle value
@@ -36,14 +44,18 @@ namespace etm {
     public:
         /**
         * Constructs and calls @ref store()
+        * @param [in] preserve If `false`, the current state is not
+        * queried, and will not be restored
         */
-        State();
+        State(bool preserve = true);
         /**
         * Destructs and calls @ref restore()
         */
         ~State();
         /**
-        * Manually store the current state into fields
+        * Manually store the current state into fields.
+        * If the state isn't being preserved, assumes the worst
+        * so that @ref set() sets everything.
         * @see State()
         */
         void store();
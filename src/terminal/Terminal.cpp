@@ -3,6 +3,14 @@
 #include <iostream>
 #include <algorithm>
 #include <cmath>
+#include <cerrno>
+#include <cstring>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
 
 #include "util/termError.h"
 #include "render/opengl.h"
@@ -13,6 +21,7 @@
 #include "Line.h"
 #include "Resources.h"
 #include "util/debug.h"
+#include "util/Profiler.h"
 
 #include "textmods/Mod.h"
 #include "textmods/mods.h"
@@ -65,7 +74,11 @@ etm::Terminal::Terminal(const errCallback_t &errorCallback, bool postponeInit):
     shell(nullptr),
     dragging(false),
     framebufValid(false),
-    isInit(false)
+    fontRevision(0),
+    preserveState(true),
+    isInit(false),
+    linted(false),
+    lintRevision(0)
 {
     if (!postponeInit) {
         init();
@@ -115,7 +128,13 @@ dragging(std::move(other.dragging)),
 dragX(std::move(other.dragX)),
 dragY(std::move(other.dragY)),
 framebufValid(std::move(other.framebufValid)),
-isInit(std::move(other.isInit))
+fontRevision(std::move(other.fontRevision)),
+preserveState(std::move(other.preserveState)),
+isInit(std::move(other.isInit)),
+linted(std::move(other.linted)),
+lintRevision(std::move(other.lintRevision)),
+lintFlags(std::move(other.lintFlags)),
+lintMarks(std::move(other.lintMarks))
 {
     finishMove(other);
 }
@@ -143,7 +162,13 @@ etm::Terminal &etm::Terminal::operator=(Terminal &&other) {
     dragY = std::move(other.dragY);
     windowSetCursorIBeam = std::move(other.windowSetCursorIBeam);
     framebufValid = std::move(other.framebufValid);
+    fontRevision = std::move(other.fontRevision);
+    preserveState = std::move(other.preserveState);
     isInit = std::move(other.isInit);
+    linted = std::move(other.linted);
+    lintRevision = std::move(other.lintRevision);
+    lintFlags = std::move(other.lintFlags);
+    lintMarks = std::move(other.lintMarks);
 
     finishMove(other);
 
@@ -210,6 +235,39 @@ bool etm::Terminal::acceptInput() {
     return takeInput || inputRequests.size();
 }
 
+void etm::Terminal::lintInput() {
+    const bool marked = lintMarks.size();
+    if (shell == nullptr || !takeInput || inputRequests.size()) {
+        linted = false;
+        if (marked) {
+            lintMarks.clear();
+            display.setInputMarks(lintMarks);
+            invalidate();
+        }
+        return;
+    }
+    const InputBuffer &input = display.getInput();
+    if (linted && input.getRevision() == lintRevision) {
+        return;
+    }
+    linted = true;
+    lintRevision = input.getRevision();
+
+    const InputBuffer::tokens_t &tokens = input.getTokens();
+    lintFlags.assign(tokens.size(), false);
+    shell->lint(input, lintFlags);
+    lintMarks.clear();
+    for (std::size_t i = 0; i < tokens.size(); i++) {
+        if (lintFlags[i]) {
+            lintMarks.push_back(tokens[i]);
+        }
+    }
+    display.setInputMarks(lintMarks);
+    if (marked || lintMarks.size()) {
+        invalidate();
+    }
+}
+
 
 /// 0------------- streambuf overrides -----------------0
 
@@ -273,36 +331,11 @@ int etm::Terminal::overflow(int c) {
 void etm::Terminal::pushInput(const std::string &input) {
     display.setCursorEnabled(false);
 
-    // For convineince
-    typedef std::string::const_iterator iterator_t;
-
-    std::string filtered;
-    filtered.reserve(input.size());
-    bool escaped = false;
-    for (iterator_t it = input.begin(); it < input.end(); ++it) {
-        // Don't need to check for codepoint headers
-        // because a value of a header can only ever be < 128
-        // if it's a one-length ASCII char, and we only ever
-        // check ASCII chars.
-        if (escaped) {
-            escaped = false;
-            if (*it == '\n') {
-                filtered.push_back(' ');
-            } else {
-                filtered.push_back(*it);
-            }
-        } else if (*it == '\\') {
-            escaped = true;
-        } else {
-            filtered.push_back(*it);
-        }
-    }
-
     if (inputRequests.size()) {
-        inputRequests.front()->terminalInput(filtered);
+        inputRequests.front()->terminalInput(input);
         inputRequests.pop_front();
     } else if (shell != nullptr) {
-        shell->input(filtered);
+        shell->input(input);
     } else {
         resources->postError(
             "Terminal::flushInputBuffer()",
@@ -363,6 +396,10 @@ void etm::Terminal::setBackgroundColor(const Color &color) {
 void etm::Terminal::setTextColor(const Color &color) {
     display.setDefForeGColor(color);
 }
+void etm::Terminal::setLintColor(const Color &color) {
+    display.setMarkColor(color);
+    invalidate();
+}
 
 void etm::Terminal::setScrollSensitivity(float value) {
     scrollSensitivity = value;
@@ -456,6 +493,9 @@ void etm::Terminal::flush() {
 void etm::Terminal::softFlush() {
     constexpr char ESCAPE = '\x1b';
 
+    ETM_PROFILE_SCOPE(resources->getProfiler(), Profiler::FLUSH);
+    ETM_PROFILE(resources->getProfiler().countBytes(displayBuffer.size()));
+
     // Required when appending
     display.prepare();
 
@@ -514,7 +554,7 @@ void etm::Terminal::softFlush() {
 }
 
 bool etm::Terminal::shouldUpdate() {
-    return !framebufValid || cursorBlink.hasEnded();
+    return !framebufValid || cursorBlink.hasEnded() || resources->getFont()->getRevision() != fontRevision;
 }
 
 void etm::Terminal::setX(float x) {
@@ -555,6 +595,13 @@ void etm::Terminal::setMaxLines(TextBuffer::lines_number_t count) {
     display.setMaxLines(count);
 }
 
+void etm::Terminal::setStatePreservation(bool value) {
+    preserveState = value;
+}
+etm::GLState::stats etm::Terminal::getGLStats() {
+    return resources->getGLState().getStats();
+}
+
 void etm::Terminal::updatePosition() {
     background.setX(0);
     background.setY(0);
@@ -602,7 +649,8 @@ void etm::Terminal::doInputChar(const Line::codepoint &c) {
                 case '\n': {
                     // Don't actually include the newline
                     // in the input
-                    std::string input = display.pollInput();
+                    std::string input;
+                    display.takeInput(input);
                     display.append(c);
                     pushInput(input);
                     break;
@@ -667,6 +715,14 @@ void etm::Terminal::inputActionKey(actionKey key) {
         case RIGHT:
             display.moveCursorCollumnWrap(1);
             break;
+        case INTERRUPT:
+            shell->interrupt();
+            break;
+        case TAB:
+            if (takeInput) {
+                shell->complete();
+            }
+            break;
         // Ignore if there's no match
     }
 }
@@ -718,10 +774,29 @@ void etm::Terminal::mapCoords(float x, float y, TextBuffer::lines_number_t &row,
 
 void etm::Terminal::render() {
     // Preserve caller state (important!)
-    State state;
+    State state(preserveState);
     state.set();
+    // Skip calls that wouldn't change anything
+    GLState::Scope glScope(resources->getGLState());
 
     resources->setTerminal(*this);
+    ETM_PROFILE(resources->beginProfile());
+
+    // Pick up glyphs that finished rendering in the background
+    const unsigned int revision = resources->getFont()->getRevision();
+    if (revision != fontRevision) {
+        ETM_PROFILE_SCOPE(resources->getProfiler(), Profiler::UPLOAD);
+        fontRevision = revision;
+        resources->getFont()->update();
+        invalidate();
+    }
+
+    // Let the shell show output from background commands
+    if (shell != nullptr) {
+        shell->update();
+    }
+
+    lintInput();
 
     // Run animiations
 
@@ -754,9 +829,7 @@ void etm::Terminal::render() {
         resources->bindPrimitiveShader();
         background.render();
         scrollbar.render();
-        // After scrollbar renders, the text shader is set
-        // due to the rendering of the triangle textures,
-        // so display doesn't need to set it.
+        // Binds the cell shader itself
         display.render();
 
         // Revalidate cache (important!)
@@ -765,18 +838,23 @@ void etm::Terminal::render() {
         glViewport(callerViewport[0], callerViewport[1], callerViewport[2], callerViewport[3]);
     }
 
-    // We won't be changing the viewport
-    resources->initViewport();
+    {
+        ETM_PROFILE_SCOPE(resources->getProfiler(), Profiler::DRAW);
 
-    resources->bindTextureShader();
-    resources->bindTermFramebufferTex();
-    viewport.set(resources);
-    resources->renderRectangle();
+        // We won't be changing the viewport
+        resources->initViewport();
 
-    // Redering the cursor every time isn't a big deal,
-    // and we have to isolate it anyways because it's
-    // an animation
-    display.renderCursor(viewport.x, viewport.y);
+        resources->bindTextureShader();
+        resources->bindTermFramebufferTex();
+        viewport.set(resources);
+        resources->renderRectangle();
+
+        // Redering the cursor every time isn't a big deal,
+        // and we have to isolate it anyways because it's
+        // an animation
+        display.renderCursor(viewport.x, viewport.y);
+    }
+    ETM_PROFILE(resources->endProfile());
 
     // Check for errors
 
@@ -803,9 +881,113 @@ std::string etm::Terminal::getTextSelection() {
     return display.getSelectionText();
 }
 
+std::vector<etm::Profiler::frame> etm::Terminal::getStats() {
+    return resources->getProfiler().getFrames();
+}
+
+void etm::Terminal::writeTrace(std::ostream &stream) {
+    resources->getProfiler().writeTrace(stream);
+}
+
 std::string etm::Terminal::getText() {
     return display.getTextFromRange(
         TextBuffer::pos(0, 0),
         TextBuffer::pos(display.getCountRows() + 1, 0)
     );
 }
+
+void etm::Terminal::exportText(const TextBuffer::sink_t &sink, bool styled) {
+    display.exportText(
+        TextBuffer::pos(0, 0),
+        TextBuffer::pos(display.getCountRows() + 1, 0),
+        sink,
+        styled
+    );
+}
+
+void etm::Terminal::exportText(std::ostream &stream, bool styled) {
+    exportText([&stream](const char *data, std::size_t size) {
+        stream.write(data, size);
+    }, styled);
+}
+
+bool etm::Terminal::exportText(int fd, bool styled) {
+    // Large enough that most exports are only a few writes
+    constexpr std::string::size_type chunkSize = 1 << 16;
+
+    std::string chunk;
+    chunk.reserve(chunkSize);
+    bool good = true;
+
+    auto writeChunk = [&]() {
+        for (std::string::size_type written = 0; good && written < chunk.size();) {
+#ifdef _WIN32
+            const int result = _write(fd, chunk.data() + written, static_cast<unsigned int>(chunk.size() - written));
+#else
+            const ssize_t result = write(fd, chunk.data() + written, chunk.size() - written);
+#endif
+            if (result >= 0) {
+                written += result;
+            } else if (errno != EINTR) {
+                good = false;
+                resources->postError(
+                    "Terminal::exportText(int,bool)",
+                    std::string("Failed to write to file descriptor - ") + std::strerror(errno),
+                    errno,
+                    false
+                );
+            }
+        }
+        chunk.clear();
+    };
+
+    exportText([&](const char *data, std::size_t size) {
+        if (!good) return;
+        if (chunk.size() + size > chunkSize) {
+            writeChunk();
+        }
+        chunk.append(data, size);
+    }, styled);
+    if (good && chunk.size()) {
+        writeChunk();
+    }
+
+    return good;
+}
+
+std::vector<etm::TextBuffer::match> etm::Terminal::search(const std::string &query, TextBuffer::searchFlag::type flags) {
+    return display.search(query, flags);
+}
+
+void etm::Terminal::highlight(const TextBuffer::match &match) {
+    display.select(match.start, match.end);
+
+    // Bring the first row of the match into view
+    const float charHeight = resources->getFont()->getCharHeight();
+    const float top = match.start.row * charHeight;
+    if (top < scroll.getOffset()) {
+        scroll.scroll(top - scroll.getOffset());
+    } else if (top + charHeight > scroll.getOffset() + scroll.getNetHeight()) {
+        scroll.scroll(top + charHeight - scroll.getOffset() - scroll.getNetHeight());
+    }
+
+    invalidate();
+}
+
+bool etm::Terminal::saveSession(const std::string &path) {
+    flush();
+    return display.save(path);
+}
+
+bool etm::Terminal::loadSession(const std::string &path) {
+    float offset;
+    if (!display.load(path, offset)) {
+        return false;
+    }
+    displayBuffer.clear();
+    scroll.setGrossHeight(display.getHeight());
+    scroll.setOffset(offset);
+    scrollbar.update();
+    invalidate();
+    return true;
+}
@@ -2,9 +2,11 @@
 #define ETERMAL_TERMINAL_H_INCLUDED
 
 #include <deque>
+#include <vector>
 #include <memory>
 #include <functional>
 #include <streambuf>
+#include <ostream>
 #include <string>
 
 #include "util/enums.h"
@@ -15,6 +17,8 @@
 #include "Scroll.h"
 #include "gui/Scrollbar.h"
 #include "render/EtmFont.h"
+#include "render/GLState.h"
+#include "util/Profiler.h"
 
 namespace etm {
     // ../shell/EShell
@@ -125,10 +129,30 @@ namespace etm {
         /// @see invalidate()
         /// @see validate()
         bool framebufValid;
+        /// The font's @ref EtmFont::getRevision() "revision" as of
+        /// the last render, if it changed the glyphs have to be updated
+        unsigned int fontRevision;
+        /// Whether the caller's GL state is queried and restored
+        /// on each render
+        /// @see setStatePreservation(bool value)
+        bool preserveState;
 
         /// Are the terminal's OpenGL resources initialized?
         bool isInit;
 
+        /// If the input has been linted since it was last
+        /// for the shell (as opposed to an input request)
+        bool linted;
+        /// The @ref InputBuffer::getRevision() "revision"
+        /// of the input that was last linted
+        unsigned int lintRevision;
+        /// The tokens that the shell flagged.
+        /// Kept so that the memory is reused.
+        std::vector<bool> lintFlags;
+        /// The ranges of the flagged tokens.
+        /// Kept so that the memory is reused.
+        InputBuffer::tokens_t lintMarks;
+
         /**
         * Validates the Terminal cache
         * [@ref framebufferTex], signaling
@@ -158,10 +182,18 @@ namespace etm {
         /**
         * Pushes input to recievers (shell, and anyone
         * listed in @ref inputRequests)
-        * @param [in] input The input to push
+        * @param [in] input The input to push, with
+        * escapes already filtered
         */
         void pushInput(const std::string &input);
         /**
+        * Has the shell check the input if it changed since
+        * it was last checked (see @ref EShell::lint()), and
+        * marks what it flagged.
+        * Answers to input requests aren't checked.
+        */
+        void lintInput();
+        /**
         * Prepare the terminal for input.
         * Configures the cursor.
         */
@@ -438,6 +470,13 @@ namespace etm {
         * @see setBackgroundColor(const Color &color)
         */
         void setTextColor(const Color &color);
+        /**
+        * Sets the color of input that the shell flags as
+        * it's typed (ex. commands that don't exist).
+        * @param [in] color The color
+        * @see EShell::lint()
+        */
+        void setLintColor(const Color &color);
 
         /**
         * Sets the mouse scroll sensitivity.
@@ -557,6 +596,24 @@ namespace etm {
         */
         void setMaxLines(TextBuffer::lines_number_t count);
 
+        /**
+        * Sets whether the caller's OpenGL state (the program, blend,
+        * depth test, etc.) is queried before each render and restored
+        * after. Querying OpenGL state can stall the pipeline, so if the
+        * caller sets up their own state every frame anyways, it's best
+        * to turn this off.
+        * Defaults to `true`.
+        * @param [in] value `false` to not preserve the state
+        */
+        void setStatePreservation(bool value);
+        /**
+        * Gets the number of GL calls that were issued vs. skipped
+        * because they wouldn't have changed anything.
+        * @return The counters
+        * @see GLState
+        */
+        GLState::stats getGLStats();
+
         /**
         * Update element positioning.
         */
@@ -680,11 +737,95 @@ namespace etm {
         */
         std::string getTextSelection();
 
+        /**
+        * Gets how long the last few frames took to render, and why.
+        * Only recorded if the library was built with `ETERMAL_PROFILE`
+        * (see the `PROFILE` CMake option), otherwise there are none.
+        * @return Up to @ref Profiler::HISTORY frames, oldest first
+        * @see writeTrace(std::ostream &stream)
+        */
+        std::vector<Profiler::frame> getStats();
+        /**
+        * Writes the frames from @ref getStats() as Chrome trace events,
+        * for viewing in `chrome://tracing` or Perfetto.
+        * @param [out] stream The stream to write the JSON to
+        */
+        void writeTrace(std::ostream &stream);
+
         /**
         * Gets all the text in the terminal.
         * @return The text in the terminal
         */
         std::string getText();
+
+        /**
+        * Writes all the text in the terminal to a sink, span by span, without
+        * first copying it into one big string like @ref getText() does.
+        * @param [in] sink Called with each span of UTF-8 encoded text
+        * @param [in] styled If `true`, colors set through escape sequences
+        * are included as standard ANSI escapes (see @ref TextBuffer::exportText())
+        * @see exportText(std::ostream &stream, bool styled)
+        * @see exportText(int fd, bool styled)
+        */
+        void exportText(const TextBuffer::sink_t &sink, bool styled = false);
+        /**
+        * Writes all the text in the terminal to a stream.
+        * @param [out] stream The output stream
+        * @param [in] styled If `true`, includes colors as ANSI escapes
+        * @see exportText(const TextBuffer::sink_t &sink, bool styled)
+        */
+        void exportText(std::ostream &stream, bool styled = false);
+        /**
+        * Writes all the text in the terminal to a file descriptor.
+        * Output is buffered internally, so that large exports don't
+        * cost a system call per line.
+        * @note Write errors are sent to the error callback
+        * @param [in] fd The file descriptor, ex. of an open file or a pipe
+        * @param [in] styled If `true`, includes colors as ANSI escapes
+        * @return `true` if everything was written
+        * @see exportText(const TextBuffer::sink_t &sink, bool styled)
+        */
+        bool exportText(int fd, bool styled = false);
+
+        /**
+        * Searches the scrollback for text.
+        * Matches are returned as positions in the text buffer, and
+        * can be highlighted via @ref highlight(const TextBuffer::match &match).
+        * @param [in] query The text to find, or a regular expression
+        * if `flags` has @ref TextBuffer::searchFlag::regex set
+        * @param [in] flags Search options, see @ref TextBuffer::searchFlag
+        * @return All matches, in order from first to last
+        */
+        std::vector<TextBuffer::match> search(const std::string &query, TextBuffer::searchFlag::type flags = TextBuffer::searchFlag::none);
+
+        /**
+        * Highlights a match by selecting it (just like if the user had dragged over it),
+        * and scrolls so that it's in view.
+        * @param [in] match The match to highlight
+        * @see search(const std::string &query, TextBuffer::searchFlag::type flags)
+        * @see getTextSelection()
+        */
+        void highlight(const TextBuffer::match &match);
+
+        /**
+        * Saves the terminal's text, along with its styles, the cursor
+        * and the scroll position, to a file so that the session
+        * can be restored later (ex. after a restart).
+        * Any pending output is flushed first.
+        * @param [in] path The file to write to
+        * @return `true` on success
+        * @see loadSession(const std::string &path)
+        * @see TextBuffer::save(const std::string &path)
+        */
+        bool saveSession(const std::string &path);
+        /**
+        * Restores a session saved with @ref saveSession(const std::string &path),
+        * replacing the current contents of the terminal.
+        * @param [in] path The file to read
+        * @return `true` on success, if `false` nothing was changed
+        * @see TextBuffer::load(const std::string &path, float &scrollOffset)
+        */
+        bool loadSession(const std::string &path);
     };
 }
 
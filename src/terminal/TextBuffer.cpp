@@ -2,13 +2,22 @@
 
 #include <algorithm>
 #include <cmath>
+#include <regex>
+#include <fstream>
+#include <cstring>
+#include <cstdint>
 
 #include "gui/Rectangle.h"
 #include "Resources.h"
+#include "render/EtmFont.h"
 #include "Scroll.h"
 #include "textmods/TextState.h"
 #include "textmods/RenderState.h"
 #include "textmods/Lookbehind.h"
+#include "textmods/AnsiState.h"
+#include "textmods/Recorder.h"
+#include "util/MappedFile.h"
+#include "util/Profiler.h"
 
 static constexpr etm::TextBuffer::lines_number_t DEF_MAX_NUMBER_LINES = 1000; 
 static const std::string nullCodepointStr("\0");
@@ -21,12 +30,132 @@ static const etm::Line::codepoint nullCodepoint(nullCodepointStr.begin(), nullCo
 */
 static void filterChar(etm::Line::codepoint &c);
 
+/**
+* Gets the number of columns a codepoint takes up.
+* @param [in] c The codepoint
+* @return 2 if the codepoint is wide, otherwise 1
+* @see etm::wide::columns(etm::utf8::codepoint_t c)
+*/
+static int getColumns(const etm::Line::codepoint &c);
+
+/**
+* Decodes a codepoint.
+* @param [in] c The codepoint
+* @return The decoded codepoint
+*/
+static etm::utf8::codepoint_t decode(const etm::Line::codepoint &c);
+
+/**
+* Append a codepoint to a line, followed by
+* a filler if it takes up two columns.
+* @param [out] line The line
+* @param [in] c The codepoint
+* @param [in] columns The columns `c` takes up
+*/
+static void appendColumns(etm::Line &line, const etm::Line::codepoint &c, int columns);
+
 void filterChar(etm::Line::codepoint &c) {
-    if (etm::ctrl::testStart(*c.start) || etm::ctrl::testEnd(*c.start)) {
+    if (
+        etm::ctrl::testStart(*c.start) || etm::ctrl::testEnd(*c.start) ||
+        etm::wide::testFiller(*c.start) || etm::grapheme::testJoin(*c.start)
+        )
+    {
         c = nullCodepoint;
     }
 }
 
+int getColumns(const etm::Line::codepoint &c) {
+    // Everything before U+1100 (the first wide codepoint) is
+    // encoded with a header byte below 0xE1, so ASCII and most
+    // alphabets never need decoding
+    if (static_cast<etm::Line::u_value_type>(*c.start) < 0xE1) {
+        return 1;
+    }
+    return etm::wide::columns(decode(c));
+}
+
+etm::utf8::codepoint_t decode(const etm::Line::codepoint &c) {
+    const etm::Line::string_t str(c.start, c.end);
+    return etm::utf8::read(str, 0, str.size());
+}
+
+void appendColumns(etm::Line &line, const etm::Line::codepoint &c, int columns) {
+    line.appendChar(c);
+    if (columns > 1) {
+        line.appendChar(etm::wide::FILLER);
+    }
+}
+
+// Session snapshots.
+// Everything is little endian, laid out as:
+//  header: magic, version, width, cursor, cursorMin, scroll offset
+//  mods: ID offset, count, then the recorded effect of each
+//  lines: count, then for each the flags, deFacto size, byte size and bytes
+static constexpr char SNAPSHOT_MAGIC[8] = {'E', 'T', 'M', 'S', 'N', 'A', 'P', '\0'};
+static constexpr std::uint32_t SNAPSHOT_VERSION = 1;
+static constexpr std::uint8_t SNAPSHOT_LINE_NEWLINE = 1 << 0;
+static constexpr std::uint8_t SNAPSHOT_LINE_START_SPACE = 1 << 1;
+
+/**
+* Appends an unsigned integer to a snapshot, little endian.
+* @param [out] out The snapshot
+* @param [in] value The value
+* @param [in] bytes Number of bytes to write
+*/
+static void putUint(std::string &out, std::uint64_t value, int bytes);
+
+/**
+* Reads fields from a loaded snapshot, stopping
+* at the first one that would run out of bounds.
+*/
+struct snapshotReader {
+    /// Next byte to read
+    const char *data;
+    /// End of the snapshot
+    const char *end;
+    /// Set to `false` if the snapshot was cut short
+    bool good;
+    /**
+    * Reads an unsigned integer.
+    * @param [in] bytes The size of the integer
+    * @return The integer, or 0 if out of bounds
+    */
+    std::uint64_t getUint(int bytes);
+    /**
+    * Skips a range of bytes.
+    * @param [in] size The number of bytes
+    * @return The start of the range, or `nullptr` if out of bounds
+    */
+    const char *skip(std::uint64_t size);
+};
+
+void putUint(std::string &out, std::uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; i++) {
+        out.push_back(static_cast<char>((value >> (i * 8)) & 0xFF));
+    }
+}
+
+std::uint64_t snapshotReader::getUint(int bytes) {
+    const char *start = skip(bytes);
+    std::uint64_t value = 0;
+    if (start != nullptr) {
+        for (int i = 0; i < bytes; i++) {
+            value |= static_cast<std::uint64_t>(static_cast<unsigned char>(start[i])) << (i * 8);
+        }
+    }
+    return value;
+}
+
+const char *snapshotReader::skip(std::uint64_t size) {
+    if (!good || size > static_cast<std::uint64_t>(end - data)) {
+        good = false;
+        return nullptr;
+    }
+    const char *start = data;
+    data += size;
+    return start;
+}
+
 etm::TextBuffer::pos::pos(): pos(0, 0) {
 }
 etm::TextBuffer::pos::pos(lines_number_t row, line_index_t column):
@@ -38,12 +167,14 @@ etm::TextBuffer::TextBuffer(Resources *res, Scroll &scroll, line_index_t width):
     maxNumberLines(DEF_MAX_NUMBER_LINES),
     width(width), dispCursor(res),
     dfSelectStart(&selectStart), dfSelectEnd(&selectEnd),
-    cursorEnabled(false), displayCursor(false)
+    cursorEnabled(false), displayCursor(false),
+    inputDirty(false), marksRevision(0)
 {
     setDefForeGColor(0xffffff);
     setDefBackGColor(0x000000);
     setCursorColor(0xffffff);
     setCursorWidth(1);
+    setMarkColor(0xd13400);
 }
 
 void etm::TextBuffer::setScroll(Scroll &scroll) {
@@ -59,13 +190,20 @@ void etm::TextBuffer::checkNumberLines() {
     }
 }
 
+void etm::TextBuffer::touch(lines_number_t row) {
+    // because it's unsigned
+    searchIndex.invalidate(row - 1 < row ? row - 1 : 0);
+}
+
 void etm::TextBuffer::newline() {
     lines.emplace_back();
+    touch(lines.size() - 1);
     checkNumberLines();
 }
 
 void etm::TextBuffer::insertNewline(line_index_t row) {
     lines.insert(lines.begin() + row + 1, line_t());
+    touch(row);
     checkNumberLines();
 }
 
@@ -79,6 +217,7 @@ void etm::TextBuffer::deleteLastLine() {
     }
     lines.pop_back();
     modifierBlocks.eraseBack(countCtrl);
+    touch(lines.size());
 }
 
 void etm::TextBuffer::deleteFirstLine() {
@@ -91,6 +230,7 @@ void etm::TextBuffer::deleteFirstLine() {
     }
     lines.erase(lines.begin());
     modifierBlocks.eraseFront(countCtrl);
+    searchIndex.popFront();
 }
 
 bool etm::TextBuffer::cursorAtEnd() {
@@ -101,6 +241,20 @@ bool etm::TextBuffer::outOfBounds(lines_number_t row, line_index_t column) {
     return row >= lines.size() || column >= lines[row].size();
 }
 
+bool etm::TextBuffer::isFiller(lines_number_t row, line_index_t column) {
+    return column < lines[row].size() && wide::testFiller(lines[row][column]);
+}
+
+void etm::TextBuffer::snapCursor(int direction) {
+    if (isFiller(cursor.row, cursor.column)) {
+        if (direction < 0) {
+            cursor.column--;
+        } else {
+            cursor.column++;
+        }
+    }
+}
+
 int etm::TextBuffer::charWidth() {
     return res->getFont()->getCharWidth();
 }
@@ -124,10 +278,11 @@ void etm::TextBuffer::pushMod(const std::shared_ptr<tm::Mod> &mod) {
 void etm::TextBuffer::clear() {
     lines.clear();
     modifierBlocks.clear();
-    res->getFont()->clearCache();
+    searchIndex.clear();
     newline();
     jumpCursor();
     lines.shrink_to_fit();
+    inputDirty = true;
 }
 
 void etm::TextBuffer::setMaxLines(lines_number_t count) {
@@ -158,14 +313,22 @@ etm::TextBuffer::line_index_t etm::TextBuffer::getCursorCollumn() {
 
 void etm::TextBuffer::setCursorMinRow(lines_number_t row) {
     cursorMin.row = row;
+    inputDirty = true;
 }
 void etm::TextBuffer::setCursorMinCollumn(line_index_t column) {
     cursorMin.column = column;
+    inputDirty = true;
 }
 
 void etm::TextBuffer::lockCursor() {
     setCursorMinRow(cursor.row);
     setCursorMinCollumn(cursor.column);
+    // It's almost always locked at the end,
+    // in which case there's no input yet
+    if (lines.size() && cursorAtEnd()) {
+        input.clear();
+        inputDirty = false;
+    }
 }
 
 
@@ -174,11 +337,13 @@ void etm::TextBuffer::moveCursorCollumn(int distance) {
     if (cursor.row <= cursorMin.row) {
         cursor.column = std::max(cursor.column, cursorMin.column);
     }
+    snapCursor(distance);
 }
 bool etm::TextBuffer::moveCursorRow(int distance) {
     lines_number_t row = cursor.row;
     cursor.row = std::min(std::max(cursor.row + distance, cursorMin.row), lines.size()-1);
     cursor.column = std::min(cursor.column, lines[cursor.row].size());
+    snapCursor(-1);
     return row != cursor.row;
 }
 void etm::TextBuffer::moveCursorCollumnWrap(int distance) {
@@ -220,6 +385,7 @@ void etm::TextBuffer::moveCursorCollumnWrap(int distance) {
         cursor.row = cursorMin.row;
         cursor.column = std::max(cursor.column, cursorMin.column);
     }
+    snapCursor(distance);
 }
 
 void etm::TextBuffer::jumpCursor() {
@@ -265,6 +431,7 @@ void etm::TextBuffer::setWidth(line_index_t width) {
         cursorMin = cursor;
         jumpCursor();
         moveCursorCollumnWrap(-charDist);
+        inputDirty = true;
     }
 }
 etm::TextBuffer::line_index_t etm::TextBuffer::getWidth() {
@@ -275,30 +442,55 @@ void etm::TextBuffer::doAppend(const Line::codepoint &c) {
     if (!lines.size()) {
         newline();
     }
+    if (wide::testFiller(*c.start) || grapheme::testJoin(*c.start)) {
+        // Regenerated along with the wide char/cluster
+        return;
+    }
+    touch(lines.size() - 1);
+
+    // ASCII only continues clusters that end in a prepend
+    // (none of which are ASCII), so most text skips this
+    if (
+        c != '\n' && lines.back().dejureSize() &&
+        (static_cast<Line::u_value_type>(*c.start) >= 0x80 ||
+        static_cast<Line::u_value_type>(lines.back().getString().back()) >= 0x80) &&
+        lines.back().lastCluster(cluster) && grapheme::continues(cluster.data(), cluster.size(), decode(c))
+        )
+    {
+        lines.back().extendCluster(c);
+        return;
+    }
 
+    const int columns = getColumns(c);
     if (c == '\n') {
         lines.back().setNewline(true);
         newline();
-    } else if (lines.back().size() + 1 > width) {
+    } else if (lines.back().size() + columns > width && (columns == 1 || lines.back().size())) {
         newline(); // Warning: refs invalidated after call!
         line_t &lastLine = lines[lines.size() - 2];
         line_t &nextLine = lines[lines.size() - 1];
 
-        // If the last char or this char is NOT a space, do word wrap
+        // If the last char or this char is NOT a space, do word wrap.
+        // Wide chars (CJK) can be broken anywhere, so they just wrap.
                                     // because it's unsigned;
                                     // check for less than zero
-        if (c != ' ' && (lastLine.size() - 1 > lastLine.size() || lastLine[lastLine.size()-1] != ' ')) {
+        if (c != ' ' && columns == 1 && (lastLine.size() - 1 > lastLine.size() || lastLine[lastLine.size()-1] != ' ')) {
             Line::iterator it(lastLine.last());
             // Don't decrement by 2 because Line::last() is the last char (Line::size() - 1) 
             --it;
             for (; it.valid(); --it) {
-                if (*it == ' ') {
+                // Words can also be broken after any wide char
+                if (*it == ' ' || *it == wide::FILLER) {
                     ++it;
                     const Line::iterator eraseOffset = it;
                     // Move the last word from the last line to the next
                     // line via recursion
                     for (; it.valid(); ++it) {
-                        doAppend(*it);
+                        // A cluster is re-joined a codepoint at a time
+                        const Line::codepoint cell = *it;
+                        for (Line::string_t::const_iterator p = cell.start; p < cell.end; p += utf8::test(*p)) {
+                            doAppend(Line::codepoint(p, p + utf8::test(*p)));
+                        }
                     }
 
                     lastLine.erase(eraseOffset);
@@ -312,15 +504,16 @@ void etm::TextBuffer::doAppend(const Line::codepoint &c) {
             // Prevent stack overflow from `width` being 0...
             // should never happen, but there's no reason
             // to not desire to not not avoid recursion
-            nextLine.appendChar(c);
+            appendColumns(nextLine, c, columns);
         }
     } else {
-        lines.back().appendChar(c);
+        appendColumns(lines.back(), c, columns);
     }
 }
 
 void etm::TextBuffer::eraseAtCursor() {
     if (cursor.column == 0 && lines[cursor.row].hasStartSpace()) {
+        const inputKeep keep = keepInput(cursor.row);
         // In this case, we don't want to move backwards - 
         // instead, we just want to delete the start space.
 
@@ -346,6 +539,7 @@ void etm::TextBuffer::eraseAtCursor() {
         line_index_t prevSize = lines[cursor.row].size();
         reformat(cursor.row - 1 < cursor.row ? cursor.row - 1 : 0, 0);
         cursor.column += lines[cursor.row].size() - prevSize;
+        syncInput(keep);
     } else {
         // Check if the cursor can move back one, deleting the
         // previous char
@@ -362,7 +556,13 @@ void etm::TextBuffer::eraseAtCursor() {
                 return;
             }
         }
+        // Erase the whole wide char rather than just its filler -
+        // unless it's the newline that's getting erased
+        if (isFiller(row, column) && !(column == lines[row].size() - 1 && lines[row].hasNewline())) {
+            column--;
+        }
         if ((column >= cursorMin.column || row > cursorMin.row) && row >= cursorMin.row && column < lines[row].size()) {
+            const inputKeep keep = keepInput(row);
             if (cursorAtEnd()) {
                 // Better to just truncate if at the end
                 trunc();
@@ -395,6 +595,7 @@ void etm::TextBuffer::eraseAtCursor() {
                     cursor.row++;
                 }
             }
+            syncInput(keep);
         }
     }
 }
@@ -403,9 +604,11 @@ void etm::TextBuffer::erase(lines_number_t row, line_index_t column) {
     if (!outOfBounds(row, column)) {
         prepare();
         doErase(row, column);
+        inputDirty = true;
     }
 }
 void etm::TextBuffer::doErase(lines_number_t row, line_index_t column) {
+    touch(row);
 
     if (column == lines[row].size()-1 && lines[row].hasNewline()) {
         // If was the last char and the line was broken manually:
@@ -421,6 +624,10 @@ void etm::TextBuffer::doErase(lines_number_t row, line_index_t column) {
         // "less than self" because it's unsigned.
         reformat(row - 1 < row ? row - 1 : 0, 0);
     } else {
+        if (isFiller(row, column)) {
+            column--;
+        }
+        // The wide char's filler is dropped when reformatting
         lines[row].eraseChar(column);
         reformat(row - 1 < row ? row - 1 : 0, 0);
     }
@@ -429,6 +636,7 @@ void etm::TextBuffer::doErase(lines_number_t row, line_index_t column) {
 void etm::TextBuffer::append(Line::codepoint c) {
     filterChar(c);
     doAppend(c);
+    inputDirty = true;
     // Cursor should always be jumpped when appending.
     // If this is not the desired behavior (ex when
     // reformatting), call doAppend()
@@ -438,6 +646,7 @@ void etm::TextBuffer::append(Line::codepoint c) {
 void etm::TextBuffer::trunc() {
     prepare();
     doTrunc();
+    inputDirty = true;
     // Cursor should always be jumpped when truncating.
     // If this is not the desired behavior (ex when
     // reformatting), call doTrunc()
@@ -447,6 +656,8 @@ void etm::TextBuffer::trunc() {
 void etm::TextBuffer::doTrunc() {
 
     if (lines.size()) {
+        // The line before the last one can gain text from the last
+        touch(lines.size() - 2 < lines.size() ? lines.size() - 2 : 0);
         if (!lines.back().size()) {
             if (!lines.back().hasStartSpace()) {
                 // If line empty, delete it
@@ -465,7 +676,12 @@ void etm::TextBuffer::doTrunc() {
                 return;
             }
         }
+        // Wide chars take their filler with them
+        const bool filler = wide::testFiller(lines.back().getDejure(lines.back().last().getIndex()));
         lines.back().popBack();
+        if (filler && lines.back().size()) {
+            lines.back().popBack();
+        }
         // Don't delete line if it's the only one.
         if (lines.size() > 1 && !lines[lines.size() - 2].hasNewline()) {
             // Delete line if empty and last line didn't force
@@ -494,7 +710,13 @@ void etm::TextBuffer::insertAtCursor(Line::codepoint c) {
     prepare();
     if (lines.size()) {
         filterChar(c);
-        int cursorMove = 1;
+        int cursorMove = getColumns(c);
+        // Marks and such will be joined to the cluster before the cursor
+        const grapheme::property property = grapheme::getProperty(decode(c));
+        if (property == grapheme::EXTEND || property == grapheme::ZWJ || property == grapheme::SPACING_MARK) {
+            cursorMove = 0;
+        }
+        const inputKeep keep = keepInput(cursor.row);
         if (cursorAtEnd()) {
             doAppend(c);
         } else {
@@ -519,6 +741,7 @@ void etm::TextBuffer::insertAtCursor(Line::codepoint c) {
             insert(cursor.row, cursor.column, c);
         }
         moveCursorCollumnWrap(cursorMove);
+        syncInput(keep);
     }
 }
 
@@ -527,9 +750,11 @@ void etm::TextBuffer::insert(lines_number_t row, line_index_t column, Line::code
         filterChar(c);
         prepare();
         doInsert(row, column, c);
+        inputDirty = true;
     }
 }
 void etm::TextBuffer::doInsert(lines_number_t row, line_index_t column, const Line::codepoint &c) {
+    touch(row);
 
     if (c == '\n') {
         if (!lines[row].hasNewline()) {            
@@ -564,6 +789,7 @@ void etm::TextBuffer::reformat(lines_number_t row, line_index_t column) {
     // We assume that row and column are valid, and that there are > 0 lines.
     // Copy all the data after and including the given position,
     // then delete the lines that the data came from and re-append everything.
+    touch(row);
     Line::string_t buffer(lines[row].substr(column));
     lines[row].erase(column);
     if (lines[row].hasNewline()) {
@@ -599,6 +825,10 @@ void etm::TextBuffer::clampPos(pos &p, lines_number_t row, line_index_t column)
             p.row = row;
                                         // last char of string defined
             p.column = std::min(column, lines[p.row].size());
+            // Land on the start of a wide char
+            if (isFiller(p.row, p.column)) {
+                p.column--;
+            }
         } else {
             p.row = lines.size() - 1;
             p.column = lines[p.row].size();
@@ -630,89 +860,568 @@ std::string etm::TextBuffer::getSelectionText() {
     return getTextFromRange(*dfSelectStart, *dfSelectEnd);
 }
 
+void etm::TextBuffer::select(const pos &start, const pos &end) {
+    initSelection(start.row, start.column);
+    setSelectionEnd(end.row, end.column);
+}
+
+etm::TextBuffer::lines_number_t etm::TextBuffer::joinRows(lines_number_t row, std::string &text, std::vector<std::string::size_type> &starts) {
+    text.clear();
+    starts.clear();
+    // Back up to the start of the logical line
+    while (row > 0 && !lines[row - 1].hasNewline()) {
+        row--;
+    }
+    for (lines_number_t r = row; r < lines.size(); r++) {
+        starts.push_back(text.size());
+        if (lines[r].hasStartSpace()) {
+            text.push_back(' ');
+        }
+        lines[r].copyTextTo(text);
+        if (lines[r].hasNewline()) {
+            break;
+        }
+    }
+    return row;
+}
+
+etm::TextBuffer::pos etm::TextBuffer::mapOffset(lines_number_t first, const std::string &text, const std::vector<std::string::size_type> &starts, std::string::size_type offset, bool end) {
+    // The last row that starts at (or, for ends, before) the offset
+    std::vector<std::string::size_type>::const_iterator it;
+    if (end) {
+        it = std::lower_bound(starts.begin(), starts.end(), offset);
+    } else {
+        it = std::upper_bound(starts.begin(), starts.end(), offset);
+    }
+    const std::vector<std::string::size_type>::size_type k = it == starts.begin() ? 0 : it - starts.begin() - 1;
+    pos p(first + k, 0);
+    std::string::size_type i = starts[k] + (lines[p.row].hasStartSpace() ? 1 : 0);
+    // Anything on the start space is column 0
+    cluster.clear();
+    while (i < offset) {
+        const int size = utf8::test(text[i]);
+        const utf8::codepoint_t c = utf8::read(text, i, size);
+        // Codepoints that continue a cluster share its column
+        if (cluster.empty() || !grapheme::continues(cluster.data(), cluster.size(), c)) {
+            p.column += wide::columns(c);
+            cluster.clear();
+        }
+        cluster.push_back(c);
+        i += size;
+    }
+    return p;
+}
+
+std::vector<etm::TextBuffer::match> etm::TextBuffer::search(const std::string &query, searchFlag::type flags) {
+    std::vector<match> results;
+    if (query.empty() || !lines.size()) {
+        return results;
+    }
+
+    const bool nocase = flags & searchFlag::nocase;
+    const bool isRegex = flags & searchFlag::regex;
+
+    std::regex pattern;
+    std::string needle;
+    if (isRegex) {
+        try {
+            pattern.assign(query, nocase ? std::regex::ECMAScript | std::regex::icase : std::regex::ECMAScript);
+        } catch (std::regex_error &e) {
+            res->postError(
+                "TextBuffer::search(const std::string&,searchFlag::type)",
+                std::string("Invalid regular expression - ") + e.what(),
+                0,
+                false
+            );
+            return results;
+        }
+    } else {
+        needle = query;
+        if (nocase) {
+            std::transform(needle.begin(), needle.end(), needle.begin(), SearchIndex::fold);
+        }
+    }
+
+    // Rows that could have a match.
+    // If the index can't help, look at all of them.
+    std::vector<lines_number_t> rows;
+    const bool scanAll = isRegex || needle.size() < 3;
+    if (!scanAll) {
+        searchIndex.sync(lines);
+        searchIndex.find(needle, rows);
+    }
+
+    std::string text;
+    std::vector<std::string::size_type> starts;
+    // The row after the last logical line that was searched,
+    // so that the same logical line isn't searched twice
+    lines_number_t done = 0;
+    for (lines_number_t i = 0; scanAll ? done < lines.size() : i < rows.size(); i++) {
+        const lines_number_t row = scanAll ? done : rows[i];
+        if (row < done) {
+            continue;
+        }
+        const lines_number_t first = joinRows(row, text, starts);
+        done = first + starts.size();
+
+        if (isRegex) {
+            for (
+                std::sregex_iterator it(text.begin(), text.end(), pattern), end;
+                it != end;
+                ++it
+                )
+            {
+                if (it->length() > 0) {
+                    const std::string::size_type offset = it->position();
+                    results.push_back({
+                        mapOffset(first, text, starts, offset, false),
+                        mapOffset(first, text, starts, offset + it->length(), true)
+                    });
+                }
+            }
+        } else {
+            if (nocase) {
+                std::transform(text.begin(), text.end(), text.begin(), SearchIndex::fold);
+            }
+            for (
+                std::string::size_type offset = text.find(needle);
+                offset != std::string::npos;
+                offset = text.find(needle, offset + needle.size())
+                )
+            {
+                results.push_back({
+                    mapOffset(first, text, starts, offset, false),
+                    mapOffset(first, text, starts, offset + needle.size(), true)
+                });
+            }
+        }
+    }
+
+    return results;
+}
+
 std::string etm::TextBuffer::getTextFromRange(const pos &start, const pos &stop) {
+    pos startpoint;
     pos endpoint;
+    clampPos(startpoint, start.row, start.column);
     clampPos(endpoint, stop.row, stop.column);
     // Denies if start > end, so we're fine
-    return doGetTextFromRange(start, endpoint);
+    return doGetTextFromRange(startpoint, endpoint);
 }
 
 std::string etm::TextBuffer::doGetTextFromRange(const pos &start, const pos &stop) {
+    std::string buffer;
+    doExportText(start, stop, [&buffer](const char *data, std::size_t size) {
+        buffer.append(data, size);
+    }, false);
+    return buffer;
+}
+
+void etm::TextBuffer::exportText(const pos &start, const pos &stop, const sink_t &sink, bool styled) {
+    pos startpoint;
+    pos endpoint;
+    clampPos(startpoint, start.row, start.column);
+    clampPos(endpoint, stop.row, stop.column);
+    // Denies if start > end, so we're fine
+    doExportText(startpoint, endpoint, sink, styled);
+}
+
+void etm::TextBuffer::doExportText(const pos &start, const pos &stop, const sink_t &sink, bool styled) {
     if (start.row > stop.row || (start.row == stop.row && start.column > stop.column)) {
-        return "";
+        return;
     }
-    std::string buffer;
-    if (start.row == stop.row) {
-        // Midsection
-        for (
-            Line::iterator it = lines[start.row].begin() + start.column,
-            end = it + (stop.column - start.column);
-            it.valid() && it < end;
-            ++it
-            )
-        {
-            Line::codepoint c(*it);
-            buffer.append(c.start, c.end);
+
+    tm::AnsiState state(sink);
+    if (styled) {
+        // Catch up to the style at the start
+        state.setMuted(true);
+        for (lines_number_t r = 0; r <= start.row; r++) {
+            line_t &line = lines[r];
+            const line_index_t limit = r == start.row ? line.dejureIndex(start.column) : line.dejureSize();
+            for (line_index_t i = 0; i < limit; i++) {
+                if (ctrl::testStart(line.getDejure(i))) {
+                    getMod(i, line)->run(state);
+                    i += ctrl::getJump();
+                }
+            }
         }
-    } else {
-        // End of first line
-        for (
-            Line::iterator it = lines[start.row].begin() + start.column;
-            it.valid();
-            ++it
-            )
-        {
-            Line::codepoint c(*it);
-            buffer.append(c.start, c.end);
-        }
-        if (lines[start.row].hasNewline()) {
-            buffer.push_back('\n');
+        state.setMuted(false);
+        state.writeCurrent();
+    }
+
+    for (lines_number_t r = start.row; r <= stop.row; r++) {
+        line_t &line = lines[r];
+        if (r != start.row && line.hasStartSpace()) {
+            sink(" ", 1);
+        }
+
+        const line_index_t from = r == start.row ? line.dejureIndex(start.column) : 0;
+        const line_index_t to = r == stop.row ? line.dejureIndex(stop.column) : line.dejureSize();
+        const Line::string_t &str = line.getString();
+        // Write everything between the control blocks
+        // (and wide char fillers) in one go
+        line_index_t span = from;
+        for (line_index_t i = from; i < to;) {
+            if (ctrl::testStart(str[i])) {
+                if (i > span) {
+                    sink(str.data() + span, i - span);
+                }
+                if (styled) {
+                    getMod(i, line)->run(state);
+                }
+                i += ctrl::getJump() + 1;
+                span = i;
+            } else if (wide::testFiller(str[i])) {
+                if (i > span) {
+                    sink(str.data() + span, i - span);
+                }
+                i++;
+                span = i;
+            } else {
+                i++;
+            }
         }
-        // Every line in-between
-        for (lines_number_t l = start.row + 1; l < stop.row; l++) {
-            if (lines[l].hasStartSpace()) {
-                buffer.push_back(' ');
+        if (to > span) {
+            sink(str.data() + span, to - span);
+        }
+
+        if (r != stop.row && line.hasNewline()) {
+            sink("\n", 1);
+        }
+    }
+
+    if (styled) {
+        state.reset();
+    }
+}
+
+bool etm::TextBuffer::save(const std::string &path) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.good()) {
+        res->postError("TextBuffer::save(const std::string&)", "Failed to open \"" + path + "\" for writing", 0, false);
+        return false;
+    }
+
+    // Written in blocks so that the stream isn't
+    // called for every little field
+    constexpr std::string::size_type blockSize = 1 << 16;
+    std::string block;
+    block.reserve(blockSize);
+
+    float offset = scroll->getOffset();
+    std::uint32_t offsetBits;
+    std::memcpy(&offsetBits, &offset, sizeof(offsetBits));
+
+    block.append(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    putUint(block, SNAPSHOT_VERSION, 4);
+    putUint(block, width, 8);
+    putUint(block, cursor.row, 8);
+    putUint(block, cursor.column, 8);
+    putUint(block, cursorMin.row, 8);
+    putUint(block, cursorMin.column, 8);
+    putUint(block, offsetBits, 4);
+
+    // Mods can be anything, so save what they do
+    // rather than what they are
+    putUint(block, modifierBlocks.getOffset(), 8);
+    putUint(block, modifierBlocks.size(), 8);
+    for (modifierBlocks_t::id_t i = 0; i < modifierBlocks.size(); i++) {
+        tm::Recorder recorder;
+        modifierBlocks.get(modifierBlocks.getOffset() + i)->run(recorder);
+        putUint(block, recorder.getBack(), 1);
+        putUint(block, recorder.getBackColor().getHex(), 4);
+        putUint(block, recorder.getFore(), 1);
+        putUint(block, recorder.getForeColor().getHex(), 4);
+    }
+
+    putUint(block, lines.size(), 8);
+    for (line_t &line : lines) {
+        std::uint8_t flags = 0;
+        if (line.hasNewline()) {
+            flags |= SNAPSHOT_LINE_NEWLINE;
+        }
+        if (line.hasStartSpace()) {
+            flags |= SNAPSHOT_LINE_START_SPACE;
+        }
+        putUint(block, flags, 1);
+        putUint(block, line.size(), 8);
+        putUint(block, line.dejureSize(), 8);
+        line.copyTo(block);
+        if (block.size() >= blockSize) {
+            file.write(block.data(), block.size());
+            block.clear();
+        }
+    }
+    file.write(block.data(), block.size());
+
+    if (!file.good()) {
+        res->postError("TextBuffer::save(const std::string&)", "Failed to write to \"" + path + "\"", 0, false);
+        return false;
+    }
+    return true;
+}
+
+bool etm::TextBuffer::load(const std::string &path, float &scrollOffset) {
+    constexpr const char *location = "TextBuffer::load(const std::string&,float&)";
+
+    MappedFile file;
+    if (!file.open(path)) {
+        res->postError(location, file.getError(), 0, false);
+        return false;
+    }
+    snapshotReader in{file.data(), file.data() + file.size(), true};
+
+    const char *magic = in.skip(sizeof(SNAPSHOT_MAGIC));
+    if (magic == nullptr || std::memcmp(magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0) {
+        res->postError(location, "\"" + path + "\" is not a session snapshot", 0, false);
+        return false;
+    }
+    const std::uint64_t version = in.getUint(4);
+    if (version != SNAPSHOT_VERSION) {
+        res->postError(location, "Unsupported snapshot version " + std::to_string(version), 0, false);
+        return false;
+    }
+
+    const line_index_t savedWidth = in.getUint(8);
+    pos savedCursor;
+    savedCursor.row = in.getUint(8);
+    savedCursor.column = in.getUint(8);
+    pos savedCursorMin;
+    savedCursorMin.row = in.getUint(8);
+    savedCursorMin.column = in.getUint(8);
+    const std::uint32_t offsetBits = in.getUint(4);
+
+    // Everything is read into new containers first,
+    // so that a corrupt file leaves the buffer alone.
+    modifierBlocks_t mods;
+    const modifierBlocks_t::id_t modsOffset = in.getUint(8);
+    const std::uint64_t modsCount = in.getUint(8);
+    mods.setOffset(modsOffset);
+    for (std::uint64_t i = 0; in.good && i < modsCount; i++) {
+        const std::uint64_t back = in.getUint(1);
+        const Color backColor(static_cast<Color::hex_t>(in.getUint(4)));
+        const std::uint64_t fore = in.getUint(1);
+        const Color foreColor(static_cast<Color::hex_t>(in.getUint(4)));
+        if (back > tm::Restyle::SET || fore > tm::Restyle::SET) {
+            in.good = false;
+            break;
+        }
+        mods.add(tm::Recorder(
+            static_cast<tm::Restyle::action>(back), backColor,
+            static_cast<tm::Restyle::action>(fore), foreColor
+        ).makeMod());
+    }
+
+    lines_t newLines;
+    const std::uint64_t linesCount = in.getUint(8);
+    // Each line takes at least 17 bytes, so a bad count
+    // can't make us reserve more than the file could hold
+    newLines.reserve(std::min<std::uint64_t>(linesCount, (in.end - in.data) / 17));
+    for (std::uint64_t i = 0; in.good && i < linesCount; i++) {
+        const std::uint64_t flags = in.getUint(1);
+        const std::uint64_t defacto = in.getUint(8);
+        const std::uint64_t size = in.getUint(8);
+        const char *data = in.skip(size);
+        if (data == nullptr) {
+            break;
+        }
+        // The text is unsafe to use if it has control blocks pointing
+        // to mods that don't exist, or codepoints that run past the
+        // end, and the size has to match it or the line would
+        // index past its end. Same walk as Line::findDefactoSize().
+        std::uint64_t cells = 0;
+        for (std::uint64_t c = 0; in.good && c < size;) {
+            if (ctrl::testStart(data[c])) {
+                if (size - c <= ctrl::getJump() || !ctrl::testEnd(data[c + ctrl::getJump()])) {
+                    in.good = false;
+                    break;
+                }
+                const std::string block(data + c, data + c + ctrl::getJump() + 1);
+                const ctrl::type id = ctrl::decode(block.begin(), block.end());
+                if (id < modsOffset || id - modsOffset >= modsCount) {
+                    in.good = false;
+                    break;
+                }
+                c += ctrl::getJump() + 1;
+                continue;
             }
-            for (Line::iterator it = lines[l].begin(); it.valid(); ++it) {
-                Line::codepoint c(*it);
-                buffer.append(c.start, c.end);
+            const bool joined = grapheme::testJoin(data[c]);
+            if (joined) {
+                // Must be followed by the codepoint it joins
+                c++;
+                if (c >= size || ctrl::testStart(data[c]) || grapheme::testJoin(data[c])) {
+                    in.good = false;
+                    break;
+                }
+            }
+            const std::uint64_t bytes = utf8::test(data[c]);
+            if (size - c < bytes) {
+                in.good = false;
+                break;
             }
-            if (lines[l].hasNewline()) {
-                buffer.push_back('\n');
+            for (std::uint64_t b = 1; b < bytes; b++) {
+                if ((static_cast<unsigned char>(data[c + b]) & 0xC0) != 0x80) {
+                    in.good = false;
+                }
             }
+            c += bytes;
+            cells += !joined;
         }
-        // Start of last line
-        if (lines[stop.row].hasStartSpace()) {
-            buffer.push_back(' ');
+        if (cells != defacto) {
+            in.good = false;
         }
-        for (
-            Line::iterator it = lines[stop.row].begin(),
-            end = it + stop.column;
-            it.valid() && it < end;
-            ++it
-            )
-        {
-            Line::codepoint c(*it);
-            buffer.append(c.start, c.end);
+        if (!in.good) {
+            break;
         }
+        newLines.emplace_back(
+            Line::string_t(data, size), cells,
+            (flags & SNAPSHOT_LINE_NEWLINE) != 0,
+            (flags & SNAPSHOT_LINE_START_SPACE) != 0
+        );
     }
 
-    return buffer;
+    if (!in.good || newLines.empty() || savedWidth == 0) {
+        res->postError(location, "\"" + path + "\" is corrupt", 0, false);
+        return false;
+    }
+
+    lines = std::move(newLines);
+    modifierBlocks = std::move(mods);
+    searchIndex.clear();
+    selectStart = selectEnd = pos();
+    dfSelectStart = &selectStart;
+    dfSelectEnd = &selectEnd;
+    clampPos(cursor, savedCursor.row, savedCursor.column);
+    clampPos(cursorMin, savedCursorMin.row, savedCursorMin.column);
+    inputDirty = true;
+
+    // The snapshot may have been taken with a different number of columns
+    if (savedWidth != width) {
+        const line_index_t currentWidth = width;
+        width = savedWidth;
+        setWidth(currentWidth);
+    }
+    while (lines.size() > maxNumberLines && cursorMin.row > 0) {
+        deleteFirstLine();
+        cursorMin.row--;
+        cursor.row--;
+    }
+
+    std::memcpy(&scrollOffset, &offsetBits, sizeof(scrollOffset));
+    return true;
 }
 
 std::string etm::TextBuffer::pollInput() {
+    return getInput().getText();
+}
+
+const etm::InputBuffer &etm::TextBuffer::getInput() {
     if (!lines.size()) {
         newline();
-        return "";
     }
-    return doGetTextFromRange(cursorMin, pos(lines.size() - 1, lines.back().size()));
+    if (inputDirty) {
+        std::string text;
+        doReadInput(cursorMin, lastPos(), &text);
+        input.assign(text);
+        inputDirty = false;
+    }
+    return input;
+}
+
+void etm::TextBuffer::takeInput(std::string &out) {
+    getInput();
+    input.take(out);
+    // It's still in the rows
+    inputDirty = true;
+}
+
+void etm::TextBuffer::setInputMarks(const InputBuffer::tokens_t &marks) {
+    inputMarks = marks;
+    marksRevision = input.getRevision();
+}
+void etm::TextBuffer::setMarkColor(const Color &color) {
+    markColor = color;
+}
+
+etm::TextBuffer::inputKeep etm::TextBuffer::keepInput(lines_number_t row) {
+    inputKeep keep;
+    keep.rows = row > cursorMin.row ? row - 1 - cursorMin.row : 0;
+    keep.valid = !inputDirty;
+    if (keep.valid) {
+        keep.bytes = input.size() - doReadInput(inputStart(keep.rows), lastPos(), nullptr);
+    }
+    return keep;
+}
+
+void etm::TextBuffer::syncInput(const inputKeep &keep) {
+    if (!keep.valid) {
+        return;
+    }
+    // The rows could've been trimmed from under it
+    if (cursorMin.row >= lines.size() || cursorMin.row + keep.rows > lines.size()) {
+        inputDirty = true;
+        return;
+    }
+    std::string tail;
+    doReadInput(inputStart(keep.rows), lastPos(), &tail);
+    const std::string &text = input.getText();
+    const InputBuffer::size_type oldSize = text.size() - keep.bytes;
+    // Skip what stayed the same at either end
+    const InputBuffer::size_type limit = std::min(oldSize, tail.size());
+    InputBuffer::size_type front = 0;
+    while (front < limit && text[keep.bytes + front] == tail[front]) {
+        front++;
+    }
+    InputBuffer::size_type back = 0;
+    while (back < limit - front && text[text.size() - 1 - back] == tail[tail.size() - 1 - back]) {
+        back++;
+    }
+    if (front != oldSize || front != tail.size()) {
+        input.replace(
+            keep.bytes + front, oldSize - front - back,
+            std::string_view(tail).substr(front, tail.size() - front - back)
+        );
+    }
+    // Whatever was done to the rows, the input's caught up
+    inputDirty = false;
+}
+
+etm::TextBuffer::pos etm::TextBuffer::inputStart(lines_number_t rows) {
+    if (!rows) {
+        return cursorMin;
+    }
+    const lines_number_t row = cursorMin.row + rows - 1;
+    return pos(row, lines[row].size());
+}
+
+etm::TextBuffer::pos etm::TextBuffer::lastPos() {
+    return pos(lines.size() - 1, lines.back().size());
+}
+
+etm::InputBuffer::size_type etm::TextBuffer::doReadInput(const pos &start, const pos &stop, std::string *out) {
+    InputBuffer::size_type size = 0;
+    doExportText(start, stop, [&size, out](const char *data, std::size_t count) {
+        for (std::size_t i = 0; i < count; i++) {
+            // Joins only mark clusters in the rows
+            if (!grapheme::testJoin(data[i])) {
+                size++;
+                if (out != nullptr) {
+                    out->push_back(data[i]);
+                }
+            }
+        }
+    }, false);
+    return size;
 }
 
 void etm::TextBuffer::clearInput() {
     int brea = 3;
     brea++;
+    touch(cursorMin.row);
     lines[cursorMin.row].erase(cursorMin.column);
     lines.erase(lines.begin() + cursorMin.row + 1, lines.end());
+    input.clear();
+    inputDirty = false;
 }
 
 void etm::TextBuffer::prepare() {
@@ -739,18 +1448,15 @@ void etm::TextBuffer::getRange(lines_number_t &start, lines_number_t &end) {
 
 void etm::TextBuffer::render() {
 
-    // Offsets
-    int x = 0;
-    int y = 0;
-
-    // "After scrollbar renders, the text shader is set
-    // due to the rendering of the triangle textures,
-    // so display doesn't need to set it."
-    // - Comment right after the scrollbar render call in Terminal
-    // res->bindTextShader();
-
-    // Correct the y-offset with the scroll offset
-    y -= scroll->getOffset();
+    // Cells are placed by the shader, all it needs is the
+    // cell size, the viewport and the scroll offset.
+    res->bindCellShader();
+    shader::Cell &cellShader = res->getCellShader();
+    cellShader.setFrame(
+        charWidth(), charHeight(),
+        res->getViewportWidth(), res->getViewportHeight(),
+        0, -static_cast<int>(scroll->getOffset())
+    );
 
     // Only render the range that is visible
     lines_number_t start, end;
@@ -765,29 +1471,57 @@ void etm::TextBuffer::render() {
     // Well, it's definitely better than the alternatives...
     // The goal is to prioritize memory... Performance is less of an
     // issue, since the console itn't going to be active, _all the time_
-    for (lines_number_t r = start - 1; r < start && !lookbehind.bothSet(); r--) {
-        line_t &line = lines[r];
-        for (line_index_t c = 0; c < line.dejureSize(); c++) {
-            Line::value_type chr = line.getDejure(c);
-            if (ctrl::testStart(chr)) {
-                getMod(c, line)->run(lookbehind);
-                c += ctrl::getJump();
+    {
+        ETM_PROFILE_SCOPE(res->getProfiler(), Profiler::LOOKBEHIND);
+        for (lines_number_t r = start - 1; r < start && !lookbehind.bothSet(); r--) {
+            line_t &line = lines[r];
+            for (line_index_t c = 0; c < line.dejureSize(); c++) {
+                Line::value_type chr = line.getDejure(c);
+                if (ctrl::testStart(chr)) {
+                    getMod(c, line)->run(lookbehind);
+                    c += ctrl::getJump();
+                }
             }
+            lookbehind.decLine();
         }
-        lookbehind.decLine();
     }
 
     tm::RenderState state(
-        res->getShader(),
+        nullptr,
         lookbehind.getBack(),
         lookbehind.getFore(),
         selectStart.row < start && start < selectEnd.row
     );
 
-    Model model(x, y + static_cast<int>(charHeight() * start), charWidth(), charHeight());
+    ETM_PROFILE(Profiler &profiler = res->getProfiler());
+    ETM_PROFILE(const double layoutStart = profiler.now());
+
+    // Colors are per-cell attributes, so rather than drawing
+    // each glyph as it comes, collect them all and then draw
+    // every cell that shares a glyph at once.
+    renderGlyphs.clear();
+    EtmFont &font = *res->getFont();
+    // If every glyph is in the same texture, the cells can
+    // all be drawn together.
+    const bool atlas = font.isAtlas();
+    const bool shaping = font.isShaping();
+    cellShader.setDistanceField(font.isDistanceField());
+
+    // Marked input is drawn in the mark color, so the offset
+    // of each cell in the input has to be followed
+    const bool marking = inputMarks.size() && !inputDirty && marksRevision == input.getRevision() && cursorMin.row < end;
+    InputBuffer::size_type inputOffset = 0;
+    InputBuffer::tokens_t::const_iterator mark = inputMarks.begin();
+    if (marking && cursorMin.row < start) {
+        inputOffset = doReadInput(cursorMin, pos(start, 0), nullptr);
+    }
 
     for (lines_number_t r = start; r < end; r++) {
         line_t &line = lines[r];
+        const std::size_t rowStart = renderGlyphs.size();
+        if (marking && r > cursorMin.row && r != start && line.hasStartSpace()) {
+            inputOffset++;
+        }
         if (r == dfSelectStart->row && 0 == dfSelectStart->column) {
             state.setInverted(true);
         }
@@ -804,12 +1538,42 @@ void etm::TextBuffer::render() {
                 getMod(c, line)->run(state);
                 c += ctrl::getJump() + 1;
             } else {
-                const int size = utf8::test(chr);
-
-                res->getFont()->bindChar(utf8::read(line.getString(), c, size));
-                model.set(res);
-                res->renderRectangle();
-                model.x += charWidth();
+                int size = utf8::test(chr);
+
+                // Fillers are covered by their wide char's cell
+                if (!wide::testFiller(chr)) {
+                    glyph g;
+                    g.codepoint = utf8::read(line.getString(), c, size);
+                    g.cell.span = wide::columns(g.codepoint);
+                    InputBuffer::size_type bytes = size;
+                    // The rest of the cluster
+                    if (c + size + 1 < line.dejureSize() && grapheme::testJoin(line.getDejure(c + size))) {
+                        cluster.assign(1, g.codepoint);
+                        while (c + size + 1 < line.dejureSize() && grapheme::testJoin(line.getDejure(c + size))) {
+                            c += size + 1;
+                            size = utf8::test(line.getDejure(c));
+                            bytes += size;
+                            cluster.push_back(utf8::read(line.getString(), c, size));
+                        }
+                        g.codepoint = font.getClusterGlyph(cluster.data(), cluster.size());
+                    }
+                    const Color *fore = &state.getFore();
+                    if (marking && (r > cursorMin.row || (r == cursorMin.row && cc >= cursorMin.column))) {
+                        while (mark < inputMarks.end() && mark->end <= inputOffset) {
+                            ++mark;
+                        }
+                        if (mark < inputMarks.end() && mark->start <= inputOffset) {
+                            fore = &markColor;
+                        }
+                        inputOffset += bytes;
+                    }
+                    g.cell.column = static_cast<int>(cc);
+                    g.cell.row = static_cast<int>(r);
+                    std::copy_n(state.getBack().get(), 3, g.cell.back);
+                    std::copy_n(fore->get(), 3, g.cell.fore);
+                    font.getGlyphRegion(g.codepoint, g.cell.glyph);
+                    renderGlyphs.push_back(g);
+                }
 
                 c += size;
                 cc++;
@@ -823,9 +1587,92 @@ void etm::TextBuffer::render() {
                 }
             }
         }
-        model.x = 0;
-        model.y += charHeight();
+        if (marking && r >= cursorMin.row && line.hasNewline()) {
+            inputOffset++;
+        }
+        if (shaping) {
+            shapeGlyphs(font, rowStart);
+        }
+    }
+    ETM_PROFILE(profiler.addSpan(Profiler::LAYOUT, layoutStart, profiler.now() - layoutStart));
+
+    if (renderGlyphs.empty()) {
+        return;
+    }
+    ETM_PROFILE(const double uploadStart = profiler.now());
+
+    if (!atlas) {
+        std::sort(renderGlyphs.begin(), renderGlyphs.end(), [](const glyph &a, const glyph &b) -> bool {
+            return a.codepoint < b.codepoint;
+        });
+    }
+    renderCells.clear();
+    for (const glyph &g : renderGlyphs) {
+        renderCells.push_back(g.cell);
+    }
+
+    // One upload for the whole frame...
+    const std::size_t offset = res->streamCells(renderCells.data(), renderCells.size());
+    ETM_PROFILE(profiler.addSpan(Profiler::UPLOAD, uploadStart, profiler.now() - uploadStart));
+    ETM_PROFILE_SCOPE(profiler, Profiler::DRAW);
+    // ...and one draw for each distinct glyph, or just the one
+    for (std::size_t i = 0; i < renderGlyphs.size();) {
+        std::size_t groupEnd = atlas ? renderGlyphs.size() : i + 1;
+        while (groupEnd < renderGlyphs.size() && renderGlyphs[groupEnd].codepoint == renderGlyphs[i].codepoint) {
+            groupEnd++;
+        }
+        font.bindChar(renderGlyphs[i].codepoint);
+        res->renderCells(
+            offset + i * sizeof(shader::Cell::instance),
+            static_cast<int>(groupEnd - i)
+        );
+        i = groupEnd;
+    }
+    res->fenceCells();
+}
+
+void etm::TextBuffer::shapeGlyphs(EtmFont &font, std::size_t first) {
+    // Clusters (ex. with accents) and wide chars have a glyph of their
+    // own, and nothing joins across a space.
+    // Ids that fonts give out are past the last codepoint.
+    auto shapeable = [](const glyph &g) -> bool {
+        return g.cell.span == 1 && g.codepoint != ' ' && g.codepoint < 0x110000;
+    };
+    auto sameRun = [](const glyph &a, const glyph &b) -> bool {
+        return b.cell.column == a.cell.column + 1 &&
+            std::equal(a.cell.back, a.cell.back + 3, b.cell.back) &&
+            std::equal(a.cell.fore, a.cell.fore + 3, b.cell.fore);
+    };
+
+    // Glyphs are moved down over the ones that were merged
+    std::size_t out = first;
+    for (std::size_t i = first; i < renderGlyphs.size();) {
+        std::size_t runEnd = i;
+        cluster.clear();
+        while (runEnd < renderGlyphs.size() && shapeable(renderGlyphs[runEnd]) && (runEnd == i || sameRun(renderGlyphs[runEnd - 1], renderGlyphs[runEnd]))) {
+            cluster.push_back(renderGlyphs[runEnd].codepoint);
+            runEnd++;
+        }
+        EtmFont::shaped_t run;
+        if (cluster.size() > 1) {
+            run = font.shape(cluster.data(), cluster.size());
+        }
+        if (run == nullptr) {
+            for (const std::size_t stop = std::max(runEnd, i + 1); i < stop; i++) {
+                renderGlyphs[out++] = renderGlyphs[i];
+            }
+            continue;
+        }
+        for (const EtmFont::shapedGlyph &s : *run) {
+            glyph g = renderGlyphs[i];
+            g.codepoint = s.glyph;
+            g.cell.span = static_cast<int>(s.cells);
+            font.getGlyphRegion(g.codepoint, g.cell.glyph);
+            renderGlyphs[out++] = g;
+            i += s.cells;
+        }
     }
+    renderGlyphs.resize(out);
 }
 
 void etm::TextBuffer::renderCursor(int x, int y) {
@@ -5,19 +5,26 @@
 #include <map>
 #include <string>
 #include <memory>
+#include <functional>
+#include <cstddef>
 
 #include "gui/Rectangle.h"
 #include "render/Color.h"
+#include "shader/Cell.h"
 #include "Line.h"
 #include "codec.h"
 #include "util/IdList.h"
 #include "textmods/Mod.h"
+#include "SearchIndex.h"
+#include "InputBuffer.h"
 
 namespace etm {
     // Resources
     class Resources;
     // render/Font
     class Font;
+    // render/EtmFont
+    class EtmFont;
     // Scroll
     class Scroll;
     namespace tm {
@@ -49,6 +56,10 @@ namespace etm {
         /// modifier containter type
         typedef IdList<mod_t> modifierBlocks_t;
 
+        /// Receives exported text, one contiguous span at a time.
+        /// @see exportText(const pos &start, const pos &end, const sink_t &sink, bool styled)
+        typedef std::function<void(const char *data, std::size_t size)> sink_t;
+
         /**
         * A position in the buffer
         */
@@ -69,6 +80,32 @@ namespace etm {
             pos(lines_number_t row, line_index_t column);
         };
 
+        /**
+        * A range of text found by @ref search(const std::string &query, searchFlag::type flags)
+        */
+        struct match {
+            /// The first codepoint in the match
+            pos start;
+            /// The end of the match (column exclusive),
+            /// same as the end given to @ref getTextFromRange(const pos &start, const pos &end)
+            pos end;
+        };
+
+        /**
+        * Flags that change how @ref search(const std::string &query, searchFlag::type flags)
+        * interprets the query.
+        */
+        struct searchFlag {
+            /// The general flag datatype
+            typedef int type;
+            /// Flag for no flags, aka literal and case sensitive
+            static constexpr type none = 0;
+            /// The query is a regular expression (ECMAScript)
+            static constexpr type regex = 1 << 0;
+            /// Ignore the case of ASCII letters
+            static constexpr type nocase = 1 << 1;
+        };
+
     private:
 
         /// Handle to the resource manager
@@ -127,6 +164,147 @@ namespace etm {
         /// All the @ref TextState modifier blocks
         modifierBlocks_t modifierBlocks;
 
+        /// A glyph queued up by @ref render(), and the cell it goes in
+        struct glyph {
+            /// The codepoint, or whatever the font
+            /// gave in its place (ex. a cluster id)
+            unsigned int codepoint;
+            /// Where and in what colors to render it
+            shader::Cell::instance cell;
+        };
+        /// Glyphs collected by @ref render().
+        /// Kept between frames so that the memory is reused.
+        std::vector<glyph> renderGlyphs;
+        /// The cells of @ref renderGlyphs, grouped by codepoint,
+        /// ready to be uploaded.
+        std::vector<shader::Cell::instance> renderCells;
+        /// The codepoints of a grapheme cluster, used when
+        /// appending and rendering - or of a run being shaped.
+        /// Kept so that the memory is reused.
+        std::vector<unsigned int> cluster;
+
+        /**
+        * Shapes the glyphs of a row that were just collected by
+        * @ref render(), replacing each run with the glyphs it was
+        * shaped into (see @ref EtmFont::shape()).
+        * A run is a stretch of single cell codepoints in the same
+        * colors, broken up by spaces, which keeps the runs short
+        * and likely to repeat.
+        * @param [in] font The font
+        * @param [in] first Index in @ref renderGlyphs of the row's first glyph
+        */
+        void shapeGlyphs(EtmFont &font, std::size_t first);
+
+        /// Trigram index of the rows, lazily updated
+        /// on each search.
+        /// @see touch(lines_number_t row)
+        SearchIndex searchIndex;
+
+        /**
+        * Notifies the @ref searchIndex that a row has changed.
+        * Because trigrams can cross over into the next row, this
+        * invalidates the row before it as well.
+        * @param [in] row The row that changed
+        */
+        void touch(lines_number_t row);
+
+        /// The input, after @ref cursorMin.
+        /// Kept in step with the rows by edits at the cursor.
+        /// @see getInput()
+        InputBuffer input;
+        /// If @ref input has fallen out of step with the rows
+        /// (ex. text was appended after @ref cursorMin), and has
+        /// to be read back out of them
+        bool inputDirty;
+        /// Ranges of @ref input drawn in @ref markColor
+        /// @see setInputMarks(const InputBuffer::tokens_t &marks)
+        InputBuffer::tokens_t inputMarks;
+        /// The @ref InputBuffer::getRevision() "revision" of
+        /// @ref input that @ref inputMarks were set for
+        unsigned int marksRevision;
+        /// Color of @ref inputMarks
+        /// @see setMarkColor(const Color &color)
+        Color markColor;
+
+        /// Where an edit can start changing the @ref input
+        /// @see keepInput(lines_number_t row)
+        struct inputKeep {
+            /// Where the rest of the input starts, which is where the
+            /// row before the edited one ends (or @ref cursorMin).
+            /// As a row relative to @ref cursorMin, since rows can
+            /// be trimmed from the front.
+            lines_number_t rows;
+            /// The number of bytes of input before it
+            InputBuffer::size_type bytes;
+            /// If the @ref input was in step beforehand.
+            /// If not, it's read out of the rows when it's next needed.
+            bool valid;
+        };
+        /**
+        * Gets where the input that an edit could change starts.
+        * Row edits re-wrap from the row before, so the rows before
+        * that won't change, and neither will their input.
+        * @param [in] row The row that's going to be edited
+        * @return Where it starts
+        * @see syncInput(const inputKeep &keep)
+        */
+        inputKeep keepInput(lines_number_t row);
+        /**
+        * Updates the @ref input after an edit, from where
+        * @ref keepInput(lines_number_t row) said it could change.
+        * Only the part that did change is given to the @ref input,
+        * so that it has as few tokens as possible to re-scan.
+        * @param [in] keep Where the input could've changed
+        */
+        void syncInput(const inputKeep &keep);
+        /**
+        * Gets the position where the input after a row starts.
+        * @param [in] rows The row, relative to @ref cursorMin
+        * @return The end of the row, or @ref cursorMin
+        */
+        pos inputStart(lines_number_t rows);
+        /**
+        * Gets the position after the last char.
+        * @return The position
+        */
+        pos lastPos();
+        /**
+        * Reads the input in a range, the same way as
+        * @ref doGetTextFromRange(const pos &start, const pos &stop)
+        * but without the joins of grapheme clusters (see @ref grapheme::JOIN),
+        * so that it's what was typed.
+        * @note Does not do bounds checks
+        * @param [in] start Start position
+        * @param [in] stop End position
+        * @param [out] out Where to append the text, or `nullptr`
+        * to only count it
+        * @return The size of the text
+        */
+        InputBuffer::size_type doReadInput(const pos &start, const pos &stop, std::string *out);
+        /**
+        * Concatenates the text of all the rows that make up the logical
+        * line (rows joined by soft wraps) that contains `row`.
+        * @param [in] row A row in the logical line
+        * @param [out] text The text, without any control sequences
+        * @param [out] starts The offset in `text` at which each row starts,
+        * including the start space
+        * @return The first row in the logical line
+        */
+        lines_number_t joinRows(lines_number_t row, std::string &text, std::vector<std::string::size_type> &starts);
+        /**
+        * Convert a byte offset in text obtained via
+        * @ref joinRows(lines_number_t row, std::string &text, std::vector<std::string::size_type> &starts)
+        * back to a position in the buffer.
+        * @param [in] first The first row in the logical line
+        * @param [in] text The logical line text
+        * @param [in] starts The row offsets in `text`
+        * @param [in] offset The byte offset
+        * @param [in] end If `true`, the offset is treated as an exclusive end, and
+        * won't be mapped to the start of the next row
+        * @return The position
+        */
+        pos mapOffset(lines_number_t first, const std::string &text, const std::vector<std::string::size_type> &starts, std::string::size_type offset, bool end);
+
         /**
         * Checks if the line count is less than or equal to
         * @ref maxNumberLines.
@@ -154,6 +332,11 @@ namespace etm {
         * Append the given codepoint to the end of the last line.
         * If the last line's @e deFacto width would be larger than
         * @ref width, wraps the text.
+        * Wide chars are followed by a filler (see @ref wide::FILLER),
+        * and codepoints that continue the last grapheme cluster are
+        * joined to it (see @ref grapheme::JOIN). Fillers and joins
+        * that are given are ignored, so that they can be regenerated
+        * when reformatting.
         */
         void doAppend(const Line::codepoint &c);
         /**
@@ -173,6 +356,22 @@ namespace etm {
         */
         bool outOfBounds(lines_number_t row, line_index_t column);
         /**
+        * Check if the given position is the filler column of a wide char.
+        * @note Does not do bounds checks on `row`
+        * @param [in] row Character row
+        * @param [in] column Character column
+        * @return `true` if yes
+        * @see wide::FILLER
+        */
+        bool isFiller(lines_number_t row, line_index_t column);
+        /**
+        * Moves the cursor off a wide char's filler column,
+        * so that it never rests in the middle of a wide char.
+        * @param [in] direction Negative to snap to the start of the
+        * wide char, positive to snap to the column after it
+        */
+        void snapCursor(int direction);
+        /**
         * Erase a codepoint.
         * @note Does not do bounds checks
         * @param [in] row Character row
@@ -249,6 +448,15 @@ namespace etm {
         * @return The text
         */
         std::string doGetTextFromRange(const pos &start, const pos &end);
+        /**
+        * Writes the text in a given range to a sink.
+        * @note Does @e NOT do range checks. Call @ref clampPos if you're not sure.
+        * @param [in] start The start position
+        * @param [in] end The end position (column exclusive)
+        * @param [in] sink The output
+        * @param [in] styled Whether to include ANSI escapes for the text styles
+        */
+        void doExportText(const pos &start, const pos &end, const sink_t &sink, bool styled);
 
         /**
         * Gets the valid range (zero indexed indices,
@@ -276,6 +484,23 @@ namespace etm {
         */
         std::string getTextFromRange(const pos &start, const pos &end);
 
+        /**
+        * Writes the text in a given range to a sink, without building
+        * it all up in memory first.
+        * Each row is written as a few large spans, the control sequences
+        * between them are skipped.
+        * The output is the same as @ref getTextFromRange(const pos &start, const pos &end),
+        * unless `styled` is set.
+        * @note Does range checks
+        * @param [in] start The start position
+        * @param [in] end The end position (column exclusive)
+        * @param [in] sink The output
+        * @param [in] styled If `true`, the color modifiers are written as
+        * standard ANSI escape sequences, so that the text can be archived
+        * and viewed elseware with its colors
+        */
+        void exportText(const pos &start, const pos &end, const sink_t &sink, bool styled = false);
+
         /**
         * Sets the scroll backend.
         * @param [in] scroll The scroll backend
@@ -289,7 +514,9 @@ namespace etm {
         void pushMod(const std::shared_ptr<tm::Mod> &mod);
 
         /**
-        * Delete all lines, and clear all caches.
+        * Delete all lines and modifiers.
+        * @note The font's glyph cache is left alone, since the
+        * same glyphs are likely to be displayed again
         */
         void clear();
 
@@ -515,14 +742,95 @@ namespace etm {
         * @see setSelectionEnd(lines_number_t row, line_index_t column)
         */
         std::string getSelectionText();
+        /**
+        * Sets the selection to a range, for example
+        * to highlight a @ref match.
+        * @param [in] start The start of the range
+        * @param [in] end The end of the range (column exclusive)
+        * @see initSelection(lines_number_t row, line_index_t column)
+        * @see setSelectionEnd(lines_number_t row, line_index_t column)
+        */
+        void select(const pos &start, const pos &end);
+
+        /**
+        * Finds all occurrences of `query` in the buffer.
+        * Matches may span soft wrapped rows, but never a newline.
+        * Literal queries of three or more bytes only look at the rows
+        * that the @ref searchIndex says could contain them, everything
+        * else has to scan every row.
+        * @note Invalid regular expressions are reported as non-severe errors
+        * @param [in] query The text, or pattern, to search for
+        * @param [in] flags How to interpret `query`
+        * @return The matches, in order
+        * @see searchFlag
+        * @see select(const pos &start, const pos &end)
+        */
+        std::vector<match> search(const std::string &query, searchFlag::type flags = searchFlag::none);
+
+        /**
+        * Saves the contents of the buffer to a binary snapshot,
+        * which can be restored later with @ref load(const std::string &path, float &scrollOffset).
+        * Unlike replaying the text, this keeps the exact wrapping and
+        * the text styles. The modifiers are saved by their effect
+        * (see @ref tm::Recorder), so custom @ref tm::Mod "mods" are
+        * restored as built-in ones that do the same thing.
+        * @note Errors are reported as non-severe
+        * @param [in] path The file to write to, overwritten if it exists
+        * @return `true` on success
+        */
+        bool save(const std::string &path);
+        /**
+        * Replaces the contents of the buffer with a snapshot
+        * created by @ref save(const std::string &path).
+        * The file is memory mapped and the lines are copied out
+        * in one pass, without having to decode or re-wrap them
+        * (unless the width has changed since).
+        * If the file isn't a valid snapshot, the buffer is left as it was.
+        * @note Errors are reported as non-severe
+        * @param [in] path The file to read
+        * @param [out] scrollOffset The scroll offset at the time of saving
+        * @return `true` on success
+        */
+        bool load(const std::string &path, float &scrollOffset);
+
         /**
         * Gets the text after the min cursor point, aka the
         * text from the input area.
         * @return The input text
         * @see lockCursor()
         * @see getSelectionText()
+        * @see getInput()
         */
         std::string pollInput();
+        /**
+        * Gets the input, along with its tokens.
+        * It's kept as edits are made at the cursor, so it only has to
+        * be read out of the rows if something else changed them (ex.
+        * text was appended before @ref lockCursor() was called).
+        * @return The input
+        */
+        const InputBuffer &getInput();
+        /**
+        * Moves the input out of the buffer, with escapes filtered
+        * (see @ref InputBuffer::take(std::string &out)).
+        * The text stays on screen.
+        * @param [out] out The input (replaced)
+        */
+        void takeInput(std::string &out);
+        /**
+        * Draws ranges of the input in the mark color, until the
+        * input next changes (ex. to point out mistakes as they're typed).
+        * @param [in] marks The ranges, as offsets into the text of
+        * @ref getInput(), in order
+        * @see setMarkColor(const Color &color)
+        */
+        void setInputMarks(const InputBuffer::tokens_t &marks);
+        /**
+        * Sets the color that marked input is drawn in.
+        * @param [in] color The color
+        * @see setInputMarks(const InputBuffer::tokens_t &marks)
+        */
+        void setMarkColor(const Color &color);
 
         /**
         * Deletes text after the user input start, set by @ref lockCursor().
@@ -542,8 +850,7 @@ namespace etm {
         * current framebuffer.
         * The height and width are determined by @ref width (columns)
         * and the value of @ref scroll's getNetWidth().
-        * @note Requires that the text shader be set.
-        * @note Exits with the text shader active
+        * @note Binds the cell shader (@ref shader::Cell) itself, and exits with it active
         * @note Only renders text as high as the value of @ref scroll's
         * getNetWidth() return. However, still has to do a lookbehind to
         * determine the current style, which can range from O(1) to O(n)
@@ -247,3 +247,57 @@ std::string etm::utf8::encode(codepoint_t codepoint) {
 
     return result;
 }
+
+bool etm::wide::testFiller(char c) {
+    return c == FILLER;
+}
+
+bool etm::grapheme::testJoin(char c) {
+    return c == JOIN;
+}
+
+bool etm::grapheme::continues(const utf8::codepoint_t *cluster, std::size_t count, utf8::codepoint_t c) {
+    const property before = getProperty(cluster[count - 1]);
+    const property after = getProperty(c);
+    // The rules are numbered as in UAX #29.
+    // GB3-5: Controls stand alone (newlines never get this far)
+    if (before == CR || before == LF || before == CONTROL || after == CR || after == LF || after == CONTROL) {
+        return false;
+    }
+    // GB6-8: Hangul syllables
+    if (before == L && (after == L || after == V || after == LV || after == LVT)) {
+        return true;
+    }
+    if ((before == LV || before == V) && (after == V || after == T)) {
+        return true;
+    }
+    if ((before == LVT || before == T) && after == T) {
+        return true;
+    }
+    // GB9, GB9a: Combining marks and the like
+    if (after == EXTEND || after == ZWJ || after == SPACING_MARK) {
+        return true;
+    }
+    // GB9b
+    if (before == PREPEND) {
+        return true;
+    }
+    // GB11: Emoji ZWJ sequences
+    if (before == ZWJ && after == EXTENDED_PICTOGRAPHIC) {
+        std::size_t i = count - 1;
+        while (i > 0 && getProperty(cluster[i - 1]) == EXTEND) {
+            i--;
+        }
+        return i > 0 && getProperty(cluster[i - 1]) == EXTENDED_PICTOGRAPHIC;
+    }
+    // GB12-13: Flags are pairs of regional indicators
+    if (before == REGIONAL_INDICATOR && after == REGIONAL_INDICATOR) {
+        std::size_t run = 0;
+        while (run < count && getProperty(cluster[count - 1 - run]) == REGIONAL_INDICATOR) {
+            run++;
+        }
+        return run % 2 == 1;
+    }
+    // GB999
+    return false;
+}
@@ -2,6 +2,10 @@
 #define ETERMAL_CODEC_H_INCLUDED
 
 #include <string>
+#include <cstddef>
+
+#include "util/widthTable.h"
+#include "util/graphemeTable.h"
 
 namespace etm {
 
@@ -114,6 +118,113 @@ namespace etm {
         */
         std::string encode(codepoint_t codepoint);
     }
+
+    /**
+    * Handles wide (East Asian Wide and Fullwidth) chars,
+    * which take up two columns rather than one.
+    * In a @ref Line, every wide char is followed by a
+    * @ref FILLER byte that stands in for its second column,
+    * so that the @e deFacto index is always the column.
+    */
+    namespace wide {
+        /// The byte that fills the second column of a wide char
+        constexpr char FILLER = '\x10';
+
+        /**
+        * Test if the given char is a filler.
+        * @param [in] c The char to test
+        * @return `true` if yes
+        * @see FILLER
+        */
+        bool testFiller(char c);
+
+        /**
+        * Gets the number of columns a codepoint takes up.
+        * Anything below @ref widthTable::FIRST_WIDE (ASCII, Latin,
+        * Greek, Cyrillic...) is returned immediately, and the rest
+        * costs two table lookups.
+        * @param [in] c The codepoint
+        * @return 2 if the codepoint is wide, otherwise 1
+        * @see ../../dev/genwidth
+        */
+        constexpr int columns(utf8::codepoint_t c) {
+            if (c < widthTable::FIRST_WIDE || c >= widthTable::BLOCK_SIZE * sizeof(widthTable::stage1)) {
+                return 1;
+            }
+            const std::uint64_t *block = widthTable::blocks[widthTable::stage1[c / widthTable::BLOCK_SIZE]];
+            const utf8::codepoint_t bit = c % widthTable::BLOCK_SIZE;
+            return (block[bit / 64] >> (bit % 64)) & 1 ? 2 : 1;
+        }
+    }
+
+    /**
+    * Handles grapheme clusters (UAX #29), ex. a letter followed
+    * by combining accents, or an emoji ZWJ sequence, which are
+    * drawn as and edited like a single char.
+    * In a @ref Line, every codepoint that continues a cluster is
+    * preceded by a @ref JOIN byte, so that the whole cluster
+    * takes up one @e deFacto index.
+    */
+    namespace grapheme {
+        /// The byte that joins a codepoint to the cluster before it
+        constexpr char JOIN = '\x11';
+
+        /**
+        * Grapheme_Cluster_Break property values, with
+        * Extended_Pictographic folded in.
+        * @see ../../dev/gengraphemes
+        */
+        enum property {
+            OTHER,
+            CR,
+            LF,
+            CONTROL,
+            EXTEND,
+            ZWJ,
+            REGIONAL_INDICATOR,
+            PREPEND,
+            SPACING_MARK,
+            L,
+            V,
+            T,
+            LV,
+            LVT,
+            EXTENDED_PICTOGRAPHIC
+        };
+
+        /**
+        * Test if the given char is a join.
+        * @param [in] c The char to test
+        * @return `true` if yes
+        * @see JOIN
+        */
+        bool testJoin(char c);
+
+        /**
+        * Gets the property of a codepoint, with two table lookups.
+        * @param [in] c The codepoint
+        * @return The property
+        */
+        constexpr property getProperty(utf8::codepoint_t c) {
+            if (c >= graphemeTable::BLOCK_SIZE * sizeof(graphemeTable::stage1) / sizeof(graphemeTable::stage1[0])) {
+                return OTHER;
+            }
+            const std::uint8_t pair = graphemeTable::blocks
+                [graphemeTable::stage1[c / graphemeTable::BLOCK_SIZE]]
+                [c % graphemeTable::BLOCK_SIZE / 2];
+            return static_cast<property>(c % 2 ? pair >> 4 : pair & 0xF);
+        }
+
+        /**
+        * Checks if a codepoint continues a cluster, rather
+        * than starting a new one (there's no break between them).
+        * @param [in] cluster The codepoints of the cluster so far
+        * @param [in] count The number of codepoints in `cluster`, at least 1
+        * @param [in] c The next codepoint
+        * @return `true` if `c` is part of the cluster
+        */
+        bool continues(const utf8::codepoint_t *cluster, std::size_t count, utf8::codepoint_t c);
+    }
 }
 
 #endif
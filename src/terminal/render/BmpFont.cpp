@@ -2,6 +2,7 @@
 
 #include <stdexcept>
 #include <cstring>
+#include <algorithm>
 
 // Note: in stb_image.c, set to only bitmap files.
 // That should help somewhat.
@@ -10,6 +11,58 @@
 #include <stb/stb_image_write.h>
 
 #include "opengl.h"
+#include "GlyphPack.h"
+
+/**
+* Decodes a bitmap font and cuts it up into glyphs.
+* @param [in] path Path to the bitmap
+* @param [in] width The pixel width of each glyph
+* @param [in] height The pixel height of each glyph
+* @param [in] count The max number of glyphs, including the "null" glyph
+* @param [out] glyphs The glyphs, one after the other, each
+* flipped so that the bottom row comes first
+* @return The number of glyphs read
+* @throw std::invalid_argument if the given `path` cannot be opened or decoded
+*/
+static unsigned int sliceGlyphs(const std::string &path, int width, int height, unsigned int count, std::vector<unsigned char> &glyphs);
+
+unsigned int sliceGlyphs(const std::string &path, int width, int height, unsigned int count, std::vector<unsigned char> &glyphs) {
+    stbi_set_flip_vertically_on_load(false);
+
+    constexpr int channels = 1;
+    int imgWidth, imgHeight;
+    unsigned char *img = stbi_load(path.c_str(), &imgWidth, &imgHeight, NULL, channels);
+    if (img == NULL) {
+        throw std::invalid_argument("etm::BmpFont: Failed to load bitmap font \"" + path + "\"");
+    }
+
+    const int rows = imgHeight / height;
+    const int columns = imgWidth / width;
+
+    const std::size_t glyphSize = static_cast<std::size_t>(width) * height * channels;
+    const unsigned int available = static_cast<unsigned int>(std::max(rows * columns, 0));
+    const unsigned int total = std::min(count, available);
+    glyphs.assign(glyphSize * total, 0);
+
+    for (unsigned int glyphIndex = 0; glyphIndex < total; glyphIndex++) {
+        const int x = glyphIndex % columns;
+        const int y = glyphIndex / columns;
+        const int offset = (x * width + y * height * imgWidth) * channels;
+        unsigned char *dest = glyphs.data() + glyphIndex * glyphSize;
+        // Copy row by row, flipping because OpenGL
+        // operates with 0,0 at the lower left corner.
+        for (int cy = 0; cy < height; cy++) {
+            std::memcpy(
+                dest + (height - 1 - cy) * width * channels,
+                img + offset + cy * imgWidth * channels,
+                width * channels
+            );
+        }
+    }
+
+    stbi_image_free(img);
+    return total;
+}
 
 etm::BmpFont::BmpFont(
     const std::string &path,
@@ -19,66 +72,26 @@ etm::BmpFont::BmpFont(
     char_t count
 ):
     startCodepoint(startCodepoint),
-    glyphs(count),
     width(glyphWidth),
     height(glyphHeight)
 {
+    std::vector<unsigned char> data;
+    const unsigned int total = sliceGlyphs(path, width, height, count, data);
+
     GLint unpackAlign;
     glGetIntegerv(GL_UNPACK_ALIGNMENT, &unpackAlign);
 
     glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
 
-    stbi_set_flip_vertically_on_load(false);
-
-    constexpr int channels = 1;
-    int imgWidth, imgHeight;
-    unsigned char *img = stbi_load(path.c_str(), &imgWidth, &imgHeight, NULL, channels);
-    if (img == NULL) {
-        glPixelStorei(GL_UNPACK_ALIGNMENT, unpackAlign);
-        throw std::invalid_argument("etm::BmpFont: Failed to load bitmap font \"" + path + "\"");
+    const std::size_t glyphSize = static_cast<std::size_t>(width) * height;
+    glyphs.resize(total);
+    for (unsigned int i = 0; i < total; i++) {
+        glyphs[i].setData(GL_RED, width, height, data.data() + i * glyphSize);
     }
 
-    const int rows = imgHeight / height;
-    const int columns = imgWidth / width;
-
-    const int bufferSize = width * height * channels;
-    unsigned char *buffer = new unsigned char[bufferSize];
-
-    unsigned int glyphIndex = 0;
-
-    bool doLoop = true;
-    for (int y = 0; y < rows && doLoop; y++) {
-        for (int x = 0; x < columns; x++) {
-            const int offset = (x * width + y * height * imgWidth) * channels;
-            // Clear buffer
-            std::memset(buffer, 0, bufferSize);
-            // Copy range
-            for (int cy = 0; cy < height; cy++) {
-                for (int cx = 0; cx < width; cx++) {
-                    const int srcIndex = offset + (cx + cy * imgWidth) * channels;
-                    const int insIndex = (cx + (height - 1 - cy) * width) * channels;
-                    buffer[insIndex] = img[srcIndex];
-                }
-            }
-            // Insert into texture
-            glyphs[glyphIndex].setData(GL_RED, width, height, buffer);
-            glyphIndex++;
-            if (glyphIndex >= glyphs.size()) {
-                doLoop = false;
-                break;
-            }
-        }
-    }
-
-    delete[] buffer;
-    stbi_image_free(img);
     if (unpackAlign != 1) {
         glPixelStorei(GL_UNPACK_ALIGNMENT, unpackAlign);
     }
-
-    // Truncate remaining glyphs
-    glyphs.resize(glyphIndex);
-    glyphs.shrink_to_fit();
 }
 
 void etm::BmpFont::setResMan(Resources *res) {
@@ -98,6 +111,10 @@ void etm::BmpFont::bindChar(char_t c) {
         glyphs[0].bind();
     }
 }
+bool etm::BmpFont::hasChar(char_t c) {
+    // Index 0 is the "null" glyph
+    return c >= startCodepoint && c - startCodepoint + 1 < glyphs.size();
+}
 void etm::BmpFont::clearCache() {
     // Do nothing, there's no cache
 }
@@ -107,3 +124,24 @@ int etm::BmpFont::getCharWidth() {
 int etm::BmpFont::getCharHeight() {
     return height;
 }
+
+void etm::BmpFont::exportPack(
+    const std::string &path,
+    char_t startCodepoint,
+    char_t glyphWidth,
+    char_t glyphHeight,
+    char_t count,
+    GlyphPack &pack
+) {
+    std::vector<unsigned char> data;
+    const unsigned int total = sliceGlyphs(path, glyphWidth, glyphHeight, count, data);
+
+    const std::size_t glyphSize = static_cast<std::size_t>(glyphWidth) * glyphHeight;
+    pack = GlyphPack(glyphWidth, glyphHeight);
+    if (total > 0) {
+        pack.setFallback(data.data());
+    }
+    for (unsigned int i = 1; i < total; i++) {
+        pack.add(startCodepoint + i - 1, data.data() + i * glyphSize);
+    }
+}
@@ -7,6 +7,11 @@
 #include "EtmFont.h"
 #include "Texture.h"
 
+namespace etm {
+    // GlyphPack
+    class GlyphPack;
+}
+
 namespace etm {
 
     /**
@@ -70,6 +75,35 @@ namespace etm {
         void clearCache() override;
         int getCharWidth() override;
         int getCharHeight() override;
+        /**
+        * @param [in] c The codepoint
+        * @return `true` if `c` is in the bitmap's range
+        */
+        bool hasChar(char_t c) override;
+
+        /**
+        * Slice up a bitmap font into a glyph pack, which can
+        * then be saved and loaded much faster with @ref PackFont.
+        * Doesn't need an OpenGL context.
+        * Takes the same parameters as the constructor.
+        * @param [in] path Path to the bitmap
+        * @param [in] startCodepoint The value of the starting codepoint
+        * @param [in] glyphWidth The pixel width of each glyph
+        * @param [in] glyphHeight The pixel height of each glyph
+        * @param [in] count The number of glyphs, not including the "null" glyph,
+        * which becomes the pack's fallback
+        * @param [out] pack The pack to fill
+        * @throw std::invalid_argument if the given `path` cannot be opened or decoded
+        * @see BmpFont(const std::string &path, char_t startCodepoint, char_t glyphWidth, char_t glyphHeight, char_t count)
+        */
+        static void exportPack(
+            const std::string &path,
+            char_t startCodepoint,
+            char_t glyphWidth,
+            char_t glyphHeight,
+            char_t count,
+            GlyphPack &pack
+        );
     };
 }
 
@@ -1,6 +1,7 @@
 #include "Buffer.h"
 
 #include "opengl.h"
+#include "GLState.h"
 
 etm::Buffer::Buffer() {
     gen();
@@ -40,6 +41,11 @@ void etm::Buffer::gen() {
 void etm::Buffer::deGen() {
     // If `array` is zero, signals that it was moved.
     if (array) {
+        if (GLState *state = GLState::current()) {
+            state->forgetVertexArray(array);
+            state->forgetBuffer(vertices);
+            state->forgetBuffer(indices);
+        }
         glDeleteVertexArrays(1, &array);
         glDeleteBuffers(1, &vertices);
         glDeleteBuffers(1, &indices);
@@ -48,13 +54,25 @@ void etm::Buffer::deGen() {
 }
 
 void etm::Buffer::bindArray() const {
-    glBindVertexArray(array);
+    if (GLState *state = GLState::current()) {
+        state->bindVertexArray(array);
+    } else {
+        glBindVertexArray(array);
+    }
 }
 void etm::Buffer::bindVert() const {
-    glBindBuffer(GL_ARRAY_BUFFER, vertices);
+    if (GLState *state = GLState::current()) {
+        state->bindArrayBuffer(vertices);
+    } else {
+        glBindBuffer(GL_ARRAY_BUFFER, vertices);
+    }
 }
 void etm::Buffer::bindElem() const {
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indices);
+    if (GLState *state = GLState::current()) {
+        state->bindElementBuffer(indices);
+    } else {
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indices);
+    }
 }
 void etm::Buffer::bind() const {
     bindArray();
@@ -85,3 +103,7 @@ void etm::Buffer::render() {
     // indices in the element buffer
     glDrawElements(GL_TRIANGLES, countIndices, GL_UNSIGNED_INT, 0);
 }
+void etm::Buffer::renderInstanced(int count) {
+    bind();
+    glDrawElementsInstanced(GL_TRIANGLES, countIndices, GL_UNSIGNED_INT, 0, count);
+}
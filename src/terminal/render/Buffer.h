@@ -116,6 +116,14 @@ namespace etm {
         * @note Must be rendered in the same context it was created in.
         */
         void render();
+        /**
+        * Render @p count instances of the @ref indices.
+        * Like @ref render(), except that the shader's per-instance
+        * attributes must have been set up by the caller.
+        * @param [in] count Number of instances
+        * @see render()
+        */
+        void renderInstanced(int count);
     };
 }
 
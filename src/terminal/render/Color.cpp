@@ -5,6 +5,7 @@
 
 #include "../shader/Shader.h"
 #include "../render/opengl.h"
+#include "../render/GLState.h"
 
 static etm::Color::value_t valify(float p) {
     return std::round(p * 255);
@@ -63,10 +64,17 @@ etm::Color::prop_t *etm::Color::get() {
     // Important to be compatable with other thingies, ex OpenGL
     return color;
 }
+const etm::Color::prop_t *etm::Color::get() const {
+    return color;
+}
 
 void etm::Color::setRGB(int location) const {
     // Notice how the digit for the function
-    glUniform3fv(location, 1, color);
+    if (GLState *state = GLState::current()) {
+        state->uniform3fv(location, color);
+    } else {
+        glUniform3fv(location, 1, color);
+    }
 }
 
 void etm::Color::set(const shader::Shader &shader) const {
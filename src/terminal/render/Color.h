@@ -117,6 +117,14 @@ namespace etm {
         * @return Pointer to array of 3 floats, sorted RGB
         */
         prop_t *get();
+        /**
+        * Get pointer to data.
+        * @note The lifetime of the data pointed to by the pointer
+        * is tied to `*this`
+        * @return Pointer to array of 3 floats, sorted RGB
+        * @see get()
+        */
+        const prop_t *get() const;
 
         /**
         * Binds RGB data to the color uniform in the current shader
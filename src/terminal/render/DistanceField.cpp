@@ -0,0 +1,190 @@
+#include "DistanceField.h"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+
+/// Stands in for infinity, so that the arithmetic stays finite
+static constexpr float FAR = 1e20f;
+
+/**
+* One dimensional squared euclidean distance transform,
+* from Felzenszwalb and Huttenlocher's
+* "Distance Transforms of Sampled Functions".
+* @param [in] f The squared distance of each sample, or @ref FAR
+* @param [in] n Number of samples
+* @param [out] d The transformed squared distances
+* @param [out] v Scratch, `n` ints
+* @param [out] z Scratch, `n + 1` floats
+*/
+static void transform(const float *f, int n, float *d, int *v, float *z);
+
+/**
+* Two dimensional squared euclidean distance transform.
+* @param [in,out] grid 0 for the pixels to measure the distance to,
+* @ref FAR for the rest; becomes the squared distances
+* @param [in] width The width of the grid
+* @param [in] height The height of the grid
+*/
+static void transform2D(std::vector<float> &grid, int width, int height);
+
+/**
+* Bilinearly samples a distance field, like GL_LINEAR with
+* a black GL_CLAMP_TO_BORDER.
+* @param [in] field The distance field
+* @param [in] x The x, in texels
+* @param [in] y The y, in texels
+* @return The value, 0-1
+*/
+static float sample(const etm::GlyphCache::bitmap &field, float x, float y);
+
+void transform(const float *f, int n, float *d, int *v, float *z) {
+    int k = 0;
+    v[0] = 0;
+    z[0] = -FAR;
+    z[1] = FAR;
+    for (int q = 1; q < n; q++) {
+        // Since f never exceeds FAR, s never drops to z[0]
+        // and k can't go below 0
+        float s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2.0f * (q - v[k]));
+        while (s <= z[k]) {
+            k--;
+            s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2.0f * (q - v[k]));
+        }
+        k++;
+        v[k] = q;
+        z[k] = s;
+        z[k + 1] = FAR;
+    }
+    k = 0;
+    for (int q = 0; q < n; q++) {
+        while (z[k + 1] < q) {
+            k++;
+        }
+        const float dist = static_cast<float>(q - v[k]);
+        d[q] = dist * dist + f[v[k]];
+    }
+}
+
+void transform2D(std::vector<float> &grid, int width, int height) {
+    const int longest = std::max(width, height);
+    std::vector<float> f(longest);
+    std::vector<float> d(longest);
+    std::vector<int> v(longest);
+    std::vector<float> z(longest + 1);
+
+    for (int x = 0; x < width; x++) {
+        for (int y = 0; y < height; y++) {
+            f[y] = grid[x + y * width];
+        }
+        transform(f.data(), height, d.data(), v.data(), z.data());
+        for (int y = 0; y < height; y++) {
+            grid[x + y * width] = d[y];
+        }
+    }
+    for (int y = 0; y < height; y++) {
+        float *row = grid.data() + y * width;
+        std::copy_n(row, width, f.begin());
+        transform(f.data(), width, row, v.data(), z.data());
+    }
+}
+
+float sample(const etm::GlyphCache::bitmap &field, float x, float y) {
+    const int x0 = static_cast<int>(std::floor(x));
+    const int y0 = static_cast<int>(std::floor(y));
+    const float fx = x - x0;
+    const float fy = y - y0;
+    auto texel = [&field](int tx, int ty) -> float {
+        if (tx < 0 || ty < 0 || tx >= field.width || ty >= field.height) {
+            return 0.0f;
+        }
+        return field.data[tx + ty * field.width] / 255.0f;
+    };
+    const float bottom = texel(x0, y0) * (1 - fx) + texel(x0 + 1, y0) * fx;
+    const float top = texel(x0, y0 + 1) * (1 - fx) + texel(x0 + 1, y0 + 1) * fx;
+    return bottom * (1 - fy) + top * fy;
+}
+
+etm::GlyphCache::bitmap_t etm::sdf::generate(const GlyphCache::bitmap &coverage) {
+    // Padded by a pixel on each side, so that the edges of
+    // the bitmap count as outside
+    const int width = coverage.width + 2;
+    const int height = coverage.height + 2;
+    std::vector<float> toInside(width * height, FAR);
+    std::vector<float> toOutside(width * height, FAR);
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            const int sx = x - 1;
+            const int sy = y - 1;
+            const bool inside = sx >= 0 && sy >= 0 && sx < coverage.width && sy < coverage.height &&
+                coverage.data[sx + sy * coverage.width] >= 128;
+            if (inside) {
+                toInside[x + y * width] = 0;
+            } else {
+                toOutside[x + y * width] = 0;
+            }
+        }
+    }
+    transform2D(toInside, width, height);
+    transform2D(toOutside, width, height);
+
+    std::shared_ptr<GlyphCache::bitmap> result = std::make_shared<GlyphCache::bitmap>();
+    result->width = coverage.width;
+    result->height = coverage.height;
+    result->data.resize(coverage.data.size());
+    for (int y = 0; y < coverage.height; y++) {
+        for (int x = 0; x < coverage.width; x++) {
+            const int i = (x + 1) + (y + 1) * width;
+            // The outline lies halfway between an inside
+            // and an outside pixel
+            float distance;
+            if (toInside[i] == 0) {
+                distance = std::sqrt(toOutside[i]) - 0.5f;
+            } else {
+                distance = 0.5f - std::sqrt(toInside[i]);
+            }
+            const float value = std::clamp(0.5f + distance / (2 * SPREAD), 0.0f, 1.0f);
+            result->data[x + y * coverage.width] = static_cast<unsigned char>(std::lround(value * 255));
+        }
+    }
+    return result;
+}
+
+void etm::sdf::resample(const GlyphCache::bitmap &field, int width, int height, std::vector<unsigned char> &coverage) {
+    // Sampled at pixel centers, like the fragment shader
+    std::vector<float> values(width * height);
+    const float scaleX = static_cast<float>(field.width) / width;
+    const float scaleY = static_cast<float>(field.height) / height;
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            values[x + y * width] = sample(field, (x + 0.5f) * scaleX - 0.5f, (y + 0.5f) * scaleY - 0.5f);
+        }
+    }
+    coverage.resize(width * height);
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            const float d = values[x + y * width];
+            // Stand-ins for dFdx and dFdy
+            float dx = 0;
+            float dy = 0;
+            if (x + 1 < width) {
+                dx = values[x + 1 + y * width] - d;
+            } else if (x > 0) {
+                dx = d - values[x - 1 + y * width];
+            }
+            if (y + 1 < height) {
+                dy = values[x + (y + 1) * width] - d;
+            } else if (y > 0) {
+                dy = d - values[x + (y - 1) * width];
+            }
+            const float w = 0.5f * std::sqrt(dx * dx + dy * dy);
+            float alpha;
+            if (w > 0) {
+                alpha = std::clamp((d - 0.5f) / (2 * w) + 0.5f, 0.0f, 1.0f);
+            } else {
+                alpha = d >= 0.5f ? 1.0f : 0.0f;
+            }
+            coverage[x + y * width] = static_cast<unsigned char>(std::lround(alpha * 255));
+        }
+    }
+}
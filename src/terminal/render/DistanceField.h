@@ -0,0 +1,49 @@
+#ifndef ETERMAL_DISTANCEFIELD_H_INCLUDED
+#define ETERMAL_DISTANCEFIELD_H_INCLUDED
+
+#include <vector>
+
+#include "GlyphCache.h"
+
+namespace etm {
+
+    /**
+    * Signed distance field glyphs.
+    * Instead of coverage, each pixel of a distance field stores how
+    * far it is from the glyph's outline, so that it can be scaled
+    * to any size with bilinear filtering and still come out sharp.
+    * Pixels are stored as `0.5 + distance / (2 * SPREAD)`, clamped
+    * to 0-1, so the outline sits at 0.5 and the inside is above it.
+    * @see Font::setDistanceField(bool value)
+    */
+    namespace sdf {
+        /// The pixel size distance fields are rendered at
+        constexpr unsigned int SIZE = 64;
+        /// The furthest distance from the outline that can be
+        /// represented, in pixels at @ref SIZE
+        constexpr float SPREAD = 8.0f;
+
+        /**
+        * Make a distance field from a coverage bitmap.
+        * Uses an exact euclidean distance transform, so it's
+        * not cheap - but it's only ever done once per glyph.
+        * @param [in] coverage The glyph, rendered at @ref SIZE
+        * @return The distance field, the same size as `coverage`
+        */
+        GlyphCache::bitmap_t generate(const GlyphCache::bitmap &coverage);
+
+        /**
+        * Render a distance field to a coverage bitmap, the same way
+        * the cell shader does on the GPU.
+        * Used to check the fidelity of distance fields against
+        * glyphs rendered normally.
+        * @param [in] field The distance field
+        * @param [in] width The width to render at
+        * @param [in] height The height to render at
+        * @param [out] coverage The rendered glyph, `width * height` bytes
+        */
+        void resample(const GlyphCache::bitmap &field, int width, int height, std::vector<unsigned char> &coverage);
+    }
+}
+
+#endif
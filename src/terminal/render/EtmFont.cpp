@@ -2,3 +2,34 @@
 
 etm::EtmFont::~EtmFont() {
 }
+
+void etm::EtmFont::update() {
+}
+unsigned int etm::EtmFont::getRevision() {
+    return 0;
+}
+
+bool etm::EtmFont::isAtlas() {
+    return false;
+}
+void etm::EtmFont::getGlyphRegion(char_t c, float *region) {
+    region[0] = 0.0f;
+    region[1] = 0.0f;
+    region[2] = 1.0f;
+    region[3] = 1.0f;
+}
+bool etm::EtmFont::isDistanceField() {
+    return false;
+}
+bool etm::EtmFont::hasChar(char_t c) {
+    return true;
+}
+etm::EtmFont::char_t etm::EtmFont::getClusterGlyph(const char_t *codepoints, std::size_t count) {
+    return codepoints[0];
+}
+bool etm::EtmFont::isShaping() {
+    return false;
+}
+etm::EtmFont::shaped_t etm::EtmFont::shape(const char_t *codepoints, std::size_t count) {
+    return nullptr;
+}
@@ -1,6 +1,10 @@
 #ifndef ETERMAL_ETMFONT_H_INCLUDED
 #define ETERMAL_ETMFONT_H_INCLUDED
 
+#include <vector>
+#include <memory>
+#include <cstddef>
+
 namespace etm {
     // ../Resource
     class Resources;
@@ -12,12 +16,28 @@ namespace etm {
     * Interface for all etermal fonts.
     * @see Font
     * @see BmpFont
+    * @see PackFont
+    * @see FontChain
     */
     class EtmFont {
     public:
         /// Codepoint type
         typedef unsigned int char_t;
 
+        /**
+        * A glyph that a run of text was shaped into.
+        * @see shape(const char_t *codepoints, std::size_t count)
+        */
+        struct shapedGlyph {
+            /// What to give to @ref bindChar(char_t c), either
+            /// the codepoint that was there or a font specific id
+            char_t glyph;
+            /// Number of cells it covers, ex. 2 for a `->` ligature
+            unsigned int cells;
+        };
+        /// A shaped run, one glyph after the other
+        typedef std::shared_ptr<const std::vector<shapedGlyph>> shaped_t;
+
         virtual ~EtmFont() = 0;
 
         /** @internal
@@ -39,6 +59,9 @@ namespace etm {
         virtual void bindChar(char_t c) = 0;
         /**
         * Clears the codepoint texture cache.
+        * @note Implementations may keep the rasterized glyphs
+        * elseware (see @ref GlyphCache), so this doesn't
+        * necessarily mean that they have to be rendered again
         */
         virtual void clearCache() = 0;
 
@@ -54,6 +77,83 @@ namespace etm {
         * @see charHeight
         */
         virtual int getCharHeight() = 0;
+
+        /**
+        * Finishes any work done in the background since the last call,
+        * ex. uploading glyphs that were rendered on another thread.
+        * Called at the start of each frame the terminal renders.
+        * Does nothing by default.
+        */
+        virtual void update();
+        /**
+        * Gets a number that changes whenever @ref update() has
+        * something new to do, so that terminals know when they
+        * have to be rendered again.
+        * @return The revision, `0` by default
+        */
+        virtual unsigned int getRevision();
+
+        /**
+        * Whether every glyph is in the same texture (an atlas),
+        * in which case @ref bindChar(char_t c) binds the same texture
+        * for every codepoint, and only @ref getGlyphRegion(char_t c, float *region)
+        * tells them apart.
+        * @return `false` by default
+        */
+        virtual bool isAtlas();
+        /**
+        * Gets the part of the texture bound by @ref bindChar(char_t c)
+        * that the codepoint's glyph takes up.
+        * By default, that's the whole texture.
+        * @param [in] c The codepoint
+        * @param [out] region Array of 4 texture coordinates, the
+        * left, bottom, right and top of the glyph
+        */
+        virtual void getGlyphRegion(char_t c, float *region);
+        /**
+        * Whether the glyph textures are signed distance
+        * fields rather than coverage.
+        * @return `false` by default
+        */
+        virtual bool isDistanceField();
+        /**
+        * Whether the font has a glyph for the codepoint, as opposed
+        * to drawing a "missing glyph" box or such in its place.
+        * Used by @ref FontChain to find the font to draw each
+        * codepoint with, so it should be cheap - but it's only
+        * asked once per codepoint.
+        * @param [in] c The codepoint
+        * @return `true` by default
+        */
+        virtual bool hasChar(char_t c);
+        /**
+        * Gets a glyph for a grapheme cluster (ex. a letter and its
+        * accents), to give to @ref bindChar(char_t c) and
+        * @ref getGlyphRegion(char_t c, float *region) in place of
+        * a codepoint.
+        * By default, clusters are drawn as their first codepoint.
+        * @param [in] codepoints The codepoints of the cluster
+        * @param [in] count The number of codepoints, at least 1
+        * @return The glyph
+        */
+        virtual char_t getClusterGlyph(const char_t *codepoints, std::size_t count);
+        /**
+        * Whether the font shapes text, in which case runs of text
+        * should be given to @ref shape(const char_t *codepoints, std::size_t count)
+        * before drawing them.
+        * @return `false` by default
+        */
+        virtual bool isShaping();
+        /**
+        * Shapes a run of single cell codepoints in the same style,
+        * ex. into the ligatures of a programming font.
+        * Called every frame for every run, so it should be cached.
+        * @param [in] codepoints The codepoints, one per cell
+        * @param [in] count The number of codepoints
+        * @return The glyphs, covering `count` cells in total -
+        * or `nullptr` if each codepoint is drawn as is (the default)
+        */
+        virtual shaped_t shape(const char_t *codepoints, std::size_t count);
     };
 }
 
@@ -5,12 +5,320 @@
 #include <iostream>
 #include <vector>
 #include <stdexcept>
+#include <memory>
+#include <utility>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
 
 #include "../Resources.h"
+#include "../codec.h"
+#include "../util/ThreadPool.h"
 #include "opengl.h"
 #include "FontLibrary.h"
+#include "GlyphPack.h"
+#include "DistanceField.h"
 
-etm::Font::Font(const std::string &path): res(nullptr) {
+#ifdef ETERMAL_HARFBUZZ
+#include <hb.h>
+#include <hb-ft.h>
+#endif
+
+/// The top bits of every cluster id
+static constexpr etm::Font::char_t CLUSTER_BITS = 0x80000000u;
+/// The top bits of every segment id
+static constexpr etm::Font::char_t SEGMENT_BITS = 0xC0000000u;
+/// Glyph positions in segments are in fractions of a cell,
+/// this many to a cell
+static constexpr int SEGMENT_UNITS = 1024;
+
+/**
+* Gets the size of each char in a face.
+* @param [in] face The face, with its size set
+* @param [out] charWidth The width
+* @param [out] charHeight The height
+*/
+static void getCharSize(FT_Face face, int &charWidth, int &charHeight);
+
+void getCharSize(FT_Face face, int &charWidth, int &charHeight) {
+    charWidth = std::ceil(face->size->metrics.max_advance / 64.0f);
+    // https://www.freetype.org/freetype2/docs/reference/ft2-base_interface.html#ft_facerec
+    // "If you want the global glyph height, use ascender - descender"
+    charHeight = std::ceil((face->size->metrics.ascender - face->size->metrics.descender) / 64.0f);
+}
+
+/**
+* Gets the name that identifies a face's glyphs in the @ref GlyphCache.
+* @param [in] path The path the face was loaded from
+* @param [in] distanceField Whether the glyphs are distance fields
+* @return The name
+*/
+static std::string cacheFace(const std::string &path, bool distanceField);
+
+std::string cacheFace(const std::string &path, bool distanceField) {
+    // Distance fields are rendered at sdf::SIZE, so they'd
+    // collide with glyphs rendered normally at that size
+    return distanceField ? path + "#sdf" : path;
+}
+
+/**
+* A glyph placed on the baseline, ready to be drawn into a cell.
+* @see composeGlyphs()
+*/
+struct glyphPart {
+    /// Pixel x of the left of the bitmap, from the left of the cell
+    int left;
+    /// Pixel distance from the baseline to the top of the bitmap
+    int top;
+    /// Width of the bitmap
+    int width;
+    /// Rows in the bitmap
+    int rows;
+    /// The bitmap, `width` bytes per row, top row first
+    std::vector<unsigned char> data;
+};
+
+/**
+* Copies the glyph out of a glyph slot, since each glyph
+* loaded overwrites the last.
+* @param [in] slot The slot, with the glyph rendered
+* @param [in] x Pixel x of the glyph's origin, from the left of the cell
+* @param [in] y Pixel distance that the glyph is raised by
+* @param [out] part The placed glyph
+*/
+static void copyGlyph(FT_GlyphSlot slot, int x, int y, glyphPart &part);
+
+/**
+* Draws glyphs into a bitmap. Overlapping glyphs are merged.
+* @param [in] parts The glyphs
+* @param [in] ascender Pixel distance from the top of the bitmap to the baseline
+* @param [in] width Width of the bitmap
+* @param [in] height Height of the bitmap
+* @param [in] xShift Added to the x of every glyph
+* @return The bitmap
+*/
+static etm::GlyphCache::bitmap_t composeGlyphs(const std::vector<glyphPart> &parts, int ascender, int width, int height, int xShift);
+
+/**
+* Whether a glyph is a shaped segment rather than a codepoint or cluster.
+* @param [in] c The glyph
+* @return `true` if it's a segment id
+*/
+static bool isSegment(etm::Font::char_t c);
+
+void copyGlyph(FT_GlyphSlot slot, int x, int y, glyphPart &part) {
+    const FT_Bitmap &src = slot->bitmap;
+    part.left = x + slot->bitmap_left;
+    part.top = y + slot->bitmap_top;
+    part.width = src.width;
+    part.rows = src.rows;
+    part.data.resize(part.width * part.rows);
+    for (int row = 0; row < part.rows; row++) {
+        const unsigned char *line = src.buffer + row * src.pitch;
+        std::copy(line, line + part.width, part.data.begin() + row * part.width);
+    }
+}
+
+etm::GlyphCache::bitmap_t composeGlyphs(const std::vector<glyphPart> &parts, int ascender, int width, int height, int xShift) {
+    // Only one channel is needed to convey font data
+    constexpr int channels = 1;
+
+    std::shared_ptr<etm::GlyphCache::bitmap> result = std::make_shared<etm::GlyphCache::bitmap>();
+    result->width = width;
+    result->height = height;
+    std::vector<unsigned char> &data = result->data;
+    data.resize(height * width * channels);
+    for (const glyphPart &p : parts) {
+        // Move down the codepoint down by the difference between it's and the max ascender
+        const int yShift = ascender - p.top;
+        for (int sy = 0; sy < p.rows; sy++) {
+            for (int sx = 0; sx < p.width; sx++) {
+                const unsigned char value = p.data[sx + sy * p.width];
+                const int dx = xShift + p.left + sx;
+                // Flips the texture because OpenGL operates
+                // with 0,0 at the lower left corner.
+                const int dy = height - 1 - (yShift + sy);
+                // Parts of oversized glyphs that don't fit are dropped
+                if (value && dx >= 0 && dx < width && dy >= 0 && dy < height) {
+                    const int insIndex = (dx + dy * width) * channels;
+                    for (int c = 0; c < channels; c++) {
+                        // Overlapping glyphs (ex. accents) are merged
+                        data[insIndex + c] = std::max(data[insIndex + c], value);
+                    }
+                }
+            }
+        }
+    }
+    return result;
+}
+
+/**
+* Gives a cluster or segment an id, which is a hash of what it's made of.
+* @param [in,out] table The ids given out so far, and what they're for
+* @param [in] bits The top bits of the id
+* @param [in] parts What it's made of
+* @param [in] count The number of parts
+* @param [out] id The id
+* @return `false` if the id is already taken by something else
+*/
+static bool makeId(std::unordered_map<etm::Font::char_t, std::vector<etm::Font::char_t>> &table, etm::Font::char_t bits, const etm::Font::char_t *parts, std::size_t count, etm::Font::char_t &id);
+
+bool isSegment(etm::Font::char_t c) {
+    return (c & SEGMENT_BITS) == SEGMENT_BITS;
+}
+
+bool makeId(std::unordered_map<etm::Font::char_t, std::vector<etm::Font::char_t>> &table, etm::Font::char_t bits, const etm::Font::char_t *parts, std::size_t count, etm::Font::char_t &id) {
+    // FNV-1a
+    std::uint32_t hash = 2166136261u;
+    for (std::size_t i = 0; i < count; i++) {
+        hash = (hash ^ parts[i]) * 16777619u;
+    }
+    // The top bits keep clusters, segments and codepoints apart,
+    // and the bottom one keeps it clear of anything that uses ~0 as a marker
+    id = bits | (hash & 0x3FFFFFFEu);
+    auto loc = table.find(id);
+    if (loc == table.end()) {
+        table.emplace(id, std::vector<etm::Font::char_t>(parts, parts + count));
+        return true;
+    }
+    return loc->second.size() == count && std::equal(parts, parts + count, loc->second.begin());
+}
+
+/**
+* Rasterizes glyphs in the background.
+* Freetype faces can't be shared between threads,
+* so every worker opens its own (along with a library
+* to go with it) the first time it's needed.
+*/
+struct etm::Font::rasterizer {
+    /**
+    * A finished glyph.
+    */
+    struct result {
+        /// The pixel size it was rendered at
+        unsigned int size;
+        /// Whether it's a distance field
+        bool distanceField;
+        /// The codepoint, cluster id or segment id
+        char_t codepoint;
+        /// The bitmap, `nullptr` if it failed
+        GlyphCache::bitmap_t bitmap;
+        /// Why it failed
+        FT_Error error;
+    };
+    /**
+    * Resources owned by a single worker.
+    */
+    struct worker {
+        /// The worker's Freetype library
+        FT_Library lib = nullptr;
+        /// The worker's copy of the face
+        FT_Face face = nullptr;
+        /// The size that @ref face is set to
+        unsigned int size = 0;
+        /// Width of each char at @ref size
+        int charWidth = 0;
+        /// Height of each char at @ref size
+        int charHeight = 0;
+    };
+
+    /// Path to the face
+    std::string path;
+    /// Per-worker resources, indexed by the worker index
+    std::vector<worker> workers;
+    /// Guards @ref done
+    std::mutex lock;
+    /// Finished glyphs that haven't been uploaded yet
+    std::vector<result> done;
+    /// Incremented every time a glyph finishes
+    std::atomic<unsigned int> revision;
+    /// Destroyed first, so that no job outlives the rest
+    std::unique_ptr<ThreadPool> pool;
+
+    /**
+    * Starts the workers.
+    * @param [in] path Path to the face
+    * @param [in] count Number of workers
+    */
+    rasterizer(const std::string &path, std::size_t count);
+    /**
+    * Stops the workers and frees their faces.
+    */
+    ~rasterizer();
+    /**
+    * Renders a glyph, from a worker thread.
+    * @param [in] index The worker index
+    * @param [in] size The pixel size
+    * @param [in] distanceField Whether to render a distance field
+    * @param [in] c The codepoint, cluster id or segment id
+    * @param [in] parts What `c` is made from
+    */
+    void run(std::size_t index, unsigned int size, bool distanceField, char_t c, const std::vector<char_t> &parts);
+};
+
+etm::Font::rasterizer::rasterizer(const std::string &path, std::size_t count):
+    path(path), workers(count), revision(0), pool(std::make_unique<ThreadPool>(count)) {
+}
+
+etm::Font::rasterizer::~rasterizer() {
+    pool.reset();
+    for (worker &w : workers) {
+        if (w.face != nullptr) {
+            FT_Done_Face(w.face);
+        }
+        if (w.lib != nullptr) {
+            FT_Done_FreeType(w.lib);
+        }
+    }
+}
+
+void etm::Font::rasterizer::run(std::size_t index, unsigned int size, bool distanceField, char_t c, const std::vector<char_t> &parts) {
+    worker &w = workers[index];
+    result r{size, distanceField, c, nullptr, FT_Err_Ok};
+
+    // The render thread already checked the GlyphCache
+    if (w.lib == nullptr) {
+        r.error = FT_Init_FreeType(&w.lib);
+        if (r.error == FT_Err_Ok) {
+            r.error = FT_New_Face(w.lib, path.c_str(), 0, &w.face);
+        }
+        if (r.error != FT_Err_Ok) {
+            w.face = nullptr;
+        }
+    }
+    if (w.face != nullptr) {
+        if (w.size != size) {
+            FT_Set_Pixel_Sizes(w.face, 0, size);
+            getCharSize(w.face, w.charWidth, w.charHeight);
+            w.size = size;
+        }
+        r.bitmap = renderGlyph(w.face, w.charWidth, w.charHeight, c, parts, r.error);
+        if (r.bitmap != nullptr) {
+            if (distanceField) {
+                r.bitmap = sdf::generate(*r.bitmap);
+            }
+            GlyphCache::key key{cacheFace(path, distanceField), size, c};
+            if (parts.size() > 1 || isSegment(c)) {
+                key.cluster = parts;
+            }
+            GlyphCache::get().insert(key, r.bitmap);
+        }
+    } else if (r.error == FT_Err_Ok) {
+        // Failed on a previous job
+        r.error = FT_Err_Invalid_Handle;
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        done.push_back(std::move(r));
+    }
+    revision++;
+}
+
+etm::Font::Font(const std::string &path):
+    res(nullptr), path(path), size(0), distanceField(false),
+    async(true), placeholderValid(false), shaping(false) {
     FT_Error error = FT_New_Face(fontLib.get(), path.c_str(), 0, &face);
     if (error == FT_Err_Ok) {
         setSize(18); // Default size
@@ -39,7 +347,19 @@ void etm::Font::steal(Font &other) {
     face = other.face;
     charWidth = other.charWidth;
     charHeight = other.charHeight;
+    path = std::move(other.path);
+    size = other.size;
+    distanceField = other.distanceField;
     textCache = std::move(other.textCache);
+    async = other.async;
+    pending = std::move(other.pending);
+    placeholder = std::move(other.placeholder);
+    placeholderValid = other.placeholderValid;
+    workers = std::move(other.workers);
+    clusters = std::move(other.clusters);
+    segments = std::move(other.segments);
+    shaping = other.shaping;
+    shapes = std::move(other.shapes);
 
     other.face = nullptr;
 }
@@ -57,70 +377,117 @@ void etm::Font::setResMan(Resources *res) {
 }
 
 void etm::Font::calcCharSize() {
-    charWidth = std::ceil(face->size->metrics.max_advance / 64.0f);
-    // https://www.freetype.org/freetype2/docs/reference/ft2-base_interface.html#ft_facerec
-    // "If you want the global glyph height, use ascender - descender"
-    charHeight = std::ceil((face->size->metrics.ascender - face->size->metrics.descender) / 64.0f);   
+    getCharSize(face, charWidth, charHeight);
 }
 
 void etm::Font::setSize(unsigned int size) {
+    this->size = size;
     FT_Set_Pixel_Sizes(face, 0, size);
     calcCharSize();
-    clearCache();
+    if (distanceField) {
+        // Distance fields don't depend on the size,
+        // only the placeholder does
+        placeholderValid = false;
+    } else {
+        // The bitmaps for the old size stay in the GlyphCache
+        clearCache();
+    }
 }
-etm::Texture etm::Font::makeCharTexture(char_t c) {
-    // Only one channel is needed to convey font data
-    constexpr int channels = 1;
-
-    Texture result;
-
-    FT_Error error = FT_Load_Char(face, c, FT_LOAD_RENDER);
-    if (error == FT_Err_Ok) {
+unsigned int etm::Font::rasterSize() const {
+    return distanceField ? sdf::SIZE : size;
+}
+etm::GlyphCache::key etm::Font::cacheKey(char_t c) const {
+    GlyphCache::key key{cacheFace(path, distanceField), rasterSize(), c};
+    if (c & CLUSTER_BITS) {
+        key.cluster = getParts(c);
+    }
+    return key;
+}
+std::vector<etm::Font::char_t> etm::Font::getParts(char_t c) const {
+    const clusters_t &table = isSegment(c) ? segments : clusters;
+    clusters_t::const_iterator loc = table.find(c);
+    return loc != table.end() ? loc->second : std::vector<char_t>(1, c);
+}
+etm::GlyphCache::bitmap_t etm::Font::renderNow(char_t c, FT_Error &error) {
+    const std::vector<char_t> parts = getParts(c);
+    if (!distanceField) {
+        return renderGlyph(face, charWidth, charHeight, c, parts, error);
+    }
+    // `face` stays at the display size, for the metrics
+    FT_Set_Pixel_Sizes(face, 0, sdf::SIZE);
+    int width, height;
+    getCharSize(face, width, height);
+    GlyphCache::bitmap_t bitmap = renderGlyph(face, width, height, c, parts, error);
+    FT_Set_Pixel_Sizes(face, 0, size);
+    return bitmap != nullptr ? sdf::generate(*bitmap) : nullptr;
+}
+etm::GlyphCache::bitmap_t etm::Font::renderChar(FT_Face face, int charWidth, int charHeight, char_t c, FT_Error &error) {
+    return renderCluster(face, charWidth, charHeight, &c, 1, error);
+}
+etm::GlyphCache::bitmap_t etm::Font::renderCluster(FT_Face face, int charWidth, int charHeight, const char_t *codepoints, std::size_t count, FT_Error &error) {
+    // Wide chars get two cells' worth of room
+    charWidth *= wide::columns(codepoints[0]);
 
-        std::vector<unsigned char> data(charHeight * charWidth * channels);
-        // Move down the codepoint down by the difference between it's and the max ascender
-        const int yShift = face->size->metrics.ascender / 64 - face->glyph->bitmap_top;
-        // Center the codepoint in the texture
-        const int xShift = (charWidth - face->glyph->bitmap.width) / 2;
-        for (unsigned int sy = 0; sy < face->glyph->bitmap.rows; sy++) {
-            for (unsigned int sx = 0; sx < face->glyph->bitmap.width; sx++) {
-                // The source index
-                const int srcIndex = static_cast<int>(sx) + static_cast<int>(sy) * face->glyph->bitmap.width;
-                // Only render into `render`'s bitmap if it's got content.
-                // Note that the Freetype bitmaps only have one channel,
-                // hence why there's only one check.
-                if (face->glyph->bitmap.buffer[srcIndex]) {
-                    // The insertion index.
-                    // Flipts the texture because OpenGL operates
-                    // with 0,0 at the lower left corner.
-                    // 
-                    // (
-                    //     (xShift + sx) // Add pixel x offset to the pen x offset 
-                    //     + // Add to offset from vertical coords
-                    //     (
-                    //         charHeight // Total line height
-                    //         - // Remove 1 to zero-index it
-                    //         1
-                    //         - // Remove the y coords to get the vertically fliped index
-                    //         (yShift + sy) // Add pixel y coord to the pen y coord
-                    //     )
-                    //     * // Convert from pixel coords to bitmap offset
-                    //     charWidth // Offset per y
-                    // )
-                    // * // Multply by desired channels
-                    // channels // Number of channels
-                    // 
-                    const int insIndex = ((xShift + static_cast<int>(sx)) + (charHeight - 1 - (yShift + static_cast<int>(sy))) * charWidth) * channels;
-                    for (int c = 0; c < channels; c++) {
-                        data.at(insIndex + c) = face->glyph->bitmap.buffer[srcIndex];
-                    }
-                }
-            }
+    std::vector<glyphPart> parts(count);
+    int pen = 0;
+    // Where the last glyph that wasn't a mark started
+    int base = 0;
+    int inkLeft = 0;
+    int inkRight = 0;
+    for (std::size_t i = 0; i < count; i++) {
+        error = FT_Load_Char(face, codepoints[i], FT_LOAD_RENDER);
+        if (error != FT_Err_Ok) {
+            return nullptr;
         }
+        int left;
+        if (i > 0 && grapheme::getProperty(codepoints[i]) == grapheme::EXTEND) {
+            // Marks that don't advance are already drawn relative to
+            // the end of their base. Monospace fonts tend to give
+            // them a whole cell though, to be struck over it.
+            left = face->glyph->advance.x == 0 ? pen : base;
+        } else {
+            base = pen;
+            left = pen;
+            pen += face->glyph->advance.x / 64;
+        }
+        glyphPart &p = parts[i];
+        copyGlyph(face->glyph, left, 0, p);
+        if (i == 0 || p.left < inkLeft) {
+            inkLeft = p.left;
+        }
+        if (i == 0 || p.left + p.width > inkRight) {
+            inkRight = p.left + p.width;
+        }
+    }
 
-        result.setData(GL_RED, charWidth, charHeight, data.data());
-
-    } else if (res != nullptr) {
+    // Center the cluster in the texture
+    const int xShift = (charWidth - (inkRight - inkLeft)) / 2 - inkLeft;
+    return composeGlyphs(parts, face->size->metrics.ascender / 64, charWidth, charHeight, xShift);
+}
+etm::GlyphCache::bitmap_t etm::Font::renderSegment(FT_Face face, int charWidth, int charHeight, const std::vector<char_t> &parts, FT_Error &error) {
+    std::vector<glyphPart> glyphs((parts.size() - 1) / 3);
+    for (std::size_t i = 0; i < glyphs.size(); i++) {
+        const char_t *glyph = &parts[1 + i * 3];
+        error = FT_Load_Glyph(face, glyph[0], FT_LOAD_RENDER);
+        if (error != FT_Err_Ok) {
+            return nullptr;
+        }
+        // Positions are relative to the cell width, so they work at any size
+        const int x = static_cast<int>(glyph[1]) * charWidth / SEGMENT_UNITS;
+        const int y = static_cast<int>(glyph[2]) * charWidth / SEGMENT_UNITS;
+        copyGlyph(face->glyph, x, y, glyphs[i]);
+    }
+    // Already laid out on the cells, so no centering
+    return composeGlyphs(glyphs, face->size->metrics.ascender / 64, charWidth * parts[0], charHeight, 0);
+}
+etm::GlyphCache::bitmap_t etm::Font::renderGlyph(FT_Face face, int charWidth, int charHeight, char_t c, const std::vector<char_t> &parts, FT_Error &error) {
+    if (isSegment(c)) {
+        return renderSegment(face, charWidth, charHeight, parts, error);
+    }
+    return renderCluster(face, charWidth, charHeight, parts.data(), parts.size(), error);
+}
+void etm::Font::reportError(char_t c, FT_Error error) {
+    if (res != nullptr) {
         res->postError(
             "Font::renderChar(char)",
             std::string("Failed to load char '") + std::to_string(c) + "'",
@@ -131,23 +498,139 @@ etm::Texture etm::Font::makeCharTexture(char_t c) {
         std::cerr << "ETERMAL ERROR: etm::Font::renderChar(char): Not only is the resources manager nullptr, but codepoint "
         << c << " failed to render with freetype error code " << error << '\n';
     }
-
+}
+etm::Texture etm::Font::makeCharTexture(const GlyphCache::bitmap &bitmap) {
+    // Distance fields are meant to be interpolated
+    Texture result = distanceField ?
+        Texture({GL_CLAMP_TO_BORDER, GL_CLAMP_TO_BORDER, GL_LINEAR, GL_LINEAR}) :
+        Texture();
+    result.setData(GL_RED, bitmap.width, bitmap.height, bitmap.data.data());
     return result;
 }
 
+void etm::Font::bindPlaceholder() {
+    if (!placeholderValid) {
+        std::vector<unsigned char> data(charWidth * charHeight);
+        placeholder.setData(GL_RED, charWidth, charHeight, data.data());
+        placeholderValid = true;
+    }
+    placeholder.bind();
+}
+
+void etm::Font::queueChar(char_t c) {
+    if (!workers) {
+        const unsigned int cores = std::thread::hardware_concurrency();
+        // Leave a core for the render thread
+        workers = std::make_unique<rasterizer>(path, std::min(std::max(cores, 2u) - 1, 4u));
+    }
+    pending.insert(c);
+    rasterizer *target = workers.get();
+    const unsigned int targetSize = rasterSize();
+    const bool targetField = distanceField;
+    std::vector<char_t> parts = getParts(c);
+    workers->pool->submit([target, targetSize, targetField, c, parts](std::size_t worker) {
+        target->run(worker, targetSize, targetField, c, parts);
+    });
+}
+
 void etm::Font::bindChar(char_t c) {
     // Test cache
     textCache_t::iterator loc = textCache.find(c);
     if (loc != textCache.end()) {
         loc->second.bind();
-    } else {
-        textCache[c] = makeCharTexture(c);
-        textCache[c].bind();
+        return;
+    }
+    if (pending.count(c)) {
+        bindPlaceholder();
+        return;
+    }
+
+    const GlyphCache::key key = cacheKey(c);
+    GlyphCache::bitmap_t bitmap = GlyphCache::get().find(key);
+    if (bitmap == nullptr) {
+        if (async) {
+            queueChar(c);
+            bindPlaceholder();
+            return;
+        }
+        FT_Error error;
+        bitmap = renderNow(c, error);
+        if (bitmap == nullptr) {
+            reportError(c, error);
+            // Don't try again
+            textCache[c] = Texture();
+            textCache[c].bind();
+            return;
+        }
+        GlyphCache::get().insert(key, bitmap);
+    }
+    textCache[c] = makeCharTexture(*bitmap);
+    textCache[c].bind();
+}
+
+void etm::Font::update() {
+    if (!workers) {
+        return;
+    }
+    std::vector<rasterizer::result> done;
+    {
+        std::lock_guard<std::mutex> guard(workers->lock);
+        done.swap(workers->done);
+    }
+    // Uploaded all at once, at the start of the frame
+    for (rasterizer::result &r : done) {
+        // Anything for an old size is already in
+        // the GlyphCache, should it be needed again
+        if (r.size != rasterSize() || r.distanceField != distanceField || !pending.erase(r.codepoint)) {
+            continue;
+        }
+        if (r.bitmap != nullptr) {
+            textCache[r.codepoint] = makeCharTexture(*r.bitmap);
+        } else {
+            reportError(r.codepoint, r.error);
+            textCache[r.codepoint] = Texture();
+        }
+    }
+}
+
+unsigned int etm::Font::getRevision() {
+    return workers ? workers->revision.load() : 0;
+}
+
+void etm::Font::setAsync(bool value) {
+    async = value;
+}
+
+void etm::Font::prewarm(char_t first, char_t last) {
+    for (char_t c = first; c <= last && c >= first; c++) {
+        if (!textCache.count(c) && !pending.count(c)) {
+            GlyphCache::bitmap_t bitmap = GlyphCache::get().find(cacheKey(c));
+            if (bitmap != nullptr) {
+                textCache[c] = makeCharTexture(*bitmap);
+            } else {
+                queueChar(c);
+            }
+        }
+    }
+}
+
+void etm::Font::setDistanceField(bool value) {
+    if (distanceField != value) {
+        distanceField = value;
+        clearCache();
     }
 }
+bool etm::Font::isDistanceField() {
+    return distanceField;
+}
 
 void etm::Font::clearCache() {
     textCache.clear();
+    pending.clear();
+    placeholderValid = false;
+    if (workers) {
+        workers->pool->cancel();
+    }
 }
 
 int etm::Font::getCharWidth() {
@@ -156,3 +639,207 @@ int etm::Font::getCharWidth() {
 int etm::Font::getCharHeight() {
     return charHeight;
 }
+
+bool etm::Font::hasChar(char_t c) {
+    return FT_Get_Char_Index(face, c) != 0;
+}
+
+etm::Font::char_t etm::Font::getClusterGlyph(const char_t *codepoints, std::size_t count) {
+    char_t id;
+    if (count == 1 || !makeId(clusters, CLUSTER_BITS, codepoints, count, id)) {
+        return codepoints[0];
+    }
+    return id;
+}
+
+void etm::Font::setShaping(bool value) {
+    shaping = value;
+}
+bool etm::Font::canShape() {
+#ifdef ETERMAL_HARFBUZZ
+    return true;
+#else
+    return false;
+#endif
+}
+bool etm::Font::isShaping() {
+    return shaping && canShape();
+}
+etm::EtmFont::shaped_t etm::Font::shape(const char_t *codepoints, std::size_t count) {
+    shaped_t run;
+    if (!isShaping() || count < 2) {
+        return run;
+    }
+    if (!shapes.find(path, size, codepoints, count, run)) {
+        run = shapeNow(codepoints, count);
+        shapes.insert(ShapeCache::key{path, size, std::vector<char_t>(codepoints, codepoints + count)}, run);
+    }
+    return run;
+}
+etm::ShapeCache::stats etm::Font::getShapeStats() const {
+    return shapes.getStats();
+}
+
+#ifdef ETERMAL_HARFBUZZ
+
+etm::EtmFont::shaped_t etm::Font::shapeNow(const char_t *codepoints, std::size_t count) {
+    hb_font_t *font = hb_ft_font_create_referenced(face);
+    hb_buffer_t *buffer = hb_buffer_create();
+    hb_buffer_add_utf32(buffer, reinterpret_cast<const std::uint32_t*>(codepoints), static_cast<int>(count), 0, static_cast<int>(count));
+    hb_buffer_guess_segment_properties(buffer);
+    // Cells go left to right, whatever the script
+    hb_buffer_set_direction(buffer, HB_DIRECTION_LTR);
+    hb_shape(font, buffer, nullptr, 0);
+
+    unsigned int glyphCount;
+    const hb_glyph_info_t *info = hb_buffer_get_glyph_infos(buffer, &glyphCount);
+    const hb_glyph_position_t *position = hb_buffer_get_glyph_positions(buffer, &glyphCount);
+
+    // A glyph is plain if it's exactly what the codepoint
+    // would've been drawn as without shaping
+    auto isPlain = [&](unsigned int g) -> bool {
+        const std::size_t c = info[g].cluster;
+        const std::size_t next = g + 1 < glyphCount ? info[g + 1].cluster : count;
+        return (g == 0 || info[g - 1].cluster != c) && next == c + 1 &&
+            info[g].codepoint == FT_Get_Char_Index(face, codepoints[c]) &&
+            position[g].x_offset == 0 && position[g].y_offset == 0;
+    };
+    // 26.6 pixels to segment units
+    const long cellUnits = static_cast<long>(charWidth) * 64;
+
+    std::shared_ptr<std::vector<shapedGlyph>> result = std::make_shared<std::vector<shapedGlyph>>();
+    bool shaped = false;
+    std::vector<char_t> parts;
+    long pen = 0;
+    for (unsigned int g = 0; g < glyphCount;) {
+        if (isPlain(g)) {
+            result->push_back(shapedGlyph{codepoints[info[g].cluster], 1});
+            pen += position[g].x_advance;
+            g++;
+            continue;
+        }
+        // Everything up to the next plain glyph is drawn as one segment
+        const std::size_t start = info[g].cluster;
+        const long origin = pen;
+        parts.assign(1, 0);
+        for (; g < glyphCount && !isPlain(g); g++) {
+            parts.push_back(info[g].codepoint);
+            parts.push_back(static_cast<char_t>((pen - origin + position[g].x_offset) * SEGMENT_UNITS / cellUnits));
+            parts.push_back(static_cast<char_t>(position[g].y_offset * SEGMENT_UNITS / cellUnits));
+            pen += position[g].x_advance;
+        }
+        const std::size_t end = g < glyphCount ? info[g].cluster : count;
+        parts[0] = end - start;
+        char_t id;
+        if (end > start && makeId(segments, SEGMENT_BITS, parts.data(), parts.size(), id)) {
+            result->push_back(shapedGlyph{id, static_cast<unsigned int>(end - start)});
+            shaped = true;
+        } else {
+            for (std::size_t c = start; c < end; c++) {
+                result->push_back(shapedGlyph{codepoints[c], 1});
+            }
+        }
+    }
+
+    hb_buffer_destroy(buffer);
+    hb_font_destroy(font);
+    // Most runs come out the same as they went in
+    return shaped ? result : nullptr;
+}
+
+#else
+
+etm::EtmFont::shaped_t etm::Font::shapeNow(const char_t *codepoints, std::size_t count) {
+    return nullptr;
+}
+
+#endif
+
+void etm::Font::exportPack(const std::string &path, unsigned int size, char_t first, char_t last, GlyphPack &pack) {
+    FontLibrary lib;
+    FT_Face face;
+    FT_Error error = FT_New_Face(lib.get(), path.c_str(), 0, &face);
+    if (error != FT_Err_Ok) {
+        throw std::invalid_argument(
+            "etm::Font: Failed to load font @\"" + path +
+            "\" as new face (ft err code = " + std::to_string(error) +
+            ")");
+    }
+    FT_Set_Pixel_Sizes(face, 0, size);
+    int charWidth, charHeight;
+    getCharSize(face, charWidth, charHeight);
+
+    pack = GlyphPack(charWidth, charHeight);
+    // Codepoint 0 maps to glyph 0, the face's "missing glyph"
+    GlyphCache::bitmap_t bitmap = renderChar(face, charWidth, charHeight, 0, error);
+    if (bitmap) {
+        pack.setFallback(bitmap->data.data());
+    }
+    for (std::uint64_t c = first; c <= last; c++) {
+        // Every slot in a pack is one cell, which wide chars don't fit in
+        if (FT_Get_Char_Index(face, c) == 0 || wide::columns(c) > 1) {
+            continue;
+        }
+        bitmap = renderChar(face, charWidth, charHeight, c, error);
+        if (bitmap) {
+            pack.add(c, bitmap->data.data());
+        }
+    }
+
+    FT_Done_Face(face);
+}
+
+etm::Font::fidelity etm::Font::compareDistanceField(const std::string &path, unsigned int size, char_t first, char_t last) {
+    FontLibrary lib;
+    FT_Face face;
+    FT_Error error = FT_New_Face(lib.get(), path.c_str(), 0, &face);
+    if (error != FT_Err_Ok) {
+        throw std::invalid_argument(
+            "etm::Font: Failed to load font @\"" + path +
+            "\" as new face (ft err code = " + std::to_string(error) +
+            ")");
+    }
+    int nativeWidth, nativeHeight;
+    FT_Set_Pixel_Sizes(face, 0, size);
+    getCharSize(face, nativeWidth, nativeHeight);
+    int fieldWidth, fieldHeight;
+    FT_Set_Pixel_Sizes(face, 0, sdf::SIZE);
+    getCharSize(face, fieldWidth, fieldHeight);
+
+    fidelity result{0, 0, 0, 0};
+    double totalError = 0;
+    std::size_t totalPixels = 0;
+    std::vector<unsigned char> drawn;
+    for (std::uint64_t c = first; c <= last; c++) {
+        if (FT_Get_Char_Index(face, c) == 0) {
+            continue;
+        }
+        FT_Set_Pixel_Sizes(face, 0, size);
+        GlyphCache::bitmap_t native = renderChar(face, nativeWidth, nativeHeight, c, error);
+        FT_Set_Pixel_Sizes(face, 0, sdf::SIZE);
+        GlyphCache::bitmap_t field = renderChar(face, fieldWidth, fieldHeight, c, error);
+        if (native == nullptr || field == nullptr) {
+            continue;
+        }
+        sdf::resample(*sdf::generate(*field), native->width, native->height, drawn);
+
+        double glyphError = 0;
+        for (std::size_t i = 0; i < drawn.size(); i++) {
+            glyphError += std::abs(static_cast<int>(drawn[i]) - static_cast<int>(native->data[i])) / 255.0;
+        }
+        totalError += glyphError;
+        totalPixels += drawn.size();
+        glyphError /= drawn.size();
+        if (result.glyphs == 0 || glyphError > result.worstError) {
+            result.worstError = glyphError;
+            result.worstCodepoint = c;
+        }
+        result.glyphs++;
+    }
+    if (totalPixels > 0) {
+        result.meanError = totalError / totalPixels;
+    }
+
+    FT_Done_Face(face);
+    return result;
+}
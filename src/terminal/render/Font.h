@@ -3,17 +3,26 @@
 
 #include <string>
 #include <map>
+#include <unordered_set>
+#include <unordered_map>
+#include <vector>
+#include <memory>
+#include <cstddef>
 
 #include "EtmFont.h"
 #include "ftype.h"
 #include "Texture.h"
 #include "FontLibrary.h"
+#include "GlyphCache.h"
+#include "ShapeCache.h"
 
 namespace etm {
     // ../Resources
     class Resources;
     // FontLibrary
     class FontLibrary;
+    // GlyphPack
+    class GlyphPack;
 }
 
 namespace etm {
@@ -22,10 +31,25 @@ namespace etm {
     * Takes care of rendering codepoints and binding their
     * textures.
     * Works with a cache to save run time.
+    *
+    * By default, glyphs that aren't in the @ref GlyphCache are
+    * rasterized on a pool of worker threads, and a blank placeholder
+    * is drawn in their place until they're done. The finished glyphs
+    * are uploaded in one batch by @ref update(), which the @ref Terminal
+    * calls at the start of each frame it renders.
+    *
+    * In distance field mode (see @ref setDistanceField(bool value)),
+    * glyphs are rendered once at @ref sdf::SIZE as signed distance
+    * fields and scaled by the shader, so changing the size only
+    * changes the metrics.
     */
     class Font: public EtmFont {
         /// The text cache type
         typedef std::map<char_t, Texture> textCache_t;
+        /// The cluster ids type
+        typedef std::unordered_map<char_t, std::vector<char_t>> clusters_t;
+        /// Background rasterizer, defined in Font.cpp
+        struct rasterizer;
         FontLibrary fontLib;
 
         /// Handle to the @ref Resources object
@@ -38,13 +62,48 @@ namespace etm {
         int charWidth;
         /// Height of each char
         int charHeight;
+        /// The path the face was loaded from,
+        /// identifies it in the @ref GlyphCache
+        std::string path;
+        /// The current pixel size
+        unsigned int size;
+        /// Whether glyphs are rendered as distance fields
+        /// @see setDistanceField(bool value)
+        bool distanceField;
 
-        /// Cache of all the generated char textures
+        /// Cache of all the generated char textures.
+        /// The bitmaps they were made from are kept in the
+        /// process-wide @ref GlyphCache.
         /// @see makeCharTexture(char_t c)
         /// @see bindChar(char_t c)
         /// @see clearCache()
         textCache_t textCache;
 
+        /// Whether to rasterize glyphs in the background
+        /// @see setAsync(bool value)
+        bool async;
+        /// Glyphs that are being rasterized in the background
+        std::unordered_set<char_t> pending;
+        /// Blank texture bound in place of @ref pending glyphs
+        Texture placeholder;
+        /// Whether @ref placeholder is the current char size
+        bool placeholderValid;
+        /// The workers, started the first time they're needed
+        std::unique_ptr<rasterizer> workers;
+        /// The codepoints of every cluster handed out by
+        /// @ref getClusterGlyph(const char_t *codepoints, std::size_t count),
+        /// by id
+        clusters_t clusters;
+        /// Every segment made by @ref shapeNow(), by id.
+        /// A segment is the number of cells it covers, followed by
+        /// the glyph index, x and y of each of its glyphs.
+        clusters_t segments;
+        /// Whether to shape text
+        /// @see setShaping(bool value)
+        bool shaping;
+        /// The runs shaped so far
+        ShapeCache shapes;
+
         /**
         * Releases dynamic resources
         */
@@ -54,12 +113,119 @@ namespace etm {
         */
         void calcCharSize();
         /**
-        * Generate a texture for the given char.
-        * Really slow, hence the use of a cache
+        * Render the given char with Freetype.
+        * Really slow, hence the use of the @ref GlyphCache
+        * @note Thread safe, as long as `face` isn't used elseware
+        * @param [in] face The face to render with, with its size already set
+        * @param [in] charWidth The width of each char at that size, doubled for wide chars
+        * @param [in] charHeight The height of each char at that size
+        * @param [in] c The codepoint
+        * @param [out] error The Freetype error, if it failed
+        * @return The bitmap, or `nullptr` if it failed to render
+        */
+        static GlyphCache::bitmap_t renderChar(FT_Face face, int charWidth, int charHeight, char_t c, FT_Error &error);
+        /**
+        * Render a grapheme cluster with Freetype.
+        * The glyphs are laid out along the baseline by their advances,
+        * except for combining marks, which land on their base -
+        * then they're centered as a whole.
+        * There's no shaping, so ex. ZWJ sequences come out as their
+        * parts side by side, cut off at the edges of the cell.
+        * @note Thread safe, as long as `face` isn't used elseware
+        * @param [in] face The face to render with, with its size already set
+        * @param [in] charWidth The width of each char at that size
+        * @param [in] charHeight The height of each char at that size
+        * @param [in] codepoints The codepoints, the first being the base
+        * @param [in] count The number of codepoints, at least 1
+        * @param [out] error The Freetype error, if it failed
+        * @return The bitmap, or `nullptr` if it failed to render
+        */
+        static GlyphCache::bitmap_t renderCluster(FT_Face face, int charWidth, int charHeight, const char_t *codepoints, std::size_t count, FT_Error &error);
+        /**
+        * Render a shaped segment with Freetype, by glyph index.
+        * The glyphs are drawn where the shaper put them,
+        * across every cell the segment covers.
+        * @note Thread safe, as long as `face` isn't used elseware
+        * @param [in] face The face to render with, with its size already set
+        * @param [in] charWidth The width of each char at that size
+        * @param [in] charHeight The height of each char at that size
+        * @param [in] parts The segment (see @ref segments)
+        * @param [out] error The Freetype error, if it failed
+        * @return The bitmap, or `nullptr` if it failed to render
+        */
+        static GlyphCache::bitmap_t renderSegment(FT_Face face, int charWidth, int charHeight, const std::vector<char_t> &parts, FT_Error &error);
+        /**
+        * Render a codepoint, cluster or segment.
+        * @note Thread safe, as long as `face` isn't used elseware
+        * @param [in] face The face to render with, with its size already set
+        * @param [in] charWidth The width of each char at that size
+        * @param [in] charHeight The height of each char at that size
+        * @param [in] c The codepoint, cluster id or segment id
+        * @param [in] parts What `c` is made from (see @ref getParts(char_t c))
+        * @param [out] error The Freetype error, if it failed
+        * @return The bitmap, or `nullptr` if it failed to render
+        */
+        static GlyphCache::bitmap_t renderGlyph(FT_Face face, int charWidth, int charHeight, char_t c, const std::vector<char_t> &parts, FT_Error &error);
+        /**
+        * Get what a glyph is made from.
+        * @param [in] c The codepoint, cluster id or segment id
+        * @return The codepoints of the cluster, the segment,
+        * or just `c`
+        */
+        std::vector<char_t> getParts(char_t c) const;
+        /**
+        * Shape a run with HarfBuzz.
+        * Glyphs that are just their codepoint are left as they are,
+        * and anything else (ex. a ligature) is made into a segment,
+        * which covers the cells of the codepoints it came from.
+        * @param [in] codepoints The codepoints, one per cell
+        * @param [in] count The number of codepoints
+        * @return The glyphs, or `nullptr` if nothing changed
+        * (or the library was built without HarfBuzz)
+        */
+        shaped_t shapeNow(const char_t *codepoints, std::size_t count);
+        /**
+        * The pixel size that glyphs are actually rendered at.
+        * @return @ref size, or @ref sdf::SIZE for distance fields
+        */
+        unsigned int rasterSize() const;
+        /**
+        * Get the key a glyph is stored under in the @ref GlyphCache.
+        * @param [in] c The codepoint
+        * @return The key
+        */
+        GlyphCache::key cacheKey(char_t c) const;
+        /**
+        * Render the given char on the current thread,
+        * as a distance field if needed.
+        * @param [in] c The codepoint, cluster id or segment id
+        * @param [out] error The Freetype error, if it failed
+        * @return The bitmap, or `nullptr` if it failed to render
+        */
+        GlyphCache::bitmap_t renderNow(char_t c, FT_Error &error);
+        /**
+        * Report that a char failed to render.
+        * @param [in] c The codepoint
+        * @param [in] error The Freetype error
+        */
+        void reportError(char_t c, FT_Error error);
+        /**
+        * Upload a rendered char to a texture.
+        * @param [in] bitmap The char's bitmap
+        * @return The texture
         * @see textCache
         * @see bindChar(char_t c)
         */
-        Texture makeCharTexture(char_t c);
+        Texture makeCharTexture(const GlyphCache::bitmap &bitmap);
+        /**
+        * Send a char off to the @ref workers to be rendered.
+        * @param [in] c The codepoint
+        */
+        void queueChar(char_t c);
+        /**
+        * Bind the @ref placeholder, creating it if necessary.
+        */
+        void bindPlaceholder();
         /**
         * Move a font into this font.
         * @param [in,out] other Font to move
@@ -98,6 +264,151 @@ namespace etm {
         void clearCache() override;
         int getCharWidth() override;
         int getCharHeight() override;
+        /**
+        * Uploads all the glyphs that finished rendering
+        * in the background since the last call.
+        */
+        void update() override;
+        /**
+        * Gets the number of glyphs that have been rendered
+        * in the background so far.
+        * @return The revision
+        */
+        unsigned int getRevision() override;
+
+        /**
+        * Sets whether glyphs should be rendered in the background.
+        * If not, they're rendered right when they're bound, like
+        * before - which is good if every frame has to be complete
+        * (ex. when taking screenshots).
+        * Defaults to `true`.
+        * @param [in] value `true` to render in the background
+        */
+        void setAsync(bool value);
+        /**
+        * Starts rendering a range of codepoints in the background
+        * at the current size, so that they're ready by the time
+        * they're needed. Best called right after the font is loaded
+        * (and its size set), with a range like ASCII (`0x20`-`0x7E`)
+        * or Latin-1 (`0xA0`-`0xFF`).
+        * @param [in] first The first codepoint, inclusive
+        * @param [in] last The last codepoint, inclusive
+        */
+        void prewarm(char_t first, char_t last);
+
+        /**
+        * Sets whether glyphs should be rendered as signed distance fields.
+        * Distance fields are rendered once, at @ref sdf::SIZE, and can then
+        * be drawn at any size - so @ref setSize(unsigned int size) no longer
+        * has to throw away and re-render every glyph, which makes zooming
+        * cheap. The trade off is that small sizes come out a little softer
+        * than when rendered natively (see @ref compareDistanceField()).
+        * Defaults to `false`.
+        * @param [in] value `true` to use distance fields
+        */
+        void setDistanceField(bool value);
+        /**
+        * @return `true` if glyphs are rendered as distance fields
+        * @see setDistanceField(bool value)
+        */
+        bool isDistanceField() override;
+        /**
+        * Checks the face's character map.
+        * @param [in] c The codepoint
+        * @return `true` if the face has a glyph for `c`
+        */
+        bool hasChar(char_t c) override;
+        /**
+        * Gives the cluster an id, which is rendered like a codepoint
+        * (see @ref renderCluster()).
+        * Ids are a hash of the codepoints, with the top bit set so they
+        * can't be mistaken for one. In the unlikely case that two
+        * clusters hash the same, the second is drawn as its base.
+        * @param [in] codepoints The codepoints of the cluster
+        * @param [in] count The number of codepoints, at least 1
+        * @return The cluster's id, or the codepoint if `count` is 1
+        */
+        char_t getClusterGlyph(const char_t *codepoints, std::size_t count) override;
+
+        /**
+        * Sets whether runs of text should be shaped, so that
+        * ex. the ligatures of programming fonts are drawn.
+        * Only does anything if the library was built with HarfBuzz
+        * (see @ref canShape()).
+        * Shaped runs are cached (see @ref ShapeCache), so once the
+        * text on screen has been shaped, it costs a lookup per run.
+        * Defaults to `false`.
+        * @param [in] value `true` to shape text
+        */
+        void setShaping(bool value);
+        /**
+        * Whether the library was built with HarfBuzz,
+        * and so can shape text at all.
+        * @return `true` if it can shape
+        */
+        static bool canShape();
+        /**
+        * @return `true` if text is shaped
+        * @see setShaping(bool value)
+        */
+        bool isShaping() override;
+        /**
+        * Shapes a run, if shaping is on.
+        * @param [in] codepoints The codepoints, one per cell
+        * @param [in] count The number of codepoints
+        * @return The glyphs, or `nullptr` if each codepoint is drawn as is
+        */
+        shaped_t shape(const char_t *codepoints, std::size_t count) override;
+        /**
+        * Gets the usage counters of the shaped run cache.
+        * @return A copy of the counters
+        */
+        ShapeCache::stats getShapeStats() const;
+
+        /**
+        * How closely distance field glyphs match natively rendered ones.
+        * @see compareDistanceField()
+        */
+        struct fidelity {
+            /// Number of glyphs compared
+            unsigned int glyphs;
+            /// Mean absolute difference in coverage over
+            /// every pixel, 0-1
+            double meanError;
+            /// The mean error of the worst glyph, 0-1
+            double worstError;
+            /// The codepoint of the worst glyph
+            char_t worstCodepoint;
+        };
+        /**
+        * Compare distance field glyphs drawn at `size` to
+        * glyphs rendered natively at that size.
+        * Doesn't need an OpenGL context.
+        * @param [in] path The path to the font resource
+        * @param [in] size The pixel size
+        * @param [in] first The first codepoint, inclusive
+        * @param [in] last The last codepoint, inclusive
+        * @return The results
+        * @throw std::logic_error if failed to create freetype library
+        * @throw std::invalid_argument if failed to create font face from given `path`
+        */
+        static fidelity compareDistanceField(const std::string &path, unsigned int size, char_t first, char_t last);
+
+        /**
+        * Rasterize a range of codepoints into a glyph pack, which can
+        * then be saved and loaded much faster with @ref PackFont.
+        * Codepoints that the face doesn't have are left out, and
+        * render as the face's missing glyph instead.
+        * Doesn't need an OpenGL context.
+        * @param [in] path The path to the font resource
+        * @param [in] size The pixel size
+        * @param [in] first The first codepoint, inclusive
+        * @param [in] last The last codepoint, inclusive
+        * @param [out] pack The pack to fill
+        * @throw std::logic_error if failed to create freetype library
+        * @throw std::invalid_argument if failed to create font face from given `path`
+        */
+        static void exportPack(const std::string &path, unsigned int size, char_t first, char_t last, GlyphPack &pack);
     };
 }
 
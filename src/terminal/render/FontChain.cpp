@@ -0,0 +1,195 @@
+#include "FontChain.h"
+
+#include <stdexcept>
+#include <algorithm>
+
+/// Initial number of slots in the resolution table
+static constexpr std::size_t INITIAL_SLOTS = 256;
+
+/**
+* Hashes a codepoint (Fibonacci hashing).
+* Codepoints come in runs (ex. a script's block), which
+* this spreads out over the table.
+* @param [in] c The codepoint
+* @param [in] mask The size of the table minus one
+* @return The slot to start probing at
+*/
+static std::size_t hash(etm::EtmFont::char_t c, std::size_t mask);
+
+std::size_t hash(etm::EtmFont::char_t c, std::size_t mask) {
+    return static_cast<std::size_t>((c * 2654435769u) >> 8) & mask;
+}
+
+etm::FontChain::FontChain(const std::vector<font_t> &fonts):
+    resolved(INITIAL_SLOTS, slot{EMPTY, 0}),
+    resolvedCount(0)
+{
+    if (fonts.empty()) {
+        throw std::invalid_argument("etm::FontChain: Needs at least one font");
+    }
+    for (const font_t &font : fonts) {
+        add(font);
+    }
+}
+
+unsigned int etm::FontChain::resolve(char_t c) {
+    const std::size_t mask = resolved.size() - 1;
+    std::size_t i = hash(c, mask);
+    for (; resolved[i].codepoint != EMPTY; i = (i + 1) & mask) {
+        if (resolved[i].codepoint == c) {
+            return resolved[i].font;
+        }
+    }
+
+    // First time seeing this codepoint
+    unsigned int font = 0;
+    while (font < fonts.size() && !fonts[font]->hasChar(c)) {
+        font++;
+    }
+    remember(c, font);
+    return font;
+}
+
+void etm::FontChain::remember(char_t c, unsigned int font) {
+    // Keep the load factor under 1/2, so probes stay short
+    if ((resolvedCount + 1) * 2 > resolved.size()) {
+        grow();
+    }
+    const std::size_t mask = resolved.size() - 1;
+    std::size_t i = hash(c, mask);
+    while (resolved[i].codepoint != EMPTY && resolved[i].codepoint != c) {
+        i = (i + 1) & mask;
+    }
+    if (resolved[i].codepoint == EMPTY) {
+        resolved[i].codepoint = c;
+        resolvedCount++;
+    }
+    resolved[i].font = font;
+}
+
+unsigned int etm::FontChain::pick(char_t c) {
+    const unsigned int font = resolve(c);
+    return font < fonts.size() ? font : 0;
+}
+etm::EtmFont &etm::FontChain::getFont(char_t c) {
+    return *fonts[pick(c)];
+}
+
+void etm::FontChain::grow() {
+    std::vector<slot> old(resolved.size() * 2, slot{EMPTY, 0});
+    old.swap(resolved);
+    const std::size_t mask = resolved.size() - 1;
+    for (const slot &s : old) {
+        if (s.codepoint != EMPTY) {
+            std::size_t i = hash(s.codepoint, mask);
+            while (resolved[i].codepoint != EMPTY) {
+                i = (i + 1) & mask;
+            }
+            resolved[i] = s;
+        }
+    }
+}
+
+void etm::FontChain::add(const font_t &font) {
+    if (font == nullptr) {
+        throw std::invalid_argument("etm::FontChain: Font is nullptr");
+    }
+    fonts.push_back(font);
+    std::fill(resolved.begin(), resolved.end(), slot{EMPTY, 0});
+    resolvedCount = 0;
+}
+const std::vector<etm::FontChain::font_t> &etm::FontChain::getFonts() const {
+    return fonts;
+}
+std::size_t etm::FontChain::getResolvedCount() const {
+    return resolvedCount;
+}
+
+void etm::FontChain::setResMan(Resources *res) {
+    for (font_t &font : fonts) {
+        font->setResMan(res);
+    }
+}
+void etm::FontChain::setSize(unsigned int size) {
+    for (font_t &font : fonts) {
+        font->setSize(size);
+    }
+}
+void etm::FontChain::bindChar(char_t c) {
+    getFont(c).bindChar(c);
+}
+void etm::FontChain::clearCache() {
+    for (font_t &font : fonts) {
+        font->clearCache();
+    }
+}
+int etm::FontChain::getCharWidth() {
+    return fonts[0]->getCharWidth();
+}
+int etm::FontChain::getCharHeight() {
+    return fonts[0]->getCharHeight();
+}
+
+void etm::FontChain::update() {
+    for (font_t &font : fonts) {
+        font->update();
+    }
+}
+unsigned int etm::FontChain::getRevision() {
+    unsigned int revision = 0;
+    for (font_t &font : fonts) {
+        revision += font->getRevision();
+    }
+    return revision;
+}
+bool etm::FontChain::isAtlas() {
+    return false;
+}
+void etm::FontChain::getGlyphRegion(char_t c, float *region) {
+    getFont(c).getGlyphRegion(c, region);
+}
+bool etm::FontChain::isDistanceField() {
+    return fonts[0]->isDistanceField();
+}
+bool etm::FontChain::hasChar(char_t c) {
+    return resolve(c) < fonts.size();
+}
+etm::FontChain::char_t etm::FontChain::getClusterGlyph(const char_t *codepoints, std::size_t count) {
+    const unsigned int font = pick(codepoints[0]);
+    const char_t glyph = fonts[font]->getClusterGlyph(codepoints, count);
+    if (glyph != codepoints[0]) {
+        // Ids mean nothing to the other fonts, so
+        // it has to go back to the one that made it
+        remember(glyph, font);
+    }
+    return glyph;
+}
+bool etm::FontChain::isShaping() {
+    for (font_t &font : fonts) {
+        if (font->isShaping()) {
+            return true;
+        }
+    }
+    return false;
+}
+etm::FontChain::shaped_t etm::FontChain::shape(const char_t *codepoints, std::size_t count) {
+    // Runs that are split between fonts aren't shaped,
+    // a ligature can't be drawn by two fonts anyway
+    const unsigned int font = pick(codepoints[0]);
+    for (std::size_t i = 1; i < count; i++) {
+        if (pick(codepoints[i]) != font) {
+            return nullptr;
+        }
+    }
+    shaped_t run = fonts[font]->shape(codepoints, count);
+    if (run != nullptr) {
+        std::size_t cell = 0;
+        for (const shapedGlyph &g : *run) {
+            if (g.glyph != codepoints[cell]) {
+                remember(g.glyph, font);
+            }
+            cell += g.cells;
+        }
+    }
+    return run;
+}
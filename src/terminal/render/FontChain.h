@@ -0,0 +1,195 @@
+#ifndef ETERMAL_FONTCHAIN_H_INCLUDED
+#define ETERMAL_FONTCHAIN_H_INCLUDED
+
+#include <vector>
+#include <memory>
+#include <cstddef>
+
+#include "EtmFont.h"
+
+namespace etm {
+
+    /**
+    * An ordered list of fonts that are treated as one.
+    * Each codepoint is drawn with the first font in the chain
+    * that has a glyph for it (see @ref EtmFont::hasChar(char_t c)),
+    * so ex. a CJK or emoji font can fill in for what the main
+    * font is missing. If none of them have it, the first font
+    * draws it (as its missing glyph).
+    * Which font draws which codepoint is only worked out once,
+    * then remembered in a flat hash table - so drawing mixed
+    * script text doesn't go back to Freetype every frame.
+    * The table belongs to the chain, so terminals that share
+    * the chain (the same `std::shared_ptr`) share it too.
+    * The cell size comes from the first font; set the others
+    * up to match, as their glyphs are stretched to fit.
+    * @see EtmFont
+    */
+    class FontChain: public EtmFont {
+    public:
+        /// Font type
+        typedef std::shared_ptr<EtmFont> font_t;
+    private:
+        /// A slot in the @ref resolved table
+        struct slot {
+            /// The codepoint, or @ref EMPTY
+            char_t codepoint;
+            /// Index of the font in @ref fonts
+            unsigned int font;
+        };
+        /// Marks an unused @ref slot.
+        /// Not a valid codepoint, so it can't clash.
+        static constexpr char_t EMPTY = ~static_cast<char_t>(0);
+
+        /// The fonts, in order of preference
+        std::vector<font_t> fonts;
+        /// Open addressed (linear probing) table of the font
+        /// each codepoint resolved to.
+        /// The size is always a power of two.
+        std::vector<slot> resolved;
+        /// Number of used slots in @ref resolved
+        std::size_t resolvedCount;
+
+        /**
+        * Find the first font that has a codepoint, working it out
+        * and remembering it if it hasn't been already.
+        * @param [in] c The codepoint
+        * @return Index of the font in @ref fonts, or the size
+        * of @ref fonts if none of them have it
+        */
+        unsigned int resolve(char_t c);
+        /**
+        * Get the index of the font that draws a codepoint.
+        * @param [in] c The codepoint
+        * @return Index of the first font that has it,
+        * otherwise zero (the first font)
+        */
+        unsigned int pick(char_t c);
+        /**
+        * Get the font that draws a codepoint.
+        * @param [in] c The codepoint
+        * @return The first font that has it,
+        * otherwise the first font
+        */
+        EtmFont &getFont(char_t c);
+        /**
+        * Records which font a codepoint (or cluster id)
+        * resolved to, replacing what was there.
+        * @param [in] c The codepoint
+        * @param [in] font Index of the font in @ref fonts
+        */
+        void remember(char_t c, unsigned int font);
+        /**
+        * Doubles the size of @ref resolved, rehashing
+        * everything in it.
+        */
+        void grow();
+    public:
+        /**
+        * Construct a font chain.
+        * @param [in] fonts The fonts, in order of preference
+        * @throw std::invalid_argument if `fonts` is empty
+        * or has a `nullptr`
+        */
+        FontChain(const std::vector<font_t> &fonts);
+
+        /**
+        * Add a font to the end of the chain.
+        * Forgets which font every codepoint resolved to, as the
+        * new font might have some that the others didn't.
+        * @param [in] font The font
+        * @throw std::invalid_argument if `font` is `nullptr`
+        */
+        void add(const font_t &font);
+        /**
+        * Gets the fonts in the chain.
+        * @return The fonts, in order of preference
+        */
+        const std::vector<font_t> &getFonts() const;
+        /**
+        * Gets the number of codepoints that have been resolved,
+        * ex. for debugging.
+        * @return The number of codepoints
+        */
+        std::size_t getResolvedCount() const;
+
+        /**
+        * Passed on to every font in the chain.
+        * @param [in] res The resources manager
+        */
+        void setResMan(Resources *res) override;
+        /**
+        * Passed on to every font in the chain.
+        * @param [in] size The pixel size
+        */
+        void setSize(unsigned int size) override;
+        /**
+        * Binds the codepoint with the first font that has it.
+        * @param [in] c The codepoint
+        */
+        void bindChar(char_t c) override;
+        /**
+        * Clears the caches of every font in the chain.
+        * Which font each codepoint resolves to doesn't depend
+        * on the size, so that isn't forgotten.
+        */
+        void clearCache() override;
+        /**
+        * @return The char width of the first font
+        */
+        int getCharWidth() override;
+        /**
+        * @return The char height of the first font
+        */
+        int getCharHeight() override;
+
+        /**
+        * Passed on to every font in the chain.
+        */
+        void update() override;
+        /**
+        * @return The sum of the revisions of every font in the chain
+        */
+        unsigned int getRevision() override;
+        /**
+        * The chain's glyphs are spread over each font's textures,
+        * so it can't be an atlas.
+        * @return `false`
+        */
+        bool isAtlas() override;
+        void getGlyphRegion(char_t c, float *region) override;
+        /**
+        * @return Whether the first font is a distance field font.
+        * Mixing distance field fonts with normal ones isn't supported.
+        */
+        bool isDistanceField() override;
+        /**
+        * @param [in] c The codepoint
+        * @return `true` if any font in the chain has a glyph for `c`
+        */
+        bool hasChar(char_t c) override;
+        /**
+        * Clusters are drawn by the font that draws their first
+        * codepoint, which is remembered for the id it hands out.
+        * @param [in] codepoints The codepoints of the cluster
+        * @param [in] count The number of codepoints, at least 1
+        * @return The cluster's glyph in that font
+        */
+        char_t getClusterGlyph(const char_t *codepoints, std::size_t count) override;
+        /**
+        * @return `true` if any font in the chain shapes text
+        */
+        bool isShaping() override;
+        /**
+        * Runs are shaped by the font that draws them, as long as
+        * it draws every codepoint in it. Like clusters, the font
+        * is remembered for every glyph it hands out.
+        * @param [in] codepoints The codepoints, one per cell
+        * @param [in] count The number of codepoints
+        * @return The glyphs, or `nullptr` if each codepoint is drawn as is
+        */
+        shaped_t shape(const char_t *codepoints, std::size_t count) override;
+    };
+}
+
+#endif
@@ -0,0 +1,137 @@
+#include "GLState.h"
+
+#include <algorithm>
+
+#include "opengl.h"
+
+/// The tracker active on this thread
+static thread_local etm::GLState *activeState = nullptr;
+
+etm::GLState::Scope::Scope(GLState &state): previous(activeState) {
+    state.reset();
+    activeState = &state;
+}
+etm::GLState::Scope::~Scope() {
+    activeState = previous;
+}
+
+etm::GLState *etm::GLState::current() {
+    return activeState;
+}
+
+etm::GLState::GLState(): counters{0, 0} {
+    reset();
+}
+
+bool etm::GLState::count(bool issue) {
+    if (issue) {
+        counters.issued++;
+    } else {
+        counters.elided++;
+    }
+    return issue;
+}
+
+void etm::GLState::reset() {
+    program = UNKNOWN;
+    texture = UNKNOWN;
+    vertexArray = UNKNOWN;
+    arrayBuffer = UNKNOWN;
+    elementBuffer = UNKNOWN;
+}
+
+void etm::GLState::clear() {
+    reset();
+    uniforms.clear();
+}
+
+void etm::GLState::useProgram(name_t name) {
+    if (count(program != name)) {
+        glUseProgram(name);
+        program = name;
+    }
+}
+
+void etm::GLState::bindTexture(name_t name) {
+    if (count(texture != name)) {
+        glBindTexture(GL_TEXTURE_2D, name);
+        texture = name;
+    }
+}
+
+void etm::GLState::bindVertexArray(name_t name) {
+    if (count(vertexArray != name)) {
+        glBindVertexArray(name);
+        vertexArray = name;
+        // Comes with the vertex array
+        elementBuffer = UNKNOWN;
+    }
+}
+
+void etm::GLState::bindArrayBuffer(name_t name) {
+    if (count(arrayBuffer != name)) {
+        glBindBuffer(GL_ARRAY_BUFFER, name);
+        arrayBuffer = name;
+    }
+}
+
+void etm::GLState::bindElementBuffer(name_t name) {
+    if (count(elementBuffer != name || vertexArray == UNKNOWN)) {
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, name);
+        elementBuffer = name;
+    }
+}
+
+void etm::GLState::uniform3fv(int location, const float *value) {
+    if (program == UNKNOWN || location < 0) {
+        count(true);
+        glUniform3fv(location, 1, value);
+        return;
+    }
+    const std::uint64_t key = (static_cast<std::uint64_t>(program) << 32) | static_cast<std::uint32_t>(location);
+    auto loc = uniforms.find(key);
+    if (count(loc == uniforms.end() || !std::equal(value, value + 3, loc->second.begin()))) {
+        glUniform3fv(location, 1, value);
+        std::copy(value, value + 3, uniforms[key].begin());
+    }
+}
+
+void etm::GLState::forgetTexture(name_t name) {
+    if (texture == name) {
+        texture = UNKNOWN;
+    }
+}
+void etm::GLState::forgetVertexArray(name_t name) {
+    if (vertexArray == name) {
+        vertexArray = UNKNOWN;
+        elementBuffer = UNKNOWN;
+    }
+}
+void etm::GLState::forgetBuffer(name_t name) {
+    if (arrayBuffer == name) {
+        arrayBuffer = UNKNOWN;
+    }
+    if (elementBuffer == name) {
+        elementBuffer = UNKNOWN;
+    }
+}
+void etm::GLState::forgetProgram(name_t name) {
+    if (program == name) {
+        program = UNKNOWN;
+    }
+    // Program names can be reused
+    for (auto it = uniforms.begin(); it != uniforms.end();) {
+        if ((it->first >> 32) == name) {
+            it = uniforms.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+const etm::GLState::stats &etm::GLState::getStats() const {
+    return counters;
+}
+void etm::GLState::resetStats() {
+    counters = {0, 0};
+}
@@ -0,0 +1,177 @@
+#ifndef ETERMAL_GLSTATE_H_INCLUDED
+#define ETERMAL_GLSTATE_H_INCLUDED
+
+#include <unordered_map>
+#include <array>
+#include <cstdint>
+
+namespace etm {
+
+    /**
+    * Shadows the OpenGL state that the terminal sets the most
+    * (the program, texture, vertex array, buffers and vec3 uniforms),
+    * so that calls that wouldn't change anything can be skipped.
+    *
+    * The tracker is only consulted while it's @ref Scope "active",
+    * which the @ref Terminal does for the duration of each render.
+    * Outside of that (or if none is active), @ref Texture::bind() and
+    * friends go straight to OpenGL, as before.
+    * Since the caller could've changed anything in between frames,
+    * the bindings are forgotten every time the tracker is activated;
+    * the uniforms aren't, as they belong to the terminal's own programs.
+    * @see Resources::getGLState()
+    */
+    class GLState {
+    public:
+        /// OpenGL object name
+        typedef unsigned int name_t;
+
+        /**
+        * Call counters.
+        * @see getStats()
+        */
+        struct stats {
+            /// Number of calls passed on to OpenGL
+            unsigned long long issued;
+            /// Number of calls skipped because they wouldn't have changed anything
+            unsigned long long elided;
+        };
+
+        /**
+        * Activates a tracker for the current thread
+        * (and so, the current context) while it's in scope.
+        */
+        class Scope {
+            /// The previously active tracker
+            GLState *previous;
+        public:
+            /**
+            * Activates the tracker, after forgetting its bindings.
+            * @param [in] state The tracker
+            */
+            Scope(GLState &state);
+            /**
+            * Re-activates the previously active tracker, if any.
+            */
+            ~Scope();
+            Scope(const Scope&) = delete;
+            Scope &operator=(const Scope&) = delete;
+        };
+
+    private:
+        /// Value of a binding whose value isn't known
+        static constexpr name_t UNKNOWN = ~static_cast<name_t>(0);
+
+        /// The current program
+        name_t program;
+        /// The texture bound to GL_TEXTURE_2D
+        name_t texture;
+        /// The current vertex array
+        name_t vertexArray;
+        /// The buffer bound to GL_ARRAY_BUFFER
+        name_t arrayBuffer;
+        /// The buffer bound to GL_ELEMENT_ARRAY_BUFFER,
+        /// which is part of the @ref vertexArray
+        name_t elementBuffer;
+        /// The last vec3 uniform values, by program and location
+        std::unordered_map<std::uint64_t, std::array<float, 3>> uniforms;
+        /// The counters
+        stats counters;
+
+        /**
+        * Records a call.
+        * @param [in] issue Whether the call was issued
+        * @return `issue`
+        */
+        bool count(bool issue);
+    public:
+        /**
+        * Gets the tracker active on this thread.
+        * @return The tracker, or `nullptr` if there is none
+        */
+        static GLState *current();
+
+        /**
+        * Constructs a tracker that doesn't know anything.
+        */
+        GLState();
+
+        /**
+        * Forgets all bindings, as they may have been
+        * changed by someone else.
+        */
+        void reset();
+        /**
+        * Forgets everything, including uniforms.
+        * Necessary when the programs are deleted.
+        */
+        void clear();
+
+        /**
+        * Calls `glUseProgram` if `name` isn't current.
+        * @param [in] name The program
+        */
+        void useProgram(name_t name);
+        /**
+        * Calls `glBindTexture(GL_TEXTURE_2D, ...)` if `name` isn't bound.
+        * @param [in] name The texture
+        */
+        void bindTexture(name_t name);
+        /**
+        * Calls `glBindVertexArray` if `name` isn't bound.
+        * @param [in] name The vertex array
+        */
+        void bindVertexArray(name_t name);
+        /**
+        * Calls `glBindBuffer(GL_ARRAY_BUFFER, ...)` if `name` isn't bound.
+        * @param [in] name The buffer
+        */
+        void bindArrayBuffer(name_t name);
+        /**
+        * Calls `glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ...)` if `name` isn't bound.
+        * @param [in] name The buffer
+        */
+        void bindElementBuffer(name_t name);
+        /**
+        * Calls `glUniform3fv` if the uniform of the current
+        * program doesn't already have the value.
+        * @param [in] location The uniform location
+        * @param [in] value The 3 values
+        */
+        void uniform3fv(int location, const float *value);
+
+        /**
+        * Must be called when a texture is deleted,
+        * as OpenGL unbinds it.
+        * @param [in] name The texture
+        */
+        void forgetTexture(name_t name);
+        /**
+        * Must be called when a vertex array is deleted.
+        * @param [in] name The vertex array
+        */
+        void forgetVertexArray(name_t name);
+        /**
+        * Must be called when a buffer is deleted.
+        * @param [in] name The buffer
+        */
+        void forgetBuffer(name_t name);
+        /**
+        * Must be called when a program is deleted.
+        * @param [in] name The program
+        */
+        void forgetProgram(name_t name);
+
+        /**
+        * Gets the call counters.
+        * @return The counters
+        */
+        const stats &getStats() const;
+        /**
+        * Zeros the call counters.
+        */
+        void resetStats();
+    };
+}
+
+#endif
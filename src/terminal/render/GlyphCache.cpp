@@ -0,0 +1,82 @@
+#include "GlyphCache.h"
+
+#include <functional>
+
+bool etm::GlyphCache::key::operator==(const key &other) const {
+    return codepoint == other.codepoint && size == other.size && face == other.face && cluster == other.cluster;
+}
+
+std::size_t etm::GlyphCache::hasher::operator()(const key &k) const {
+    std::size_t hash = std::hash<std::string>()(k.face);
+    hash ^= (static_cast<std::size_t>(k.size) << 21) ^ k.codepoint;
+    return hash * 0x9E3779B97F4A7C15ull;
+}
+
+double etm::GlyphCache::stats::hitRate() const {
+    const unsigned long long total = hits + misses;
+    return total ? static_cast<double>(hits) / total : 0;
+}
+
+etm::GlyphCache::GlyphCache(): counters{0, 0, 0, 0, 0, DEFAULT_CAPACITY} {
+}
+
+etm::GlyphCache &etm::GlyphCache::get() {
+    static GlyphCache cache;
+    return cache;
+}
+
+void etm::GlyphCache::trim() {
+    // Always keep the most recent one, even if it's huge
+    while (counters.bytes > counters.capacity && order.size() > 1) {
+        counters.bytes -= order.back().second->data.size();
+        table.erase(order.back().first);
+        order.pop_back();
+        counters.evictions++;
+    }
+    counters.entries = order.size();
+}
+
+etm::GlyphCache::bitmap_t etm::GlyphCache::find(const key &k) {
+    std::lock_guard<std::mutex> guard(lock);
+    table_t::iterator loc = table.find(k);
+    if (loc == table.end()) {
+        counters.misses++;
+        return nullptr;
+    }
+    counters.hits++;
+    order.splice(order.begin(), order, loc->second);
+    return loc->second->second;
+}
+
+void etm::GlyphCache::insert(const key &k, const bitmap_t &bmp) {
+    std::lock_guard<std::mutex> guard(lock);
+    table_t::iterator loc = table.find(k);
+    if (loc != table.end()) {
+        counters.bytes -= loc->second->second->data.size();
+        order.erase(loc->second);
+        table.erase(loc);
+    }
+    order.emplace_front(k, bmp);
+    table.emplace(k, order.begin());
+    counters.bytes += bmp->data.size();
+    trim();
+}
+
+void etm::GlyphCache::setCapacity(std::size_t bytes) {
+    std::lock_guard<std::mutex> guard(lock);
+    counters.capacity = bytes;
+    trim();
+}
+
+void etm::GlyphCache::clear() {
+    std::lock_guard<std::mutex> guard(lock);
+    order.clear();
+    table.clear();
+    counters.bytes = 0;
+    counters.entries = 0;
+}
+
+etm::GlyphCache::stats etm::GlyphCache::getStats() {
+    std::lock_guard<std::mutex> guard(lock);
+    return counters;
+}
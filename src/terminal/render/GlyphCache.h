@@ -0,0 +1,171 @@
+#ifndef ETERMAL_GLYPHCACHE_H_INCLUDED
+#define ETERMAL_GLYPHCACHE_H_INCLUDED
+
+#include <string>
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <cstddef>
+
+#include "../util/singleton.h"
+
+namespace etm {
+
+    /**
+    * Process-wide cache of rasterized glyph bitmaps.
+    * Rendering a glyph with Freetype is slow, and the result only
+    * depends on the face, the pixel size and the codepoint - so it's
+    * kept here, on the CPU, where every @ref Font using the same face
+    * and size can get at it (regardless of which @ref Terminal it
+    * belongs to, or how many times its own texture cache was cleared).
+    *
+    * The cache is bounded by the total size of the bitmaps, and evicts
+    * the least recently used glyphs once that's exceeded.
+    * @note Thread safe
+    */
+    class GlyphCache: public singleton {
+    public:
+        /// Codepoint type
+        typedef unsigned int char_t;
+
+        /**
+        * Identifies a rasterized glyph.
+        */
+        struct key {
+            /// Identifies the face, ex. the path it was loaded from
+            std::string face;
+            /// Pixel size of the face
+            unsigned int size;
+            /// The codepoint, or the id of a cluster
+            char_t codepoint;
+            /// The codepoints of the cluster, empty if it's just one
+            /// (ids are only unique within a single font)
+            std::vector<char_t> cluster;
+            /**
+            * Compares equal to.
+            * @param [in] other The key to compare against
+            * @return `true` if all fields are equal
+            */
+            bool operator==(const key &other) const;
+        };
+
+        /**
+        * A single channel bitmap, ready to be uploaded as a texture.
+        */
+        struct bitmap {
+            /// Width in pixels
+            int width;
+            /// Height in pixels
+            int height;
+            /// `width * height` bytes of pixel data, bottom row first
+            std::vector<unsigned char> data;
+        };
+
+        /// Handle to a cached bitmap; stays valid even if evicted
+        typedef std::shared_ptr<const bitmap> bitmap_t;
+
+        /**
+        * Cache usage counters.
+        * @see getStats()
+        */
+        struct stats {
+            /// Number of lookups that found the glyph
+            unsigned long long hits;
+            /// Number of lookups that didn't
+            unsigned long long misses;
+            /// Number of glyphs evicted to stay within the capacity
+            unsigned long long evictions;
+            /// Number of glyphs currently cached
+            std::size_t entries;
+            /// Bytes of bitmap data currently cached
+            std::size_t bytes;
+            /// Max bytes of bitmap data
+            std::size_t capacity;
+            /**
+            * Gets the proportion of lookups that were hits.
+            * @return The hit rate (0-1), or 0 if there were no lookups
+            */
+            double hitRate() const;
+        };
+
+    private:
+        /**
+        * Hashes a @ref key.
+        */
+        struct hasher {
+            /**
+            * Hashes a key.
+            * @param [in] k The key
+            * @return The hash
+            */
+            std::size_t operator()(const key &k) const;
+        };
+        /// Recency list, most recently used at the front
+        typedef std::list<std::pair<key, bitmap_t>> order_t;
+        /// Lookup table into @ref order
+        typedef std::unordered_map<key, order_t::iterator, hasher> table_t;
+
+        /// Guards everything
+        std::mutex lock;
+        /// The glyphs, in order of use
+        order_t order;
+        /// The glyphs, by key
+        table_t table;
+        /// The usage counters
+        stats counters;
+
+        /**
+        * Evicts the least recently used glyphs until
+        * the cache is within its capacity.
+        * @note @ref lock must be held
+        */
+        void trim();
+        /**
+        * Constructs an empty cache with the default capacity.
+        */
+        GlyphCache();
+    public:
+        /// Default capacity, in bytes of bitmap data
+        static constexpr std::size_t DEFAULT_CAPACITY = 16 * 1024 * 1024;
+
+        /**
+        * Gets the process-wide cache.
+        * @return The cache
+        */
+        static GlyphCache &get();
+
+        /**
+        * Looks up a glyph, and marks it as recently used.
+        * @param [in] k The glyph
+        * @return The bitmap, or `nullptr` if it's not cached
+        */
+        bitmap_t find(const key &k);
+        /**
+        * Adds a glyph, evicting others if necessary.
+        * If the glyph is already cached, it's replaced.
+        * @param [in] k The glyph
+        * @param [in] bmp The bitmap
+        */
+        void insert(const key &k, const bitmap_t &bmp);
+
+        /**
+        * Sets the max number of bytes of bitmap data to keep.
+        * @param [in] bytes The capacity
+        */
+        void setCapacity(std::size_t bytes);
+        /**
+        * Evicts all glyphs.
+        * @note The counters are not reset
+        */
+        void clear();
+        /**
+        * Gets the usage counters.
+        * @return A copy of the counters
+        */
+        stats getStats();
+    };
+}
+
+#endif
@@ -0,0 +1,108 @@
+#include "GlyphPack.h"
+
+#include <fstream>
+#include <cmath>
+#include <algorithm>
+
+/**
+* Appends an unsigned 32 bit integer, little endian.
+* @param [out] out The buffer
+* @param [in] value The value
+*/
+static void putUint32(std::string &out, std::uint32_t value);
+
+void putUint32(std::string &out, std::uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        out.push_back(static_cast<char>((value >> (i * 8)) & 0xFF));
+    }
+}
+
+etm::GlyphPack::GlyphPack(): GlyphPack(0, 0) {
+}
+etm::GlyphPack::GlyphPack(int cellWidth, int cellHeight):
+    cellWidth(cellWidth), cellHeight(cellHeight),
+    fallback(static_cast<std::size_t>(cellWidth) * cellHeight, 0) {
+}
+
+void etm::GlyphPack::setFallback(const unsigned char *bitmap) {
+    fallback.assign(bitmap, bitmap + fallback.size());
+}
+void etm::GlyphPack::add(char_t c, const unsigned char *bitmap) {
+    glyphs[c].assign(bitmap, bitmap + fallback.size());
+}
+
+int etm::GlyphPack::getCellWidth() const {
+    return cellWidth;
+}
+int etm::GlyphPack::getCellHeight() const {
+    return cellHeight;
+}
+std::size_t etm::GlyphPack::size() const {
+    return glyphs.size();
+}
+
+bool etm::GlyphPack::save(const std::string &path, std::string &error) const {
+    if (cellWidth <= 0 || cellHeight <= 0) {
+        error = "Glyph pack has no cell size";
+        return false;
+    }
+
+    const std::size_t count = glyphs.size() + 1;
+    const int slotWidth = cellWidth + PADDING;
+    const int slotHeight = cellHeight + PADDING;
+    // Aim for a roughly square atlas, which keeps
+    // both sides well under the texture size limits
+    const int columns = std::max(1, static_cast<int>(std::ceil(std::sqrt(
+        static_cast<double>(count) * slotHeight / slotWidth
+    ))));
+    const int rows = static_cast<int>((count + columns - 1) / columns);
+    const std::size_t atlasWidth = static_cast<std::size_t>(columns) * slotWidth;
+    const std::size_t atlasHeight = static_cast<std::size_t>(rows) * slotHeight;
+
+    std::string header;
+    header.reserve(HEADER_SIZE + count * ENTRY_SIZE);
+    header.append(MAGIC, sizeof(MAGIC));
+    putUint32(header, VERSION);
+    putUint32(header, cellWidth);
+    putUint32(header, cellHeight);
+    putUint32(header, atlasWidth);
+    putUint32(header, atlasHeight);
+    putUint32(header, count);
+
+    std::vector<unsigned char> atlas(atlasWidth * atlasHeight, 0);
+    std::size_t slot = 0;
+    // Copies a bitmap into the next slot, and records it in the table
+    auto place = [&](char_t c, const std::vector<unsigned char> &bitmap) -> void {
+        const std::size_t x = (slot % columns) * slotWidth;
+        const std::size_t y = (slot / columns) * slotHeight;
+        for (int row = 0; row < cellHeight; row++) {
+            std::copy_n(
+                bitmap.begin() + static_cast<std::size_t>(row) * cellWidth,
+                cellWidth,
+                atlas.begin() + (y + row) * atlasWidth + x
+            );
+        }
+        putUint32(header, c);
+        putUint32(header, x);
+        putUint32(header, y);
+        slot++;
+    };
+    place(0, fallback);
+    // std::map is ordered, so the table comes out sorted
+    for (auto &g : glyphs) {
+        place(g.first, g.second);
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        error = "Failed to open \"" + path + "\" for writing";
+        return false;
+    }
+    file.write(header.data(), header.size());
+    file.write(reinterpret_cast<const char *>(atlas.data()), atlas.size());
+    if (!file.good()) {
+        error = "Failed to write to \"" + path + "\"";
+        return false;
+    }
+    return true;
+}
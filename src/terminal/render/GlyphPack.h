@@ -0,0 +1,108 @@
+#ifndef ETERMAL_GLYPHPACK_H_INCLUDED
+#define ETERMAL_GLYPHPACK_H_INCLUDED
+
+#include <string>
+#include <vector>
+#include <map>
+#include <cstdint>
+#include <cstddef>
+
+namespace etm {
+
+    /**
+    * A set of pre-rendered glyphs, for writing to a glyph pack file.
+    * Glyph packs are meant to be made ahead of time
+    * (see `tools/etmpack`) from a @ref Font or @ref BmpFont, and then
+    * loaded with @ref PackFont, which is much faster than either
+    * because there's nothing left to do but upload the atlas.
+    *
+    * The file format, all integers unsigned 32 bit little endian:
+    *  - @ref MAGIC and @ref VERSION
+    *  - cell width and height
+    *  - atlas width and height
+    *  - glyph count, then for each the codepoint and the
+    *    x/y of the glyph's bottom left corner in the atlas.
+    *    The first glyph is the fallback, its codepoint is ignored;
+    *    the rest are sorted by codepoint.
+    *  - The atlas, one byte per pixel, bottom row first
+    *    (as OpenGL expects it).
+    * @see PackFont
+    */
+    class GlyphPack {
+    public:
+        /// Codepoint type
+        typedef unsigned int char_t;
+        /// Identifies glyph pack files
+        static constexpr char MAGIC[8] = {'E', 'T', 'M', 'P', 'A', 'C', 'K', '\0'};
+        /// Current version of the format
+        static constexpr std::uint32_t VERSION = 1;
+        /// Empty pixels between glyphs in the atlas,
+        /// so that filtering doesn't bleed into neighbours
+        static constexpr int PADDING = 1;
+        /// Size of the fixed header, before the glyph table
+        static constexpr std::size_t HEADER_SIZE = sizeof(MAGIC) + 4 * 6;
+        /// Size of each entry in the glyph table
+        static constexpr std::size_t ENTRY_SIZE = 4 * 3;
+    private:
+        /// Width of each glyph
+        int cellWidth;
+        /// Height of each glyph
+        int cellHeight;
+        /// Bitmap of the glyph used for missing codepoints
+        std::vector<unsigned char> fallback;
+        /// The glyph bitmaps
+        std::map<char_t, std::vector<unsigned char>> glyphs;
+    public:
+        /**
+        * Construct an empty pack with no cell size.
+        */
+        GlyphPack();
+        /**
+        * Construct an empty pack.
+        * The fallback glyph is blank until set.
+        * @param [in] cellWidth Width of each glyph
+        * @param [in] cellHeight Height of each glyph
+        */
+        GlyphPack(int cellWidth, int cellHeight);
+
+        /**
+        * Set the glyph rendered in place of codepoints
+        * that aren't in the pack.
+        * @param [in] bitmap `cellWidth * cellHeight` bytes, bottom row first
+        */
+        void setFallback(const unsigned char *bitmap);
+        /**
+        * Add a glyph, replacing any with the same codepoint.
+        * @param [in] c The codepoint
+        * @param [in] bitmap `cellWidth * cellHeight` bytes, bottom row first
+        */
+        void add(char_t c, const unsigned char *bitmap);
+
+        /**
+        * Gets the width of each glyph
+        * @return The width
+        */
+        int getCellWidth() const;
+        /**
+        * Gets the height of each glyph
+        * @return The height
+        */
+        int getCellHeight() const;
+        /**
+        * Gets the number of glyphs, not
+        * including the fallback.
+        * @return The number of glyphs
+        */
+        std::size_t size() const;
+
+        /**
+        * Lay out the atlas and write the pack to a file.
+        * @param [in] path The file to write
+        * @param [out] error Why it failed, if it did
+        * @return `true` on success
+        */
+        bool save(const std::string &path, std::string &error) const;
+    };
+}
+
+#endif
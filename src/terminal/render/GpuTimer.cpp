@@ -0,0 +1,103 @@
+#include "GpuTimer.h"
+
+#include "opengl.h"
+
+etm::GpuTimer::GpuTimer():
+    current(QUERIES - 1),
+    running(false),
+    supported(GLAD_GL_VERSION_3_3)
+{
+    for (int i = 0; i < QUERIES; i++) {
+        queries[i] = 0;
+        tags[i] = 0;
+        pending[i] = false;
+    }
+    if (supported) {
+        glGenQueries(QUERIES, queries);
+    }
+}
+
+etm::GpuTimer::~GpuTimer() {
+    free();
+}
+
+etm::GpuTimer::GpuTimer(GpuTimer &&other) {
+    steal(other);
+}
+etm::GpuTimer &etm::GpuTimer::operator=(GpuTimer &&other) {
+    free();
+    steal(other);
+    return *this;
+}
+
+void etm::GpuTimer::steal(GpuTimer &other) {
+    for (int i = 0; i < QUERIES; i++) {
+        queries[i] = other.queries[i];
+        tags[i] = other.tags[i];
+        pending[i] = other.pending[i];
+        other.queries[i] = 0;
+    }
+    current = other.current;
+    running = other.running;
+    supported = other.supported;
+    other.supported = false;
+}
+
+void etm::GpuTimer::free() {
+    // If not supported, there's nothing to delete
+    // (or it was moved)
+    if (supported) {
+        glDeleteQueries(QUERIES, queries);
+        supported = false;
+    }
+}
+
+bool etm::GpuTimer::isSupported() const {
+    return supported;
+}
+
+void etm::GpuTimer::begin(unsigned long long tag) {
+    if (!supported || running) {
+        return;
+    }
+    const int next = (current + 1) % QUERIES;
+    // Still waiting on the GPU, so skip this one
+    if (pending[next]) {
+        return;
+    }
+    current = next;
+    tags[current] = tag;
+    glBeginQuery(GL_TIME_ELAPSED, queries[current]);
+    running = true;
+}
+
+void etm::GpuTimer::end() {
+    if (running) {
+        glEndQuery(GL_TIME_ELAPSED);
+        pending[current] = true;
+        running = false;
+    }
+}
+
+bool etm::GpuTimer::poll(unsigned long long &tag, double &microseconds) {
+    // Oldest first
+    for (int i = 1; i <= QUERIES; i++) {
+        const int index = (current + i) % QUERIES;
+        if (!pending[index] || (running && index == current)) {
+            continue;
+        }
+        GLuint available = GL_FALSE;
+        glGetQueryObjectuiv(queries[index], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) {
+            // The ones after it won't be either
+            return false;
+        }
+        GLuint64 nanoseconds = 0;
+        glGetQueryObjectui64v(queries[index], GL_QUERY_RESULT, &nanoseconds);
+        pending[index] = false;
+        tag = tags[index];
+        microseconds = nanoseconds / 1000.0;
+        return true;
+    }
+    return false;
+}
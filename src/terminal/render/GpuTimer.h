@@ -0,0 +1,94 @@
+#ifndef ETERMAL_GPUTIMER_H_INCLUDED
+#define ETERMAL_GPUTIMER_H_INCLUDED
+
+namespace etm {
+
+    /**
+    * Measures how long the GPU takes to get through a frame's
+    * commands, with `GL_TIME_ELAPSED` queries.
+    * Results come in a few frames late, since waiting on them
+    * right away would stall the CPU until the GPU caught up - so
+    * the queries are cycled, and each frame picks up whatever
+    * finished since the last.
+    * Does nothing if the context doesn't support timer queries
+    * (they're core as of OpenGL 3.3).
+    * @note All GL objects are created in the current context,
+    * and must be used in that same context.
+    */
+    class GpuTimer {
+    public:
+        /// Number of queries that can be in flight at once
+        static constexpr int QUERIES = 4;
+    private:
+        /// The query objects
+        unsigned int queries[QUERIES];
+        /// What each query is timing, as given to @ref begin(unsigned long long tag)
+        unsigned long long tags[QUERIES];
+        /// Whether each query has a result that hasn't been collected
+        bool pending[QUERIES];
+        /// The query that was begun last
+        int current;
+        /// Whether a query is running
+        bool running;
+        /// Whether the context supports timer queries
+        bool supported;
+
+        /**
+        * Take the resources of another object.
+        * @param [in,out] other The object to steal from
+        */
+        void steal(GpuTimer &other);
+        /**
+        * Releases the queries.
+        */
+        void free();
+    public:
+        /**
+        * Construct a timer.
+        * @note Creates the OpenGL queries in the current context.
+        */
+        GpuTimer();
+        /**
+        * Destroys the queries, if not moved.
+        */
+        ~GpuTimer();
+        /**
+        * Initialize with moved object.
+        * @param [in,out] other Target object
+        */
+        GpuTimer(GpuTimer &&other);
+        /**
+        * Move object into `*this`.
+        * @param [in,out] other Target object
+        */
+        GpuTimer &operator=(GpuTimer &&other);
+
+        /**
+        * Whether timer queries are supported.
+        * @return `true` if they are
+        */
+        bool isSupported() const;
+        /**
+        * Start timing.
+        * If every query is still waiting on the GPU,
+        * nothing is timed until the next call.
+        * @param [in] tag Identifies what's being timed,
+        * handed back by @ref poll()
+        */
+        void begin(unsigned long long tag);
+        /**
+        * Stop timing.
+        */
+        void end();
+        /**
+        * Collects a finished result, without waiting.
+        * @param [out] tag What was timed
+        * @param [out] microseconds How long the GPU took
+        * @return `true` if there was a result, call again
+        * for the next one
+        */
+        bool poll(unsigned long long &tag, double &microseconds);
+    };
+}
+
+#endif
@@ -0,0 +1,132 @@
+#include "PackFont.h"
+
+#include <stdexcept>
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+
+#include "opengl.h"
+#include "GlyphPack.h"
+#include "../util/MappedFile.h"
+
+/**
+* Reads an unsigned 32 bit little endian integer.
+* @param [in] data Pointer to the first byte
+* @return The integer
+*/
+static std::uint32_t getUint32(const char *data);
+
+std::uint32_t getUint32(const char *data) {
+    std::uint32_t value = 0;
+    for (int i = 0; i < 4; i++) {
+        value |= static_cast<std::uint32_t>(static_cast<unsigned char>(data[i])) << (i * 8);
+    }
+    return value;
+}
+
+etm::PackFont::PackFont(const std::string &path) {
+    const std::string error = "etm::PackFont: Failed to load glyph pack \"" + path + "\": ";
+
+    MappedFile file;
+    if (!file.open(path)) {
+        throw std::invalid_argument(error + file.getError());
+    }
+    const char *data = file.data();
+    const std::size_t size = file.size();
+
+    if (size < GlyphPack::HEADER_SIZE || std::memcmp(data, GlyphPack::MAGIC, sizeof(GlyphPack::MAGIC)) != 0) {
+        throw std::invalid_argument(error + "Not a glyph pack");
+    }
+    const char *field = data + sizeof(GlyphPack::MAGIC);
+    const std::uint32_t version = getUint32(field);
+    if (version != GlyphPack::VERSION) {
+        throw std::invalid_argument(error + "Unsupported version " + std::to_string(version));
+    }
+    width = getUint32(field + 4);
+    height = getUint32(field + 8);
+    const std::uint64_t atlasWidth = getUint32(field + 12);
+    const std::uint64_t atlasHeight = getUint32(field + 16);
+    const std::uint64_t count = getUint32(field + 20);
+
+    const std::uint64_t tableEnd = GlyphPack::HEADER_SIZE + count * GlyphPack::ENTRY_SIZE;
+    if (width <= 0 || height <= 0 || count == 0 || tableEnd > size || atlasWidth * atlasHeight != size - tableEnd) {
+        throw std::invalid_argument(error + "Corrupt glyph pack");
+    }
+
+    glyphs.reserve(count - 1);
+    for (std::uint64_t i = 0; i < count; i++) {
+        const char *entry = data + GlyphPack::HEADER_SIZE + i * GlyphPack::ENTRY_SIZE;
+        const std::uint64_t x = getUint32(entry + 4);
+        const std::uint64_t y = getUint32(entry + 8);
+        if (x + width > atlasWidth || y + height > atlasHeight) {
+            throw std::invalid_argument(error + "Corrupt glyph pack");
+        }
+        glyph g;
+        g.codepoint = getUint32(entry);
+        g.region[0] = static_cast<float>(x) / atlasWidth;
+        g.region[1] = static_cast<float>(y) / atlasHeight;
+        g.region[2] = static_cast<float>(x + width) / atlasWidth;
+        g.region[3] = static_cast<float>(y + height) / atlasHeight;
+        if (i == 0) {
+            std::copy_n(g.region, 4, fallback);
+        } else {
+            glyphs.push_back(g);
+        }
+    }
+    // The table should already be sorted, but lookups
+    // depend on it so it's best to make sure
+    if (!std::is_sorted(glyphs.begin(), glyphs.end(), [](const glyph &a, const glyph &b) -> bool {
+        return a.codepoint < b.codepoint;
+    })) {
+        throw std::invalid_argument(error + "Corrupt glyph pack");
+    }
+
+    GLint unpackAlign;
+    glGetIntegerv(GL_UNPACK_ALIGNMENT, &unpackAlign);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    // Straight from the mapping, no copies
+    atlas.setData(
+        GL_RED, atlasWidth, atlasHeight,
+        reinterpret_cast<const Texture::data_t *>(data + tableEnd)
+    );
+    if (unpackAlign != 1) {
+        glPixelStorei(GL_UNPACK_ALIGNMENT, unpackAlign);
+    }
+}
+
+void etm::PackFont::setResMan(Resources *res) {
+    // Do nothing
+}
+void etm::PackFont::setSize(unsigned int size) {
+    // Do nothing - the glyphs were rendered at a fixed size
+}
+void etm::PackFont::bindChar(char_t c) {
+    atlas.bind();
+}
+void etm::PackFont::clearCache() {
+    // Do nothing, there's no cache
+}
+int etm::PackFont::getCharWidth() {
+    return width;
+}
+int etm::PackFont::getCharHeight() {
+    return height;
+}
+
+bool etm::PackFont::isAtlas() {
+    return true;
+}
+void etm::PackFont::getGlyphRegion(char_t c, float *region) {
+    const glyph *g = find(c);
+    std::copy_n(g != nullptr ? g->region : fallback, 4, region);
+}
+bool etm::PackFont::hasChar(char_t c) {
+    return find(c) != nullptr;
+}
+
+const etm::PackFont::glyph *etm::PackFont::find(char_t c) const {
+    auto it = std::lower_bound(glyphs.begin(), glyphs.end(), c, [](const glyph &g, char_t c) -> bool {
+        return g.codepoint < c;
+    });
+    return it != glyphs.end() && it->codepoint == c ? &*it : nullptr;
+}
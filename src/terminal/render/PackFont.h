@@ -0,0 +1,94 @@
+#ifndef ETERMAL_PACKFONT_H_INCLUDED
+#define ETERMAL_PACKFONT_H_INCLUDED
+
+#include <string>
+#include <vector>
+
+#include "EtmFont.h"
+#include "Texture.h"
+
+namespace etm {
+
+    /**
+    * A font loaded from a glyph pack file.
+    * All the slicing, flipping and rasterizing has already been done
+    * when the pack was made (see @ref GlyphPack), so loading comes
+    * down to mapping the file and uploading its atlas in one go.
+    * Like @ref BmpFont, it can't be resized.
+    * @see GlyphPack
+    * @see Font
+    * @see BmpFont
+    */
+    class PackFont: public EtmFont {
+        /// A glyph in the atlas
+        struct glyph {
+            /// The codepoint
+            char_t codepoint;
+            /// Texture coordinates of the left, bottom, right and top
+            float region[4];
+        };
+        /// Every glyph in the atlas, sorted by codepoint
+        std::vector<glyph> glyphs;
+        /// Texture coordinates of the fallback glyph
+        float fallback[4];
+        /// The atlas
+        Texture atlas;
+        /// Width of each glyph
+        int width;
+        /// Height of each glyph
+        int height;
+        /**
+        * Look up a glyph.
+        * @param [in] c The codepoint
+        * @return The glyph, or `nullptr` if the pack doesn't have it
+        */
+        const glyph *find(char_t c) const;
+    public:
+        /**
+        * Load a glyph pack.
+        * @warning Uploads the atlas to the current context,
+        * so make sure the desired context is current!
+        * @param [in] path Path to the glyph pack
+        * @throw std::invalid_argument if the given `path` cannot be
+        * opened or isn't a valid glyph pack
+        */
+        PackFont(const std::string &path);
+
+        /**
+        * Does nothing, we don't need it.
+        * @param [in] res [ignored]
+        */
+        void setResMan(Resources *res) override;
+        /**
+        * Does nothing, the glyphs were rendered at a fixed size.
+        * Make another pack to change it.
+        * @param [in] size [ignored]
+        */
+        void setSize(unsigned int size) override;
+        /**
+        * Binds the atlas, whatever the codepoint.
+        * @param [in] c [ignored]
+        * @see getGlyphRegion(char_t c, float *region)
+        */
+        void bindChar(char_t c) override;
+        /**
+        * Does nothing, as there's no cache.
+        */
+        void clearCache() override;
+        int getCharWidth() override;
+        int getCharHeight() override;
+
+        /**
+        * @return `true`
+        */
+        bool isAtlas() override;
+        void getGlyphRegion(char_t c, float *region) override;
+        /**
+        * @param [in] c The codepoint
+        * @return `true` if the pack has a glyph for `c`
+        */
+        bool hasChar(char_t c) override;
+    };
+}
+
+#endif
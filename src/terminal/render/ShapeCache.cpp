@@ -0,0 +1,74 @@
+#include "ShapeCache.h"
+
+#include <functional>
+
+bool etm::ShapeCache::key::operator==(const key &other) const {
+    return size == other.size && text == other.text && face == other.face;
+}
+
+std::size_t etm::ShapeCache::hasher::operator()(const key &k) const {
+    std::size_t hash = std::hash<std::string>()(k.face) ^ k.size;
+    for (char_t c : k.text) {
+        hash = (hash ^ c) * 0x100000001B3ull;
+    }
+    return hash;
+}
+
+double etm::ShapeCache::stats::hitRate() const {
+    const unsigned long long total = hits + misses;
+    return total ? static_cast<double>(hits) / total : 0;
+}
+
+etm::ShapeCache::ShapeCache(): counters{0, 0, 0, 0, DEFAULT_CAPACITY} {
+}
+
+void etm::ShapeCache::trim() {
+    while (order.size() > counters.capacity) {
+        table.erase(order.back().first);
+        order.pop_back();
+        counters.evictions++;
+    }
+    counters.entries = order.size();
+}
+
+bool etm::ShapeCache::find(const std::string &face, unsigned int size, const char_t *codepoints, std::size_t count, run_t &run) {
+    // Assigning reuses the probe's memory
+    probe.face = face;
+    probe.size = size;
+    probe.text.assign(codepoints, codepoints + count);
+    table_t::iterator loc = table.find(probe);
+    if (loc == table.end()) {
+        counters.misses++;
+        return false;
+    }
+    counters.hits++;
+    order.splice(order.begin(), order, loc->second);
+    run = loc->second->second;
+    return true;
+}
+
+void etm::ShapeCache::insert(const key &k, const run_t &run) {
+    table_t::iterator loc = table.find(k);
+    if (loc != table.end()) {
+        order.erase(loc->second);
+        table.erase(loc);
+    }
+    order.emplace_front(k, run);
+    table.emplace(k, order.begin());
+    trim();
+}
+
+void etm::ShapeCache::setCapacity(std::size_t runs) {
+    counters.capacity = runs;
+    trim();
+}
+
+void etm::ShapeCache::clear() {
+    order.clear();
+    table.clear();
+    counters.entries = 0;
+}
+
+etm::ShapeCache::stats etm::ShapeCache::getStats() const {
+    return counters;
+}
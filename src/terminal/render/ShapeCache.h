@@ -0,0 +1,152 @@
+#ifndef ETERMAL_SHAPECACHE_H_INCLUDED
+#define ETERMAL_SHAPECACHE_H_INCLUDED
+
+#include <string>
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <cstddef>
+
+#include "EtmFont.h"
+
+namespace etm {
+
+    /**
+    * Cache of shaped runs of text.
+    * Shaping a run (ex. with HarfBuzz) is way too slow to do for
+    * every run every frame, and the text on screen rarely changes -
+    * so once a run has been shaped, the result is kept here, and
+    * drawing it again only costs a hash lookup.
+    *
+    * The cache is bounded by the number of runs, and evicts
+    * the least recently used ones once that's exceeded.
+    * Runs that were left as they are (`nullptr`) are cached too,
+    * since they're the common case.
+    * @note Not thread safe
+    * @see EtmFont::shape(const char_t *codepoints, std::size_t count)
+    */
+    class ShapeCache {
+    public:
+        /// Codepoint type
+        typedef EtmFont::char_t char_t;
+        /// Shaped run type
+        typedef EtmFont::shaped_t run_t;
+
+        /**
+        * Identifies a shaped run.
+        */
+        struct key {
+            /// Identifies the face, ex. the path it was loaded from
+            std::string face;
+            /// Pixel size of the face
+            unsigned int size;
+            /// The codepoints of the run
+            std::vector<char_t> text;
+            /**
+            * Compares equal to.
+            * @param [in] other The key to compare against
+            * @return `true` if all fields are equal
+            */
+            bool operator==(const key &other) const;
+        };
+
+        /**
+        * Cache usage counters.
+        * @see getStats()
+        */
+        struct stats {
+            /// Number of lookups that found the run
+            unsigned long long hits;
+            /// Number of lookups that didn't
+            unsigned long long misses;
+            /// Number of runs evicted to stay within the capacity
+            unsigned long long evictions;
+            /// Number of runs currently cached
+            std::size_t entries;
+            /// Max number of runs
+            std::size_t capacity;
+            /**
+            * Gets the proportion of lookups that were hits.
+            * @return The hit rate (0-1), or 0 if there were no lookups
+            */
+            double hitRate() const;
+        };
+
+    private:
+        /**
+        * Hashes a @ref key.
+        */
+        struct hasher {
+            /**
+            * Hashes a key.
+            * @param [in] k The key
+            * @return The hash
+            */
+            std::size_t operator()(const key &k) const;
+        };
+        /// Recency list, most recently used at the front
+        typedef std::list<std::pair<key, run_t>> order_t;
+        /// Lookup table into @ref order
+        typedef std::unordered_map<key, order_t::iterator, hasher> table_t;
+
+        /// The runs, in order of use
+        order_t order;
+        /// The runs, by key
+        table_t table;
+        /// The usage counters
+        stats counters;
+        /// Reused by @ref find(const std::string &face, unsigned int size, const char_t *codepoints, std::size_t count),
+        /// so that looking up a run doesn't allocate
+        key probe;
+
+        /**
+        * Evicts the least recently used runs until
+        * the cache is within its capacity.
+        */
+        void trim();
+    public:
+        /// Default capacity, in runs
+        static constexpr std::size_t DEFAULT_CAPACITY = 4096;
+
+        /**
+        * Constructs an empty cache with the default capacity.
+        */
+        ShapeCache();
+
+        /**
+        * Looks up a run, and marks it as recently used.
+        * @param [in] face Identifies the face
+        * @param [in] size Pixel size of the face
+        * @param [in] codepoints The codepoints of the run
+        * @param [in] count The number of codepoints
+        * @param [out] run The shaped run, if it was found
+        * @return `true` if the run was found
+        */
+        bool find(const std::string &face, unsigned int size, const char_t *codepoints, std::size_t count, run_t &run);
+        /**
+        * Adds a run, evicting others if necessary.
+        * If the run is already cached, it's replaced.
+        * @param [in] k The run
+        * @param [in] run The shaped run
+        */
+        void insert(const key &k, const run_t &run);
+
+        /**
+        * Sets the max number of runs to keep.
+        * @param [in] runs The capacity
+        */
+        void setCapacity(std::size_t runs);
+        /**
+        * Evicts all runs.
+        * @note The counters are not reset
+        */
+        void clear();
+        /**
+        * Gets the usage counters.
+        * @return A copy of the counters
+        */
+        stats getStats() const;
+    };
+}
+
+#endif
@@ -0,0 +1,147 @@
+#include "StreamBuffer.h"
+
+#include <cstring>
+
+#include "GLState.h"
+
+/// Regions are kept to a multiple of this, so that
+/// offsets into the buffer are always well aligned
+static constexpr std::size_t REGION_ALIGN = 256;
+/// How long to wait on a fence before checking again, in nanoseconds
+static constexpr GLuint64 WAIT_TIMEOUT = 1000000000;
+
+etm::StreamBuffer::StreamBuffer():
+    buffer(0),
+    regionSize(0),
+    region(REGIONS - 1)
+{
+    for (GLsync &f : fences) {
+        f = nullptr;
+    }
+    glGenBuffers(1, &buffer);
+}
+
+etm::StreamBuffer::~StreamBuffer() {
+    free();
+}
+
+etm::StreamBuffer::StreamBuffer(StreamBuffer &&other) {
+    steal(other);
+}
+etm::StreamBuffer &etm::StreamBuffer::operator=(StreamBuffer &&other) {
+    free();
+    steal(other);
+    return *this;
+}
+
+void etm::StreamBuffer::steal(StreamBuffer &other) {
+    buffer = other.buffer;
+    regionSize = other.regionSize;
+    region = other.region;
+    for (int i = 0; i < REGIONS; i++) {
+        fences[i] = other.fences[i];
+        other.fences[i] = nullptr;
+    }
+    other.buffer = 0;
+    other.regionSize = 0;
+}
+
+void etm::StreamBuffer::clearFence(int index) {
+    if (fences[index] != nullptr) {
+        glDeleteSync(fences[index]);
+        fences[index] = nullptr;
+    }
+}
+
+void etm::StreamBuffer::free() {
+    // If `buffer` is zero, signals that it was moved.
+    if (buffer) {
+        for (int i = 0; i < REGIONS; i++) {
+            clearFence(i);
+        }
+        if (GLState *state = GLState::current()) {
+            state->forgetBuffer(buffer);
+        }
+        glDeleteBuffers(1, &buffer);
+        buffer = 0;
+    }
+}
+
+void etm::StreamBuffer::wait(int index) {
+    if (fences[index] == nullptr) {
+        return;
+    }
+    // Only the first wait needs to flush, after that
+    // the fence is guaranteed to be on its way
+    GLbitfield flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+    GLenum result;
+    do {
+        result = glClientWaitSync(fences[index], flags, WAIT_TIMEOUT);
+        flags = 0;
+    } while (result == GL_TIMEOUT_EXPIRED);
+    // GL_WAIT_FAILED means a GL error, and there isn't much
+    // to be done about it other than carry on
+    clearFence(index);
+}
+
+void etm::StreamBuffer::bind() const {
+    if (GLState *state = GLState::current()) {
+        state->bindArrayBuffer(buffer);
+    } else {
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    }
+}
+
+std::size_t etm::StreamBuffer::write(const void *data, std::size_t size) {
+    bind();
+    region = (region + 1) % REGIONS;
+
+    if (size > regionSize) {
+        // Orphan the old storage; the driver will keep it alive
+        // for as long as the GPU is still using it, so there's no
+        // need to wait on the fences.
+        for (int i = 0; i < REGIONS; i++) {
+            clearFence(i);
+        }
+        std::size_t newSize = regionSize ? regionSize : REGION_ALIGN;
+        while (newSize < size) {
+            newSize *= 2;
+        }
+        regionSize = newSize;
+        region = 0;
+        glBufferData(GL_ARRAY_BUFFER, regionSize * REGIONS, nullptr, GL_STREAM_DRAW);
+    } else {
+        wait(region);
+    }
+
+    const std::size_t offset = region * regionSize;
+    if (size == 0) {
+        return offset;
+    }
+
+    // The fence guarantees that the GPU is done with the region,
+    // so there's no need for the driver to synchronize.
+    void *dest = glMapBufferRange(
+        GL_ARRAY_BUFFER, offset, size,
+        GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT
+    );
+    if (dest != nullptr) {
+        std::memcpy(dest, data, size);
+        // If false, the data store was corrupted while it was mapped
+        // (ex. a mode change), and must be written again.
+        if (glUnmapBuffer(GL_ARRAY_BUFFER) == GL_TRUE) {
+            return offset;
+        }
+    }
+    glBufferSubData(GL_ARRAY_BUFFER, offset, size, data);
+    return offset;
+}
+
+void etm::StreamBuffer::fence() {
+    clearFence(region);
+    fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+unsigned int etm::StreamBuffer::get() const {
+    return buffer;
+}
@@ -0,0 +1,114 @@
+#ifndef ETERMAL_STREAMBUFFER_H_INCLUDED
+#define ETERMAL_STREAMBUFFER_H_INCLUDED
+
+#include <cstddef>
+
+#include "opengl.h"
+
+namespace etm {
+
+    /**
+    * An array buffer for data that is rewritten every frame,
+    * like per-glyph instance data.
+    * The buffer is split into @ref REGIONS regions, and each
+    * frame writes into the next one, so that the CPU can fill
+    * a region while the GPU is still reading from the previous ones.
+    * Once the frame's draw calls have been issued, @ref fence()
+    * inserts a sync object for the region, which is waited on
+    * before the region is reused three frames later.
+    * Because the fences guarantee that the GPU is done with the region,
+    * it can be mapped unsynchronized, which avoids the implicit
+    * stall (or copy) that glBufferSubData can cause.
+    * If the data outgrows the regions, the buffer is orphaned
+    * and reallocated.
+    * @note All GL objects are created in the current context,
+    * and must be used in that same context.
+    * @see Buffer
+    */
+    class StreamBuffer {
+    public:
+        /// Number of regions that the buffer is split into
+        static constexpr int REGIONS = 3;
+    private:
+        /// The array buffer
+        unsigned int buffer;
+        /// Size of each region, in bytes
+        std::size_t regionSize;
+        /// The region that was written to last
+        int region;
+        /// Fences for each region, null if the region is
+        /// free to be written to
+        GLsync fences[REGIONS];
+
+        /**
+        * Take the resources of another object.
+        * @param [in,out] other The object to steal from
+        */
+        void steal(StreamBuffer &other);
+        /**
+        * Delete the fence of the given region, if it has one.
+        * @param [in] index The region
+        */
+        void clearFence(int index);
+        /**
+        * Releases the buffer and fences.
+        */
+        void free();
+        /**
+        * Wait for the GPU to finish reading from the given region.
+        * @param [in] index The region
+        */
+        void wait(int index);
+    public:
+        /**
+        * Construct a stream buffer.
+        * @note Creates the OpenGL buffer in the current context.
+        */
+        StreamBuffer();
+        /**
+        * Destroys the buffer and fences, if not moved.
+        */
+        ~StreamBuffer();
+        /**
+        * Initialize with moved object.
+        * @param [in,out] other Target object
+        */
+        StreamBuffer(StreamBuffer &&other);
+        /**
+        * Move object into `*this`.
+        * @param [in,out] other Target object
+        */
+        StreamBuffer &operator=(StreamBuffer &&other);
+
+        /**
+        * Bind the array buffer.
+        */
+        void bind() const;
+
+        /**
+        * Write data into the next region.
+        * The buffer is left bound.
+        * If the data doesn't fit, the buffer is grown first.
+        * @param [in] data The data
+        * @param [in] size Size of the data, in bytes
+        * @return Offset of the data within the buffer, in bytes
+        */
+        std::size_t write(const void *data, std::size_t size);
+
+        /**
+        * Mark the end of the draw calls that read from
+        * the last written region.
+        * Must be called after every @ref write(const void *data, std::size_t size)
+        * once the data is no longer needed.
+        */
+        void fence();
+
+        /**
+        * Get the buffer.
+        * @return The OpenGL buffer id
+        */
+        unsigned int get() const;
+    };
+}
+
+#endif
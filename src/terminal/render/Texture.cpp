@@ -3,6 +3,7 @@
 #include <string>
 
 #include "opengl.h"
+#include "GLState.h"
 
 // In-use enum values for Texture.
 // def'd to be extra safe.
@@ -36,6 +37,9 @@ void etm::Texture::init(const tparam &params) {
 }
 
 void etm::Texture::deInit() {
+    if (GLState *state = GLState::current()) {
+        state->forgetTexture(buffer);
+    }
     glDeleteTextures(1, &buffer);
 }
 
@@ -57,7 +61,11 @@ unsigned int etm::Texture::get() {
 }
 
 void etm::Texture::bind() const {
-    glBindTexture(TEXTURE_TYPE, buffer);
+    if (GLState *state = GLState::current()) {
+        state->bindTexture(buffer);
+    } else {
+        glBindTexture(TEXTURE_TYPE, buffer);
+    }
 }
 
 void etm::Texture::setData(int format, unsigned int width, unsigned int height, const data_t *data) {
@@ -0,0 +1,127 @@
+#include "Cell.h"
+
+#include <algorithm>
+#include <cstddef>
+
+#include "../render/opengl.h"
+#include "../Resources.h"
+
+// Names of uniforms (for lookup)
+static const char *FRAME = "Frame";
+static const char *SAMPLER0 = "Tex";
+static const char *DISTANCE_FIELD = "distanceField";
+
+// Shaders compiled into a single header to enable embedding
+#include "../../../resources/shaders/cell.h"
+
+etm::shader::Cell::Cell(Resources *res):
+    Shader(res, cell_vert, cell_vert_len, cell_frag, cell_frag_len),
+    res(res),
+    frameBuffer(0),
+    distanceFieldLocation(glGetUniformLocation(get(), DISTANCE_FIELD)),
+    distanceField(false)
+{
+    use();
+    glUniform1i(glGetUniformLocation(get(), SAMPLER0), 0);
+    glUniform1i(distanceFieldLocation, 0);
+    glUniformBlockBinding(get(), glGetUniformBlockIndex(get(), FRAME), FRAME_BINDING);
+
+    std::fill(std::begin(frame), std::end(frame), 0.0f);
+    GLint prevBuffer;
+    glGetIntegerv(GL_UNIFORM_BUFFER_BINDING, &prevBuffer);
+    glGenBuffers(1, &frameBuffer);
+    glBindBuffer(GL_UNIFORM_BUFFER, frameBuffer);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(frame), frame, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, prevBuffer);
+}
+etm::shader::Cell::~Cell() {
+    if (frameBuffer) {
+        glDeleteBuffers(1, &frameBuffer);
+    }
+}
+
+void etm::shader::Cell::setFrame(float cellWidth, float cellHeight, float viewportWidth, float viewportHeight, float originX, float originY) {
+    // std140: three vec2s, padded to a vec4
+    const float values[8] = {
+        cellWidth, cellHeight,
+        viewportWidth, viewportHeight,
+        originX, originY,
+        0.0f, 0.0f
+    };
+    glBindBufferBase(GL_UNIFORM_BUFFER, FRAME_BINDING, frameBuffer);
+    if (!std::equal(std::begin(values), std::end(values), std::begin(frame))) {
+        std::copy(std::begin(values), std::end(values), std::begin(frame));
+        glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(frame), frame);
+    }
+}
+
+void etm::shader::Cell::setDistanceField(bool value) {
+    if (distanceField != value) {
+        distanceField = value;
+        glUniform1i(distanceFieldLocation, value);
+    }
+}
+
+void etm::shader::Cell::enableInstances() {
+    for (unsigned int attrib : {CELL_ATTRIBUTE, BACK_ATTRIBUTE, FORE_ATTRIBUTE, GLYPH_ATTRIBUTE}) {
+        glEnableVertexAttribArray(attrib);
+        // Advance once per instance rather than once per vertex
+        glVertexAttribDivisor(attrib, 1);
+    }
+}
+
+void etm::shader::Cell::setInstances(std::size_t offset) {
+    // GL 3.3 has no base instance for instanced draws,
+    // so the pointers themselves have to be moved.
+    constexpr GLsizei stride = sizeof(instance);
+    glVertexAttribIPointer(CELL_ATTRIBUTE, 3, GL_INT, stride, (void*)(offset + offsetof(instance, column)));
+    glVertexAttribPointer(BACK_ATTRIBUTE, 3, GL_FLOAT, GL_FALSE, stride, (void*)(offset + offsetof(instance, back)));
+    glVertexAttribPointer(FORE_ATTRIBUTE, 3, GL_FLOAT, GL_FALSE, stride, (void*)(offset + offsetof(instance, fore)));
+    glVertexAttribPointer(GLYPH_ATTRIBUTE, 4, GL_FLOAT, GL_FALSE, stride, (void*)(offset + offsetof(instance, glyph)));
+}
+
+etm::shader::uniform_t etm::shader::Cell::getModel() const {
+    res->postError(
+        "etm::shader::Cell::getModel()",
+        "Cell shader does not have a model uniform!\n"
+        "Cell shader has been erroniously set.\n"
+        "This is a bug.",
+        0,
+        true
+    );
+    return -1;
+}
+etm::shader::uniform_t etm::shader::Cell::getColor() const {
+    res->postError(
+        "etm::shader::Cell::getColor()",
+        "Cell shader does not have a color uniform!\n"
+        "Cell shader has been erroniously set.\n"
+        "This is a bug.",
+        0,
+        true
+    );
+    return -1;
+}
+
+etm::shader::uniform_t etm::shader::Cell::getBackGColor() const {
+    res->postError(
+        "etm::shader::Cell::getBackGColor()",
+        "Cell shader does not have a background color uniform!\n"
+        "Colors are per-instance attributes.\n"
+        "This is a bug.",
+        0,
+        true
+    );
+    return -1;
+}
+etm::shader::uniform_t etm::shader::Cell::getForeGColor() const {
+    res->postError(
+        "etm::shader::Cell::getForeGColor()",
+        "Cell shader does not have a foreground color uniform!\n"
+        "Colors are per-instance attributes.\n"
+        "This is a bug.",
+        0,
+        true
+    );
+    return -1;
+}
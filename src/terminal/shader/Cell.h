@@ -0,0 +1,149 @@
+#ifndef ETERMAL_SHADER_CELL_H_INCLUDED
+#define ETERMAL_SHADER_CELL_H_INCLUDED
+
+#include <cstddef>
+
+#include "Shader.h"
+
+namespace etm { class Resources; }
+
+namespace etm::shader {
+
+    /**
+    * Text cell shader interface.
+    * Renders single channel textures (GL_RED) like @ref Text,
+    * except that instead of taking a model matrix for every glyph,
+    * the quad is placed in the vertex shader from an integer
+    * column/row attribute and a per-frame uniform block holding
+    * the cell size, viewport size and scroll offset.
+    * This means that no matrix math has to be done for each glyph,
+    * and scrolling only changes the uniform block.
+    * The cell position and colors are per-instance attributes,
+    * so every cell that shares a glyph can be drawn with a single
+    * instanced draw call - or every cell at once, if the font keeps
+    * its glyphs in an atlas.
+    * @see ../../../resources/shaders/cell.vert
+    * @see ../../../resources/shaders/cell.frag
+    * @see Text
+    */
+    class Cell: public Shader {
+        /// Handle to a @ref Resources object.
+        /// Used for error reporting.
+        Resources *res;
+        /// The buffer backing the shader's `Frame` uniform block
+        unsigned int frameBuffer;
+        /// The values last written to @ref frameBuffer,
+        /// in std140 layout
+        float frame[8];
+        /// Location of the shader's distance field toggle
+        uniform_t distanceFieldLocation;
+        /// The value last given to the distance field toggle
+        bool distanceField;
+    public:
+        /**
+        * The per-instance data of a single cell,
+        * as it's laid out in the instance buffer.
+        */
+        struct instance {
+            /// Column of the cell
+            int column;
+            /// Row of the cell
+            int row;
+            /// Number of columns the cell spans, 2 for wide chars
+            int span;
+            /// Background color, RGB
+            float back[3];
+            /// Foreground color, RGB
+            float fore[3];
+            /// Left, bottom, right and top texture coordinates of the glyph
+            /// @see EtmFont::getGlyphRegion(char_t c, float *region)
+            float glyph[4];
+        };
+
+        /// The uniform buffer binding point used for the `Frame` block
+        static constexpr unsigned int FRAME_BINDING = 0;
+        /// The vertex attribute location of the cell column/row/span
+        static constexpr unsigned int CELL_ATTRIBUTE = 2;
+        /// The vertex attribute location of the background color
+        static constexpr unsigned int BACK_ATTRIBUTE = 3;
+        /// The vertex attribute location of the foreground color
+        static constexpr unsigned int FORE_ATTRIBUTE = 4;
+        /// The vertex attribute location of the glyph's texture coordinates
+        static constexpr unsigned int GLYPH_ATTRIBUTE = 5;
+
+        /**
+        * Construct a cell shader with a @ref Resources
+        * object to report errors to.
+        * @param [in] res Resources object to report errors to
+        */
+        Cell(Resources *res);
+        /**
+        * Releases the uniform buffer.
+        */
+        ~Cell();
+
+        /**
+        * Sets the values shared by every cell in a frame,
+        * and binds the uniform buffer.
+        * The buffer is only written to if the values actually changed.
+        * @note The shader must be in use
+        * @param [in] cellWidth Pixel width of each cell
+        * @param [in] cellHeight Pixel height of each cell
+        * @param [in] viewportWidth Pixel width of the viewport
+        * @param [in] viewportHeight Pixel height of the viewport
+        * @param [in] originX Pixel x of the left of column 0
+        * @param [in] originY Pixel y of the top of row 0, ex. minus the scroll offset
+        */
+        void setFrame(float cellWidth, float cellHeight, float viewportWidth, float viewportHeight, float originX, float originY);
+        /**
+        * Sets whether the glyph textures are signed distance fields.
+        * Only uploaded if it changed.
+        * @note The shader must be in use
+        * @param [in] value `true` for distance fields
+        * @see EtmFont::isDistanceField()
+        */
+        void setDistanceField(bool value);
+        /**
+        * Enables the per-instance attributes on the
+        * currently bound vertex array object.
+        * Only needs to be done once for each vertex array.
+        * @see setInstances(std::size_t offset)
+        */
+        static void enableInstances();
+        /**
+        * Points the per-instance attributes at an array of
+        * @ref instance in the currently bound array buffer.
+        * The vertex array must have been set up with
+        * @ref enableInstances()
+        * @param [in] offset Byte offset of the first instance
+        */
+        static void setInstances(std::size_t offset);
+
+        /**
+        * @warning Will fail, as Cell has no such uniform.
+        * An error will be reported to @ref res.
+        * @return -1
+        */
+        uniform_t getModel() const override;
+        /**
+        * @warning Will fail, as Cell has no such uniform.
+        * An error will be reported to @ref res.
+        * @return -1
+        */
+        uniform_t getColor() const override;
+        /**
+        * @warning Will fail, as Cell takes colors per instance.
+        * An error will be reported to @ref res.
+        * @return -1
+        */
+        uniform_t getForeGColor() const override;
+        /**
+        * @warning Will fail, as Cell takes colors per instance.
+        * An error will be reported to @ref res.
+        * @return -1
+        */
+        uniform_t getBackGColor() const override;
+    };
+}
+
+#endif
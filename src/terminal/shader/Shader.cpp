@@ -4,6 +4,7 @@
 #include <fstream>
 
 #include "../render/opengl.h"
+#include "../render/GLState.h"
 #include "../Resources.h"
 
 etm::shader::Shader::State::State() {
@@ -73,12 +74,19 @@ etm::shader::Shader::~Shader() {
 }
 void etm::shader::Shader::free() {
     if (shader) {
+        if (GLState *state = GLState::current()) {
+            state->forgetProgram(shader);
+        }
         glDeleteProgram(shader);
     }
 }
 
 void etm::shader::Shader::use() const {
-    glUseProgram(shader);
+    if (GLState *state = GLState::current()) {
+        state->useProgram(shader);
+    } else {
+        glUseProgram(shader);
+    }
 }
 
 etm::shader::Shader::shader_program_t etm::shader::Shader::get() const {
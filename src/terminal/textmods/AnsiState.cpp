@@ -0,0 +1,70 @@
+#include "AnsiState.h"
+
+#include <cstdio>
+#include <cstring>
+
+#include "../render/Color.h"
+
+etm::tm::AnsiState::AnsiState(const sink_t &sink):
+    sink(&sink), back(nullptr), fore(nullptr), muted(false) {
+}
+
+void etm::tm::AnsiState::write(const char *str) {
+    (*sink)(str, std::strlen(str));
+}
+
+void etm::tm::AnsiState::writeColor(int code, const Color &color) {
+    const Color::hex_t hex = color.getHex();
+    char buffer[32];
+    const int size = std::snprintf(
+        buffer, sizeof(buffer), "\x1b[%d;2;%u;%u;%um", code,
+        (hex >> 16) & 0xFF, (hex >> 8) & 0xFF, hex & 0xFF
+    );
+    (*sink)(buffer, size);
+}
+
+void etm::tm::AnsiState::setDefBack() {
+    if (!muted && back != nullptr) {
+        write("\x1b[49m");
+    }
+    back = nullptr;
+}
+void etm::tm::AnsiState::setDefFore() {
+    if (!muted && fore != nullptr) {
+        write("\x1b[39m");
+    }
+    fore = nullptr;
+}
+void etm::tm::AnsiState::setBack(const Color &color) {
+    back = &color;
+    if (!muted) {
+        writeColor(48, color);
+    }
+}
+void etm::tm::AnsiState::setFore(const Color &color) {
+    fore = &color;
+    if (!muted) {
+        writeColor(38, color);
+    }
+}
+
+void etm::tm::AnsiState::setMuted(bool value) {
+    muted = value;
+}
+
+void etm::tm::AnsiState::writeCurrent() {
+    if (back != nullptr) {
+        writeColor(48, *back);
+    }
+    if (fore != nullptr) {
+        writeColor(38, *fore);
+    }
+}
+
+void etm::tm::AnsiState::reset() {
+    if (back != nullptr || fore != nullptr) {
+        write("\x1b[0m");
+        back = nullptr;
+        fore = nullptr;
+    }
+}
@@ -0,0 +1,103 @@
+#ifndef ETERMAL_TM_ANSISTATE_H_INCLUDED
+#define ETERMAL_TM_ANSISTATE_H_INCLUDED
+
+#include <functional>
+#include <cstddef>
+
+#include "TextState.h"
+
+// ../render/Color
+namespace etm { class Color; }
+
+namespace etm::tm {
+
+    /**
+    * TextState implementation that translates style changes
+    * into standard ANSI (24 bit color) escape sequences,
+    * used when exporting text with styling.
+    * The terminal defaults are mapped to the ANSI defaults
+    * (39 and 49), so that the exported text is shown in the
+    * reader's own colors.
+    * @see TextBuffer::exportText()
+    */
+    class AnsiState: public TextState {
+    public:
+        /// Receives the escape sequences
+        typedef std::function<void(const char *data, std::size_t size)> sink_t;
+    private:
+        /// Where the escapes are written
+        const sink_t *sink;
+        /// The current background, nullptr if default
+        const Color *back;
+        /// The current foreground, nullptr if default
+        const Color *fore;
+        /// If `true`, changes are tracked but not written
+        /// @see setMuted(bool value)
+        bool muted;
+
+        /**
+        * Write an SGR sequence for a color.
+        * @param [in] code 38 for foreground, 48 for background
+        * @param [in] color The color
+        */
+        void writeColor(int code, const Color &color);
+        /**
+        * Write a raw string to the @ref sink.
+        * @param [in] str Null terminated string
+        */
+        void write(const char *str);
+    public:
+        /**
+        * Constructs an AnsiState with default colors.
+        * @warning Keeps a pointer to `sink`
+        * @param [in] sink The output
+        */
+        AnsiState(const sink_t &sink);
+
+        /**
+        * Reverts to the default background (`ESC[49m`).
+        */
+        void setDefBack() override;
+        /**
+        * Reverts to the default foreground (`ESC[39m`).
+        */
+        void setDefFore() override;
+        /**
+        * Sets a 24 bit background color (`ESC[48;2;r;g;bm`).
+        * @warning Takes a pointer to the color data,
+        * so the given color object must stay allocated until the
+        * background changes again.
+        * @param [in] color The color to set
+        */
+        void setBack(const Color &color) override;
+        /**
+        * Sets a 24 bit foreground color (`ESC[38;2;r;g;bm`).
+        * @warning Takes a pointer to the color data,
+        * so the given color object must stay allocated until the
+        * foreground changes again.
+        * @param [in] color The color to set
+        */
+        void setFore(const Color &color) override;
+
+        /**
+        * Set whether changes should be written.
+        * Useful when catching up to the state at some
+        * point in the text, without writing anything.
+        * @param [in] value `true` to stop writing
+        * @see writeCurrent()
+        */
+        void setMuted(bool value);
+        /**
+        * Writes the escapes needed to get from the default
+        * style to the current one.
+        */
+        void writeCurrent();
+        /**
+        * Writes a reset sequence if the current style
+        * isn't the default one.
+        */
+        void reset();
+    };
+}
+
+#endif
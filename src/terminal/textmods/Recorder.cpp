@@ -0,0 +1,55 @@
+#include "Recorder.h"
+
+etm::tm::Recorder::Recorder():
+    back(Restyle::KEEP), fore(Restyle::KEEP) {
+}
+etm::tm::Recorder::Recorder(Restyle::action back, const Color &backColor, Restyle::action fore, const Color &foreColor):
+    back(back), backColor(backColor), fore(fore), foreColor(foreColor) {
+}
+
+void etm::tm::Recorder::setDefBack() {
+    back = Restyle::DEFAULT;
+}
+void etm::tm::Recorder::setDefFore() {
+    fore = Restyle::DEFAULT;
+}
+void etm::tm::Recorder::setBack(const Color &color) {
+    back = Restyle::SET;
+    backColor = color;
+}
+void etm::tm::Recorder::setFore(const Color &color) {
+    fore = Restyle::SET;
+    foreColor = color;
+}
+
+etm::tm::Restyle::action etm::tm::Recorder::getBack() const {
+    return back;
+}
+const etm::Color &etm::tm::Recorder::getBackColor() const {
+    return backColor;
+}
+etm::tm::Restyle::action etm::tm::Recorder::getFore() const {
+    return fore;
+}
+const etm::Color &etm::tm::Recorder::getForeColor() const {
+    return foreColor;
+}
+
+std::shared_ptr<etm::tm::Mod> etm::tm::Recorder::makeMod() const {
+    if (fore == Restyle::KEEP) {
+        if (back == Restyle::SET) {
+            return std::make_shared<Background>(backColor);
+        } else if (back == Restyle::DEFAULT) {
+            return std::make_shared<RevBackground>();
+        }
+    } else if (back == Restyle::KEEP) {
+        if (fore == Restyle::SET) {
+            return std::make_shared<Foreground>(foreColor);
+        } else {
+            return std::make_shared<RevForeground>();
+        }
+    } else if (back == Restyle::DEFAULT && fore == Restyle::DEFAULT) {
+        return std::make_shared<Revert>();
+    }
+    return std::make_shared<Restyle>(back, backColor, fore, foreColor);
+}
@@ -0,0 +1,94 @@
+#ifndef ETERMAL_TM_RECORDER_H_INCLUDED
+#define ETERMAL_TM_RECORDER_H_INCLUDED
+
+#include <memory>
+
+#include "TextState.h"
+#include "mods.h"
+#include "../render/Color.h"
+
+namespace etm::tm {
+
+    /**
+    * TextState implementation that records the net effect
+    * of running one or more @ref Mod "mods", so that they
+    * can be saved and later re-created.
+    * @see Restyle
+    * @see TextBuffer::save()
+    */
+    class Recorder: public TextState {
+        /// What was done to the background
+        Restyle::action back;
+        /// The last background color set
+        Color backColor;
+        /// What was done to the foreground
+        Restyle::action fore;
+        /// The last foreground color set
+        Color foreColor;
+    public:
+        /**
+        * Constructs a recorder that hasn't recorded anything.
+        */
+        Recorder();
+        /**
+        * Constructs a recorder with a recorded effect,
+        * ex. one that was loaded from a file.
+        * @param [in] back What was done to the background
+        * @param [in] backColor The background color, if `back` is SET
+        * @param [in] fore What was done to the foreground
+        * @param [in] foreColor The foreground color, if `fore` is SET
+        */
+        Recorder(Restyle::action back, const Color &backColor, Restyle::action fore, const Color &foreColor);
+
+        /**
+        * Records a revert of the background.
+        */
+        void setDefBack() override;
+        /**
+        * Records a revert of the foreground.
+        */
+        void setDefFore() override;
+        /**
+        * Records a change in the background.
+        * @param [in] color The color
+        */
+        void setBack(const Color &color) override;
+        /**
+        * Records a change in the foreground.
+        * @param [in] color The color
+        */
+        void setFore(const Color &color) override;
+
+        /**
+        * Gets what was done to the background.
+        * @return The action
+        */
+        Restyle::action getBack() const;
+        /**
+        * Gets the background color that was set.
+        * @return The color, only meaningful if @ref getBack() is SET
+        */
+        const Color &getBackColor() const;
+        /**
+        * Gets what was done to the foreground.
+        * @return The action
+        */
+        Restyle::action getFore() const;
+        /**
+        * Gets the foreground color that was set.
+        * @return The color, only meaningful if @ref getFore() is SET
+        */
+        const Color &getForeColor() const;
+
+        /**
+        * Creates a mod with the same effect as what was recorded.
+        * Where possible, this is one of the regular mods
+        * (ex. @ref Background, @ref Revert); everything
+        * else becomes a @ref Restyle.
+        * @return The mod
+        */
+        std::shared_ptr<Mod> makeMod() const;
+    };
+}
+
+#endif
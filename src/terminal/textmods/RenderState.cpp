@@ -2,16 +2,18 @@
 
 #include "../render/Color.h"
 
-etm::tm::RenderState::RenderState(shader::Shader &shaderP, const Color &defBackgroundColorP, const Color &defForegroundColorP, bool startInverted):
-    shader(&shaderP),
+etm::tm::RenderState::RenderState(shader::Shader *shaderP, const Color &defBackgroundColorP, const Color &defForegroundColorP, bool startInverted):
+    shader(shaderP),
     backgroundColor(&defBackgroundColorP),
     defBackgroundColor(&defBackgroundColorP),
     foregroundColor(&defForegroundColorP),
     defForegroundColor(&defForegroundColorP),
     inverted(false)
 {
-    backgroundColor->setBackground(*shader);
-    foregroundColor->setForeground(*shader);
+    if (shader != nullptr) {
+        backgroundColor->setBackground(*shader);
+        foregroundColor->setForeground(*shader);
+    }
     setInverted(startInverted);
 }
 
@@ -24,11 +26,15 @@ void etm::tm::RenderState::setDefFore() {
 
 void etm::tm::RenderState::doSetBack(const Color &color) {
     backgroundColor = &color;
-    backgroundColor->setBackground(*shader);
+    if (shader != nullptr) {
+        backgroundColor->setBackground(*shader);
+    }
 }
 void etm::tm::RenderState::doSetFore(const Color &color) {
     foregroundColor = &color;
-    foregroundColor->setForeground(*shader);
+    if (shader != nullptr) {
+        foregroundColor->setForeground(*shader);
+    }
 }
 void etm::tm::RenderState::setBack(const Color &color) {
     if (!inverted) {
@@ -53,3 +59,10 @@ void etm::tm::RenderState::setInverted(bool val) {
         doSetFore(*tmp);
     }
 }
+
+const etm::Color &etm::tm::RenderState::getBack() const {
+    return *backgroundColor;
+}
+const etm::Color &etm::tm::RenderState::getFore() const {
+    return *foregroundColor;
+}
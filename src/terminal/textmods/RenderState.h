@@ -22,7 +22,8 @@ namespace etm::tm {
     */
     class RenderState: public TextState {
         /// The shader in which back/foreground
-        /// uniform data is stored
+        /// uniform data is stored.
+        /// If null, the colors are only tracked.
         shader::Shader *shader;
         /// The current background color
         const Color *backgroundColor;
@@ -55,7 +56,16 @@ namespace etm::tm {
         */
         void doSetFore(const Color &color);
     public:
-        RenderState(shader::Shader &shader, const Color &defBackgroundColor, const Color &defForegroundColor, bool startInverted);
+        /**
+        * Construct a render state.
+        * @param [in] shader The shader to load the colors into,
+        * or `nullptr` if they should only be tracked, ex. because
+        * they are passed to the shader some other way
+        * @param [in] defBackgroundColor The default background color
+        * @param [in] defForegroundColor The default foreground color
+        * @param [in] startInverted Whether the colors start off inverted
+        */
+        RenderState(shader::Shader *shader, const Color &defBackgroundColor, const Color &defForegroundColor, bool startInverted);
 
         /**
         * Set default background color as the background.
@@ -99,6 +109,19 @@ namespace etm::tm {
         * @param [in] val `true` if the colors should be swapped
         */
         void setInverted(bool val);
+
+        /**
+        * Get the current background color,
+        * after inversion.
+        * @return The background color
+        */
+        const Color &getBack() const;
+        /**
+        * Get the current foreground color,
+        * after inversion.
+        * @return The foreground color
+        */
+        const Color &getFore() const;
     };
 }
 
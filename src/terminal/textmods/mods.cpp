@@ -32,3 +32,19 @@ void etm::tm::Revert::run(TextState &state) {
     state.setDefBack();
     state.setDefFore();
 }
+
+etm::tm::Restyle::Restyle(action back, const Color &backColor, action fore, const Color &foreColor):
+    back(back), backColor(backColor), fore(fore), foreColor(foreColor) {
+}
+void etm::tm::Restyle::run(TextState &state) {
+    if (back == DEFAULT) {
+        state.setDefBack();
+    } else if (back == SET) {
+        state.setBack(backColor);
+    }
+    if (fore == DEFAULT) {
+        state.setDefFore();
+    } else if (fore == SET) {
+        state.setFore(foreColor);
+    }
+}
@@ -97,6 +97,49 @@ namespace etm::tm {
         void run(TextState &state) override;
     };
 
+    /**
+    * Applies an arbitrary change to the background and/or foreground
+    * of the @ref TextState.
+    * Used when restoring a mod whose effect doesn't match any of
+    * the others.
+    * @see Recorder
+    */
+    class Restyle: public Mod {
+    public:
+        /// What to do with a color
+        enum action {
+            /// Leave it as it is
+            KEEP,
+            /// Revert it to the default
+            DEFAULT,
+            /// Change it
+            SET
+        };
+    private:
+        /// What to do with the background
+        action back;
+        /// The background color, if @ref back is SET
+        Color backColor;
+        /// What to do with the foreground
+        action fore;
+        /// The foreground color, if @ref fore is SET
+        Color foreColor;
+    public:
+        /**
+        * Constructs a Restyle mod.
+        * @param [in] back What to do with the background
+        * @param [in] backColor The background color, if `back` is SET
+        * @param [in] fore What to do with the foreground
+        * @param [in] foreColor The foreground color, if `fore` is SET
+        */
+        Restyle(action back, const Color &backColor, action fore, const Color &foreColor);
+        /**
+        * Applies the changes to the state
+        * @param [out] state The state to modify
+        */
+        void run(TextState &state) override;
+    };
+
 }
 
 #endif
@@ -35,4 +35,17 @@ void etm::IdList<T>::clear() {
     indexOffset = 0;
 }
 
+template<class T>
+typename etm::IdList<T>::id_t etm::IdList<T>::getOffset() {
+    return indexOffset;
+}
+template<class T>
+void etm::IdList<T>::setOffset(id_t offset) {
+    indexOffset = offset;
+}
+template<class T>
+typename etm::IdList<T>::id_t etm::IdList<T>::size() {
+    return container.size();
+}
+
 template class etm::IdList<std::shared_ptr<etm::tm::Mod>>;
@@ -69,6 +69,26 @@ namespace etm {
         * Erase all elements and zero the @ref indexOffset.
         */
         void clear();
+
+        /**
+        * Gets the ID of the first element, aka the @ref indexOffset.
+        * @return The ID
+        * @see setOffset(id_t offset)
+        */
+        id_t getOffset();
+        /**
+        * Sets the ID that the next added element will get.
+        * @note Only meaningful when the list is empty,
+        * ex. when restoring a list that was saved along with its IDs
+        * @param [in] offset The new @ref indexOffset
+        * @see getOffset()
+        */
+        void setOffset(id_t offset);
+        /**
+        * Gets the number of elements.
+        * @return The element count
+        */
+        id_t size();
     };
 }
 
@@ -0,0 +1,130 @@
+#include "MappedFile.h"
+
+#include <fstream>
+#include <cerrno>
+#include <cstring>
+
+#ifdef _WIN32
+#   define WIN32_LEAN_AND_MEAN
+#   include <windows.h>
+#else
+#   include <sys/mman.h>
+#   include <sys/stat.h>
+#   include <fcntl.h>
+#   include <unistd.h>
+#endif
+
+etm::MappedFile::MappedFile():
+    mData(nullptr), mSize(0), mapped(false),
+    handle(nullptr), mapHandle(nullptr) {
+}
+etm::MappedFile::~MappedFile() {
+    close();
+}
+
+bool etm::MappedFile::readAll(const std::string &path) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.good()) {
+        error = "Failed to open \"" + path + "\"";
+        return false;
+    }
+    std::streamsize size = file.tellg();
+    file.seekg(0);
+    buffer.resize(size > 0 ? static_cast<std::size_t>(size) : 0);
+    if (buffer.size() && !file.read(buffer.data(), size)) {
+        error = "Failed to read \"" + path + "\"";
+        buffer.clear();
+        return false;
+    }
+    mData = buffer.size() ? buffer.data() : nullptr;
+    mSize = buffer.size();
+    return true;
+}
+
+bool etm::MappedFile::open(const std::string &path) {
+    close();
+    error.clear();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(
+        path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL
+    );
+    if (file == INVALID_HANDLE_VALUE) {
+        error = "Failed to open \"" + path + "\"";
+        return false;
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        CloseHandle(file);
+        // Empty files can't be mapped
+        return readAll(path);
+    }
+    HANDLE map = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    const void *view = map ? MapViewOfFile(map, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (view == nullptr) {
+        if (map) {
+            CloseHandle(map);
+        }
+        CloseHandle(file);
+        return readAll(path);
+    }
+    handle = file;
+    mapHandle = map;
+    mData = static_cast<const char*>(view);
+    mSize = static_cast<std::size_t>(size.QuadPart);
+    mapped = true;
+    return true;
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd == -1) {
+        error = "Failed to open \"" + path + "\": " + std::strerror(errno);
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) == -1 || info.st_size == 0) {
+        ::close(fd);
+        // Empty files (and odd ones that won't stat) can't be mapped
+        return readAll(path);
+    }
+    void *view = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping stays valid after the descriptor is closed
+    ::close(fd);
+    if (view == MAP_FAILED) {
+        return readAll(path);
+    }
+    mData = static_cast<const char*>(view);
+    mSize = static_cast<std::size_t>(info.st_size);
+    mapped = true;
+    return true;
+#endif
+}
+
+void etm::MappedFile::close() {
+    if (mapped) {
+#ifdef _WIN32
+        UnmapViewOfFile(mData);
+        CloseHandle(static_cast<HANDLE>(mapHandle));
+        CloseHandle(static_cast<HANDLE>(handle));
+#else
+        munmap(const_cast<char*>(mData), mSize);
+#endif
+    }
+    buffer.clear();
+    buffer.shrink_to_fit();
+    mData = nullptr;
+    mSize = 0;
+    mapped = false;
+    handle = nullptr;
+    mapHandle = nullptr;
+}
+
+const char *etm::MappedFile::data() const {
+    return mData;
+}
+std::size_t etm::MappedFile::size() const {
+    return mSize;
+}
+const std::string &etm::MappedFile::getError() const {
+    return error;
+}
@@ -0,0 +1,81 @@
+#ifndef ETERMAL_MAPPEDFILE_H_INCLUDED
+#define ETERMAL_MAPPEDFILE_H_INCLUDED
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+namespace etm {
+
+    /**
+    * A read-only view of an entire file.
+    * Where possible the file is memory mapped, so that only
+    * the pages that are actually read are loaded; otherwise
+    * it's read into a buffer in one go.
+    * Either way, the contents remain valid until the object is
+    * closed or destroyed.
+    * @note Doesn't throw - check the return value of
+    * @ref open(const std::string &path) and @ref getError()
+    */
+    class MappedFile {
+        /// Start of the contents
+        const char *mData;
+        /// Size of the contents
+        std::size_t mSize;
+        /// Fallback storage if mapping isn't possible
+        std::vector<char> buffer;
+        /// Is @ref mData a mapping that has to be released?
+        bool mapped;
+        /// Platform handle of the file (Windows only)
+        void *handle;
+        /// Platform handle of the mapping (Windows only)
+        void *mapHandle;
+        /// Why the last @ref open(const std::string &path) failed
+        std::string error;
+
+        /**
+        * Reads the entire file into @ref buffer.
+        * @param [in] path The file path
+        * @return `true` on success
+        */
+        bool readAll(const std::string &path);
+    public:
+        /**
+        * Constructs an empty, closed file.
+        */
+        MappedFile();
+        ~MappedFile();
+        MappedFile(const MappedFile&) = delete;
+        MappedFile &operator=(const MappedFile&) = delete;
+
+        /**
+        * Opens and maps a file, closing any that was
+        * previously open.
+        * @param [in] path The file path
+        * @return `true` on success, otherwise see @ref getError()
+        */
+        bool open(const std::string &path);
+        /**
+        * Releases the file.
+        */
+        void close();
+
+        /**
+        * Gets the contents of the file.
+        * @return Pointer to the first byte, or `nullptr` if closed or empty
+        */
+        const char *data() const;
+        /**
+        * Gets the size of the file.
+        * @return The size in bytes
+        */
+        std::size_t size() const;
+        /**
+        * Gets the reason for the last failure.
+        * @return The error message
+        */
+        const std::string &getError() const;
+    };
+}
+
+#endif
@@ -0,0 +1,142 @@
+#include "Profiler.h"
+
+#include "../render/GlyphCache.h"
+
+/// Names of each phase, as they appear in traces
+static const char *const PHASE_NAMES[etm::Profiler::PHASES] = {
+    "flush", "lookbehind", "layout", "upload", "draw"
+};
+
+etm::Profiler::Scope::Scope(Profiler &profiler, phase type):
+    profiler(profiler), type(type), start(profiler.now()) {
+}
+etm::Profiler::Scope::~Scope() {
+    profiler.addSpan(type, start, profiler.now() - start);
+}
+
+etm::Profiler::Profiler():
+    epoch(clock_t::now()),
+    inFrame(false),
+    startHits(0),
+    startMisses(0),
+    history(HISTORY),
+    next(0),
+    count(0)
+{
+    resetCurrent(0);
+}
+
+void etm::Profiler::resetCurrent(unsigned long long number) {
+    current.number = number;
+    current.start = 0;
+    current.duration = 0;
+    for (double &p : current.phases) {
+        p = 0;
+    }
+    current.gpu = -1;
+    current.drawCalls = 0;
+    current.cells = 0;
+    current.glyphHits = 0;
+    current.glyphMisses = 0;
+    current.bytesIn = 0;
+    current.spanCount = 0;
+}
+
+double etm::Profiler::now() const {
+    return std::chrono::duration<double, std::micro>(clock_t::now() - epoch).count();
+}
+
+void etm::Profiler::beginFrame() {
+    // Anything recorded since the last frame (ex. flushes) is kept
+    current.start = now();
+    const GlyphCache::stats glyphs = GlyphCache::get().getStats();
+    startHits = glyphs.hits;
+    startMisses = glyphs.misses;
+    inFrame = true;
+}
+
+void etm::Profiler::endFrame() {
+    if (!inFrame) {
+        return;
+    }
+    inFrame = false;
+    current.duration = now() - current.start;
+    const GlyphCache::stats glyphs = GlyphCache::get().getStats();
+    current.glyphHits = glyphs.hits - startHits;
+    current.glyphMisses = glyphs.misses - startMisses;
+
+    history[next] = current;
+    next = (next + 1) % HISTORY;
+    if (count < HISTORY) {
+        count++;
+    }
+    resetCurrent(current.number + 1);
+}
+
+unsigned long long etm::Profiler::getFrameNumber() const {
+    return current.number;
+}
+
+void etm::Profiler::addSpan(phase type, double start, double duration) {
+    current.phases[type] += duration;
+    if (current.spanCount < MAX_SPANS) {
+        current.spans[current.spanCount++] = span{type, start, duration};
+    }
+}
+
+void etm::Profiler::countDraw(std::size_t cells) {
+    current.drawCalls++;
+    current.cells += cells;
+}
+
+void etm::Profiler::countBytes(std::size_t bytes) {
+    current.bytesIn += bytes;
+}
+
+void etm::Profiler::setGpuTime(unsigned long long number, double microseconds) {
+    // Frames are in order, so it's easy to find
+    if (count && number < current.number && current.number - number <= count) {
+        history[(next + HISTORY - (current.number - number)) % HISTORY].gpu = microseconds;
+    }
+}
+
+std::vector<etm::Profiler::frame> etm::Profiler::getFrames() const {
+    std::vector<frame> result;
+    result.reserve(count);
+    for (std::size_t i = 0; i < count; i++) {
+        result.push_back(history[(next + HISTORY - count + i) % HISTORY]);
+    }
+    return result;
+}
+
+void etm::Profiler::clear() {
+    count = 0;
+}
+
+void etm::Profiler::writeTrace(std::ostream &stream) const {
+    // Complete ("X") events on thread 1 for the CPU,
+    // and thread 2 for the GPU
+    stream << "{\"traceEvents\":[";
+    bool first = true;
+    auto event = [&stream, &first](const char *name, int thread, double start, double duration) {
+        stream << (first ? "" : ",") << "\n{\"name\":\"" << name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << thread
+            << ",\"ts\":" << start << ",\"dur\":" << duration << '}';
+        first = false;
+    };
+    for (const frame &f : getFrames()) {
+        event("frame", 1, f.start, f.duration);
+        for (unsigned int i = 0; i < f.spanCount; i++) {
+            event(PHASE_NAMES[f.spans[i].type], 1, f.spans[i].start, f.spans[i].duration);
+        }
+        if (f.gpu >= 0) {
+            // The GPU doesn't start when the CPU does,
+            // but it's close enough to line them up
+            event("gpu", 2, f.start, f.gpu);
+        }
+        stream << ",\n{\"name\":\"counters\",\"ph\":\"C\",\"pid\":1,\"ts\":" << f.start
+            << ",\"args\":{\"drawCalls\":" << f.drawCalls << ",\"cells\":" << f.cells
+            << ",\"glyphHits\":" << f.glyphHits << ",\"glyphMisses\":" << f.glyphMisses
+            << ",\"bytesIn\":" << f.bytesIn << "}}";
+    }
+    stream << "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
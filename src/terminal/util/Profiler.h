@@ -0,0 +1,230 @@
+#ifndef ETERMAL_PROFILER_H_INCLUDED
+#define ETERMAL_PROFILER_H_INCLUDED
+
+#include <vector>
+#include <chrono>
+#include <ostream>
+#include <cstddef>
+
+/**
+* @file
+* Render profiling.
+* The instrumentation is compiled in only if `ETERMAL_PROFILE`
+* is defined (see the `PROFILE` CMake option), so that it costs
+* nothing otherwise. The @ref etm::Profiler itself is always there,
+* it just never records any frames.
+*/
+
+#ifdef ETERMAL_PROFILE
+/// Helpers for @ref ETM_PROFILE_SCOPE
+#define ETM_PROFILE_CONCAT_(a, b) a##b
+#define ETM_PROFILE_CONCAT(a, b) ETM_PROFILE_CONCAT_(a, b)
+/// Times the rest of the enclosing scope as a phase
+/// of the current frame (see @ref etm::Profiler::Scope)
+#define ETM_PROFILE_SCOPE(profiler, phase) ::etm::Profiler::Scope ETM_PROFILE_CONCAT(etmProfileScope, __LINE__)((profiler), (phase))
+/// Only compiles the statement if profiling is compiled in
+#define ETM_PROFILE(...) __VA_ARGS__
+#else
+#define ETM_PROFILE_SCOPE(profiler, phase)
+#define ETM_PROFILE(...)
+#endif
+
+namespace etm {
+
+    /**
+    * Records how long each part of rendering takes, and
+    * some counters, for the last @ref HISTORY frames.
+    * Everything is in microseconds, since the profiler
+    * was constructed.
+    * @see Terminal::getStats()
+    */
+    class Profiler {
+    public:
+        /// The parts of a frame
+        enum phase {
+            /// Appending flushed text (@ref Terminal::flush())
+            FLUSH,
+            /// Looking back for the colors of the first line rendered
+            LOOKBEHIND,
+            /// Working out what goes in each cell
+            LAYOUT,
+            /// Uploading glyphs and cell instances
+            UPLOAD,
+            /// Issuing draw calls
+            DRAW,
+            /// Number of phases
+            PHASES
+        };
+        /// Max number of spans kept per frame
+        static constexpr std::size_t MAX_SPANS = 32;
+        /// Number of frames kept
+        static constexpr std::size_t HISTORY = 128;
+
+        /**
+        * A single timed stretch of a phase.
+        */
+        struct span {
+            /// The phase
+            phase type;
+            /// When it started
+            double start;
+            /// How long it took
+            double duration;
+        };
+
+        /**
+        * Everything recorded for a frame.
+        */
+        struct frame {
+            /// Frame number, counting from 0
+            unsigned long long number;
+            /// When @ref Terminal::render() started
+            double start;
+            /// CPU time of the whole of @ref Terminal::render()
+            double duration;
+            /// CPU time spent in each phase, indexed by @ref phase.
+            /// Flushes count towards the frame that follows them.
+            double phases[PHASES];
+            /// GPU time, or -1 if it's not known (yet)
+            double gpu;
+            /// Number of draw calls for cells
+            unsigned int drawCalls;
+            /// Number of cells drawn
+            std::size_t cells;
+            /// @ref GlyphCache hits (for every font in the process)
+            unsigned long long glyphHits;
+            /// @ref GlyphCache misses (for every font in the process)
+            unsigned long long glyphMisses;
+            /// Bytes of text flushed
+            std::size_t bytesIn;
+            /// The timed spans, for tracing.
+            /// If there were more than @ref MAX_SPANS, the rest
+            /// only count towards @ref phases.
+            span spans[MAX_SPANS];
+            /// Number of @ref spans
+            unsigned int spanCount;
+        };
+
+        /**
+        * Times a phase from construction to destruction.
+        * @see ETM_PROFILE_SCOPE
+        */
+        class Scope {
+            /// The profiler to record to
+            Profiler &profiler;
+            /// The phase
+            phase type;
+            /// When it started
+            double start;
+        public:
+            /**
+            * Start timing a phase.
+            * @param [in] profiler The profiler to record to
+            * @param [in] type The phase
+            */
+            Scope(Profiler &profiler, phase type);
+            /**
+            * Record the time.
+            */
+            ~Scope();
+        };
+
+    private:
+        /// Clock type
+        typedef std::chrono::steady_clock clock_t;
+
+        /// When the profiler was constructed
+        clock_t::time_point epoch;
+        /// The frame being recorded
+        frame current;
+        /// Whether @ref current is between @ref beginFrame()
+        /// and @ref endFrame()
+        bool inFrame;
+        /// Glyph cache hits at the start of @ref current
+        unsigned long long startHits;
+        /// Glyph cache misses at the start of @ref current
+        unsigned long long startMisses;
+        /// The last @ref HISTORY frames, as a ring
+        std::vector<frame> history;
+        /// Where the next frame goes in @ref history
+        std::size_t next;
+        /// Number of frames in @ref history
+        std::size_t count;
+
+        /**
+        * Resets @ref current for the next frame.
+        * @param [in] number The frame number
+        */
+        void resetCurrent(unsigned long long number);
+    public:
+        /**
+        * Construct a profiler with no frames.
+        */
+        Profiler();
+
+        /**
+        * Gets the time since the profiler was constructed.
+        * @return The time, in microseconds
+        */
+        double now() const;
+
+        /**
+        * Start recording a frame.
+        */
+        void beginFrame();
+        /**
+        * Finish recording the frame, and add it to the history.
+        */
+        void endFrame();
+        /**
+        * Gets the number of the frame being recorded.
+        * @return The frame number
+        */
+        unsigned long long getFrameNumber() const;
+
+        /**
+        * Records a stretch of time spent in a phase.
+        * @param [in] type The phase
+        * @param [in] start When it started
+        * @param [in] duration How long it took
+        */
+        void addSpan(phase type, double start, double duration);
+        /**
+        * Counts a draw call.
+        * @param [in] cells Number of cells drawn by it
+        */
+        void countDraw(std::size_t cells);
+        /**
+        * Counts text coming in.
+        * @param [in] bytes Number of bytes
+        */
+        void countBytes(std::size_t bytes);
+        /**
+        * Fills in the GPU time of a frame, once it's known.
+        * Ignored if the frame is no longer in the history.
+        * @param [in] number The frame number
+        * @param [in] microseconds The GPU time
+        */
+        void setGpuTime(unsigned long long number, double microseconds);
+
+        /**
+        * Gets the recorded frames.
+        * @return The frames, oldest first
+        */
+        std::vector<frame> getFrames() const;
+        /**
+        * Forgets every recorded frame.
+        */
+        void clear();
+        /**
+        * Writes the recorded frames as Chrome trace events (JSON),
+        * which can be opened in `chrome://tracing` or Perfetto.
+        * Each frame is an event, with its phases under it.
+        * GPU times are on a track of their own.
+        * @param [out] stream The stream to write to
+        */
+        void writeTrace(std::ostream &stream) const;
+    };
+}
+
+#endif
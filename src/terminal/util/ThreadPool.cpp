@@ -0,0 +1,57 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <utility>
+
+etm::ThreadPool::ThreadPool(std::size_t count): stop(false) {
+    count = std::max<std::size_t>(count, 1);
+    workers.reserve(count);
+    for (std::size_t i = 0; i < count; i++) {
+        workers.emplace_back(&ThreadPool::work, this, i);
+    }
+}
+
+etm::ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stop = true;
+        jobs.clear();
+    }
+    signal.notify_all();
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+}
+
+void etm::ThreadPool::work(std::size_t index) {
+    for (;;) {
+        job_t job;
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            signal.wait(guard, [this]() { return stop || !jobs.empty(); });
+            if (stop) {
+                return;
+            }
+            job = std::move(jobs.front());
+            jobs.pop_front();
+        }
+        job(index);
+    }
+}
+
+void etm::ThreadPool::submit(const job_t &job) {
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        jobs.push_back(job);
+    }
+    signal.notify_one();
+}
+
+void etm::ThreadPool::cancel() {
+    std::lock_guard<std::mutex> guard(lock);
+    jobs.clear();
+}
+
+std::size_t etm::ThreadPool::size() const {
+    return workers.size();
+}
@@ -0,0 +1,73 @@
+#ifndef ETERMAL_THREADPOOL_H_INCLUDED
+#define ETERMAL_THREADPOOL_H_INCLUDED
+
+#include <functional>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstddef>
+
+#include "singleton.h"
+
+namespace etm {
+
+    /**
+    * A fixed number of worker threads that run jobs
+    * in the order they were submitted.
+    * Each job is told the index of the worker running it,
+    * so that it can use per-worker resources (ex. something
+    * that's not thread safe) without locking.
+    */
+    class ThreadPool: public singleton {
+    public:
+        /// A job, given the index of the worker that's running it
+        typedef std::function<void(std::size_t worker)> job_t;
+    private:
+        /// The workers
+        std::vector<std::thread> workers;
+        /// Jobs that haven't been started yet
+        std::deque<job_t> jobs;
+        /// Guards @ref jobs and @ref stop
+        std::mutex lock;
+        /// Wakes up the workers
+        std::condition_variable signal;
+        /// Set when the pool is being destroyed
+        bool stop;
+
+        /**
+        * The body of each worker.
+        * @param [in] index The worker's index
+        */
+        void work(std::size_t index);
+    public:
+        /**
+        * Starts the workers.
+        * @param [in] count Number of workers, at least 1
+        */
+        ThreadPool(std::size_t count);
+        /**
+        * Drops all jobs that haven't been started, and
+        * waits for the ones that have.
+        */
+        ~ThreadPool();
+
+        /**
+        * Queues a job.
+        * @param [in] job The job
+        */
+        void submit(const job_t &job);
+        /**
+        * Drops all jobs that haven't been started yet.
+        */
+        void cancel();
+        /**
+        * Gets the number of workers.
+        * @return The number of workers
+        */
+        std::size_t size() const;
+    };
+}
+
+#endif
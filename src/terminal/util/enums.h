@@ -13,7 +13,11 @@ namespace etm {
         UP,
         DOWN,
         LEFT,
-        RIGHT
+        RIGHT,
+        /// Stop what's running (ex. Ctrl+C)
+        INTERRUPT,
+        /// Complete the input
+        TAB
     };
 }
 
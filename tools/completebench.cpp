@@ -0,0 +1,88 @@
+/**
+* Measures how long it takes etm::Shell to register commands,
+* and to complete prefixes of them, with a lot of them registered.
+* Usage:
+*  completebench [commands registered] [completions]
+* Registers 10000 commands and does 100000 completions by default.
+*/
+
+#include <etermal/etermal.h>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <stdexcept>
+
+/**
+* Gets the time since a point, in milliseconds.
+* @param [in] start The point
+* @return The time
+*/
+static double since(const std::chrono::steady_clock::time_point &start);
+
+int main(int argc, char **argv) {
+    unsigned long registered = 10000;
+    unsigned long count = 100000;
+    try {
+        if (argc > 1) {
+            registered = std::stoul(argv[1]);
+        }
+        if (argc > 2) {
+            count = std::stoul(argv[2]);
+        }
+    } catch (std::exception &e) {
+        std::cerr << "Usage: " << argv[0] << " [commands registered] [completions]\n";
+        return 1;
+    }
+
+    etm::HeadlessTerminal terminal;
+    etm::Shell shell;
+    terminal.setShell(shell);
+    shell.setTerminal(terminal);
+
+    // Names that share prefixes, like real commands do
+    std::vector<std::string> names;
+    names.reserve(registered);
+    for (unsigned long i = 0; i < registered; i++) {
+        names.push_back("command" + std::to_string(i));
+    }
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (const std::string &name : names) {
+        shell.addCommand(name, etm::ArgFilter(), [](etm::Shell&, etm::ETerminal&, etm::Args&) -> void {});
+    }
+    const double added = since(start);
+
+    start = std::chrono::steady_clock::now();
+    for (const std::string &name : names) {
+        // Alias whichever command was added last
+        shell.alias("x" + name);
+    }
+    const double aliased = since(start);
+
+    // Prefixes from long (few results) to short (many)
+    const std::vector<std::string> prefixes = {
+        "command1234", "command123", "command12", "command1", "xcommand99", "nothing"
+    };
+    std::vector<std::string> completions;
+    std::cout << registered << " commands registered, with as many aliases\n"
+        << "addCommand(): " << added << "ms (" << added * 1000 / registered << "us each)\n"
+        << "alias():      " << aliased << "ms (" << aliased * 1000 / registered << "us each)\n";
+    for (const std::string &prefix : prefixes) {
+        std::size_t found = 0;
+        start = std::chrono::steady_clock::now();
+        for (unsigned long i = 0; i < count; i++) {
+            shell.getCompletions(prefix, completions);
+            found = completions.size();
+        }
+        const double took = since(start);
+        std::cout << "complete \"" << prefix << "\": " << found << " results, "
+            << took * 1000 / count << "us each\n";
+    }
+    return 0;
+}
+
+double since(const std::chrono::steady_clock::time_point &start) {
+    const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
@@ -0,0 +1,57 @@
+/**
+* Makes glyph packs for etm::PackFont, ahead of time.
+* Usage:
+*  etmpack font <font file> <pixel size> <first codepoint> <last codepoint> <output>
+*  etmpack bmp <bitmap> <start codepoint> <glyph width> <glyph height> <count> <output>
+* Numbers can be given in hex (ex. 0x20).
+*/
+
+#include <etermal/etermal.h>
+#include <iostream>
+#include <string>
+#include <stdexcept>
+
+static void usage(const char *name);
+static unsigned int toNumber(const std::string &str);
+
+int main(int argc, char **argv) {
+    const std::string mode = argc > 1 ? argv[1] : "";
+
+    etm::GlyphPack pack;
+    std::string output;
+    try {
+        if (mode == "font" && argc == 7) {
+            etm::Font::exportPack(argv[2], toNumber(argv[3]), toNumber(argv[4]), toNumber(argv[5]), pack);
+            output = argv[6];
+        } else if (mode == "bmp" && argc == 8) {
+            etm::BmpFont::exportPack(argv[2], toNumber(argv[3]), toNumber(argv[4]), toNumber(argv[5]), toNumber(argv[6]), pack);
+            output = argv[7];
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    } catch (std::exception &e) {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+
+    std::string error;
+    if (!pack.save(output, error)) {
+        std::cerr << error << '\n';
+        return 1;
+    }
+    std::cout << "Packed " << pack.size() << " glyphs (" << pack.getCellWidth() << 'x' << pack.getCellHeight()
+        << ") into \"" << output << "\"\n";
+    return 0;
+}
+
+void usage(const char *name) {
+    std::cerr << "Usage:\n"
+        << "  " << name << " font <font file> <pixel size> <first codepoint> <last codepoint> <output>\n"
+        << "  " << name << " bmp <bitmap> <start codepoint> <glyph width> <glyph height> <count> <output>\n";
+}
+
+unsigned int toNumber(const std::string &str) {
+    // Base 0 to allow hex
+    return std::stoul(str, nullptr, 0);
+}
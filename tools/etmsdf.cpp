@@ -0,0 +1,49 @@
+/**
+* Checks how closely etm::Font's distance field glyphs match
+* glyphs rendered natively, at a few sizes.
+* Usage:
+*  etmsdf <font file> [pixel sizes...]
+* Compares printable ASCII at 12, 16, 24 and 32 pixels by default.
+*/
+
+#include <etermal/etermal.h>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        std::cerr << "Usage:\n  " << argv[0] << " <font file> [pixel sizes...]\n";
+        return 1;
+    }
+    std::vector<unsigned int> sizes;
+    try {
+        for (int i = 2; i < argc; i++) {
+            sizes.push_back(std::stoul(argv[i]));
+        }
+    } catch (std::exception &e) {
+        std::cerr << "Invalid size\n";
+        return 1;
+    }
+    if (sizes.empty()) {
+        sizes = {12, 16, 24, 32};
+    }
+
+    std::cout << "size  glyphs  mean error  worst error (codepoint)\n" << std::fixed << std::setprecision(2);
+    for (unsigned int size : sizes) {
+        etm::Font::fidelity result;
+        try {
+            result = etm::Font::compareDistanceField(argv[1], size, 0x21, 0x7E);
+        } catch (std::exception &e) {
+            std::cerr << e.what() << '\n';
+            return 1;
+        }
+        std::cout << std::setw(4) << size << "  " << std::setw(6) << result.glyphs << "  "
+            << std::setw(9) << result.meanError * 100 << "%  "
+            << std::setw(10) << result.worstError * 100 << "% (U+" << std::hex << std::uppercase
+            << result.worstCodepoint << std::dec << ")\n";
+    }
+    return 0;
+}
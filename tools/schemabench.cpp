@@ -0,0 +1,87 @@
+/**
+* Compares parsing the same arguments with etm::ArgFilter::filter()
+* and etm::Schema::parse().
+* Usage:
+*  schemabench [iterations]
+* Does 2000000 iterations by default.
+*/
+
+#include <etermal/etermal.h>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <chrono>
+#include <stdexcept>
+
+/// What the schema parses into
+struct countArgs {
+    int count = 10;
+    bool verbose = false;
+    float scale = 1;
+    std::string_view name;
+    long big = 0;
+    std::vector<std::string_view> files;
+};
+
+/// The schema, the filter is made from it
+static constexpr auto countSchema = etm::makeSchema(
+    etm::option("-n", "--count", &countArgs::count),
+    etm::option("-v", &countArgs::verbose),
+    etm::option("-s", &countArgs::scale),
+    etm::option("--name", &countArgs::name),
+    etm::option("--big", &countArgs::big),
+    etm::rest("file", 4, &countArgs::files)
+);
+
+/**
+* Times both ways of parsing a command.
+* @param [in] label What to call it
+* @param [in] tokens The command, split up
+* @param [in] iterations How many times to parse it
+*/
+static void compare(const char *label, const std::vector<std::string_view> &tokens, unsigned long iterations);
+
+int main(int argc, char **argv) {
+    unsigned long iterations = 2000000;
+    try {
+        if (argc > 1) {
+            iterations = std::stoul(argv[1]);
+        }
+    } catch (std::exception &e) {
+        std::cerr << "Usage: " << argv[0] << " [iterations]\n";
+        return 1;
+    }
+
+    compare("flags and args", {"count", "-n", "5", "-v", "--name", "bob", "-s", "2.5", "--big", "99", "a", "b"}, iterations);
+    compare("flags only", {"count", "-n", "5", "-v", "--name", "bob", "-s", "2.5", "--big", "99"}, iterations);
+    compare("no args", {"count"}, iterations);
+    return 0;
+}
+
+void compare(const char *label, const std::vector<std::string_view> &tokens, unsigned long iterations) {
+    etm::ArgFilter filter = countSchema.toFilter("count");
+    etm::ArgFilter::ErrorHandle &handle = etm::ArgFilter::getDefaultErrorHandle();
+    etm::Args args;
+    std::string error;
+    // Use the results, so that nothing's optimized out
+    volatile long sink = 0;
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (unsigned long i = 0; i < iterations; i++) {
+        filter.filter(tokens, args, error);
+        sink = sink + args.getArrayArgs().size();
+    }
+    const std::chrono::duration<double, std::nano> filtered = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    for (unsigned long i = 0; i < iterations; i++) {
+        countArgs values;
+        countSchema.parse(tokens, values, error, handle);
+        sink = sink + values.files.size();
+    }
+    const std::chrono::duration<double, std::nano> parsed = std::chrono::steady_clock::now() - start;
+
+    std::cout << label << ": ArgFilter::filter() " << filtered.count() / iterations
+        << "ns, Schema::parse() " << parsed.count() / iterations << "ns\n";
+}
@@ -0,0 +1,86 @@
+/**
+* Measures how many commands per second etm::Shell dispatches,
+* before and after etm::Shell::freeze().
+* Usage:
+*  shellbench [commands registered] [commands run]
+* Registers 200 commands and runs 1000000 by default.
+*/
+
+#include <etermal/etermal.h>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <stdexcept>
+
+/**
+* Runs a stream of commands through a shell.
+* @param [in,out] shell The shell
+* @param [in] script The commands
+* @param [in] count How many to run, cycling through `script`
+* @return Commands per second
+*/
+static double run(etm::Shell &shell, const std::vector<std::string> &script, unsigned long count);
+
+int main(int argc, char **argv) {
+    unsigned long registered = 200;
+    unsigned long count = 1000000;
+    try {
+        if (argc > 1) {
+            registered = std::stoul(argv[1]);
+        }
+        if (argc > 2) {
+            count = std::stoul(argv[2]);
+        }
+    } catch (std::exception &e) {
+        std::cerr << "Usage: " << argv[0] << " [commands registered] [commands run]\n";
+        return 1;
+    }
+    if (registered == 0) {
+        registered = 1;
+    }
+
+    etm::HeadlessTerminal terminal;
+    // Only the timing matters, so don't let the output pile up
+    terminal.setMaxOutput(4096);
+    etm::Shell shell;
+    terminal.setShell(shell);
+    shell.setTerminal(terminal);
+
+    etm::ArgFilter filter;
+    filter.addFilter("verbose", etm::ArgFilter::BOOL, false);
+    filter.addAlias("v");
+    filter.addFilter("count", etm::ArgFilter::INT, false);
+    filter.addAlias("n");
+    filter.setMaxArrayArgs(4);
+    unsigned long ran = 0;
+    for (unsigned long i = 0; i < registered; i++) {
+        shell.addCommand("command" + std::to_string(i), filter, [&ran](etm::Shell&, etm::ETerminal&, etm::Args&) -> void {
+            ran++;
+        });
+    }
+
+    // A spread of commands, so it isn't always the same lookup
+    std::vector<std::string> script;
+    for (unsigned long i = 0; i < registered; i += 1 + registered / 64) {
+        script.push_back("command" + std::to_string(i) + " -v -n 5 file.txt");
+    }
+
+    const double thawed = run(shell, script, count);
+    shell.freeze();
+    const double frozen = run(shell, script, count);
+
+    std::cout << registered << " commands registered, " << count << " run each time\n"
+        << "before freeze(): " << static_cast<unsigned long>(thawed) << " commands/s\n"
+        << "after freeze():  " << static_cast<unsigned long>(frozen) << " commands/s\n";
+    return ran == count * 2 ? 0 : 1;
+}
+
+double run(etm::Shell &shell, const std::vector<std::string> &script, unsigned long count) {
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (unsigned long i = 0; i < count; i++) {
+        shell.input(script[i % script.size()]);
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return count / elapsed.count();
+}